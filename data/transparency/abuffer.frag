@@ -0,0 +1,51 @@
+#version 430 core
+
+layout(early_fragment_tests) in;
+
+in vec3 v_normal;
+
+struct Fragment
+{
+    uint color;
+    float depth;
+    uint next;
+};
+
+layout(std430, binding = 1) writeonly buffer FragmentPool
+{
+    Fragment fragments[];
+};
+
+layout(std430, binding = 2) coherent buffer HeadPointers
+{
+    uint heads[];
+};
+
+layout(std430, binding = 3) coherent buffer FragmentCounter
+{
+    uint numFragments;
+};
+
+uniform uint transparency;
+uniform uint poolSize;
+uniform int width;
+
+
+void main()
+{
+    // The counter is incremented even if the pool is full, so that the demand can be read back
+    uint index = atomicAdd(numFragments, 1u);
+
+    if (index >= poolSize)
+        return;
+
+    float alpha = float(transparency) / 255.0;
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+    uint pixel = uint(coordinate.y * width + coordinate.x);
+
+    fragments[index].color = packUnorm4x8(vec4(color, alpha));
+    fragments[index].depth = gl_FragCoord.z;
+    fragments[index].next = atomicExchange(heads[pixel], index);
+}
@@ -0,0 +1,69 @@
+#version 430 core
+
+#define MAX_FRAGMENTS 32
+#define END_OF_LIST 0xffffffffu
+
+in vec2 v_uv;
+
+layout (location = 0) out vec3 fragColor;
+
+struct Fragment
+{
+    uint color;
+    float depth;
+    uint next;
+};
+
+layout(std430, binding = 1) readonly buffer FragmentPool
+{
+    Fragment fragments[];
+};
+
+layout(std430, binding = 2) readonly buffer HeadPointers
+{
+    uint heads[];
+};
+
+uniform sampler2D opaqueColorTexture;
+uniform int width;
+
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+
+    uint colors[MAX_FRAGMENTS];
+    float depths[MAX_FRAGMENTS];
+    int count = 0;
+
+    // Insertion sort, nearest first, drops the farthest fragments of overfull lists
+    for (uint index = heads[coordinate.y * width + coordinate.x]; index != END_OF_LIST; index = fragments[index].next)
+    {
+        float depth = fragments[index].depth;
+
+        if (count == MAX_FRAGMENTS && depth >= depths[MAX_FRAGMENTS - 1])
+            continue;
+
+        int i = min(count, MAX_FRAGMENTS - 1);
+
+        for (; i > 0 && depths[i - 1] > depth; --i)
+        {
+            colors[i] = colors[i - 1];
+            depths[i] = depths[i - 1];
+        }
+
+        colors[i] = fragments[index].color;
+        depths[i] = depth;
+        count = min(count + 1, MAX_FRAGMENTS);
+    }
+
+    vec3 color = texelFetch(opaqueColorTexture, coordinate, 0).rgb;
+
+    for (int i = count - 1; i >= 0; --i)
+    {
+        vec4 fragment = unpackUnorm4x8(colors[i]);
+        color = mix(color, fragment.rgb, fragment.a);
+    }
+
+    fragColor = color;
+}
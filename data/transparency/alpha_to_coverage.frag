@@ -8,19 +8,25 @@ flat in float v_rand;
 layout(location = 0) out vec4 fragColor;
 
 uniform uint transparency;
-uniform sampler2D masksTexture;
+uniform usampler2DArray masksTexture;
+uniform int masksLayer;
+uniform bool tiledMasks;
 uniform vec2 viewport;
+uniform int frame;
 
+const int tileSize = 32;
+
+// Additive recurrence with the plastic constant, decorrelates the masks of consecutive frames
+const vec2 frameStep = vec2(0.7548776662, 0.5698402910);
 
-float rand();
-float calculateAlpha(uint mask);
 
-const float denormFactor = pow(2.0, 8.0) - 1.0;
+float rand();
+int maskIndex();
 
 void main()
 {
-    ivec2 index = ivec2(rand() * 1023.0, transparency);
-    uint mask = uint(texelFetch(masksTexture, index, 0).r * denormFactor);
+    ivec3 index = ivec3(maskIndex(), transparency, masksLayer);
+    uint mask = texelFetch(masksTexture, index, 0).r;
 
     uint sampleBit = 1u << gl_SampleID;
     if ((mask & sampleBit) != sampleBit)
@@ -43,5 +49,18 @@ highp float rand(vec2 co)
 float rand()
 {
     vec2 normFragCoord = floor(gl_FragCoord.xy) / viewport * v_rand;
-    return rand(normFragCoord.xy);
+    return rand(normFragCoord.xy + fract(float(frame) * frameStep));
+}
+
+int maskIndex()
+{
+    if (!tiledMasks)
+        return int(rand() * 1023.0);
+
+    // Shift the tile per primitive, so that overlapping surfaces use decorrelated masks
+    vec2 shift = vec2(rand(vec2(v_rand, 0.5)), rand(vec2(0.5, v_rand))) + float(frame) * frameStep;
+    ivec2 offset = ivec2(fract(shift) * float(tileSize));
+    ivec2 coordinate = (ivec2(gl_FragCoord.xy) + offset) % tileSize;
+
+    return coordinate.y * tileSize + coordinate.x;
 }
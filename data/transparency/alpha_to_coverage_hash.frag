@@ -0,0 +1,56 @@
+#version 150 core
+#extension GL_ARB_sample_shading : require
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+flat in float v_rand;
+
+layout(location = 0) out vec4 fragColor;
+
+uniform uint transparency;
+uniform int numSamples;
+uniform int frame;
+
+
+// Integer hash with good avalanche behavior, "lowbias32" by Chris Wellons
+uint hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float random(inout uint state)
+{
+    state = hash(state);
+    return float(state >> 8) / 16777216.0;
+}
+
+void main()
+{
+    uint state = hash(uint(gl_FragCoord.x) ^ hash(uint(gl_FragCoord.y) ^ hash(uint(v_rand) ^ hash(uint(frame)))));
+
+    // Stochastic rounding keeps the expected coverage at alpha
+    float alpha = float(transparency) / 255.0;
+    int remaining = int(alpha * float(numSamples) + random(state));
+
+    // Selection sampling, picks a uniformly distributed subset of exactly remaining samples
+    uint mask = 0u;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (random(state) * float(numSamples - i) < float(remaining))
+        {
+            mask |= 1u << i;
+            --remaining;
+        }
+    }
+
+    gl_SampleMask[0] = int(mask);
+
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+    fragColor = vec4(color, 1.0);
+}
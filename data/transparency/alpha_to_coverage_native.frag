@@ -0,0 +1,16 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+
+layout(location = 0) out vec4 fragColor;
+
+uniform uint transparency;
+
+
+void main()
+{
+    // GL_SAMPLE_ALPHA_TO_COVERAGE turns alpha into the sample mask, its pattern is up to the driver
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+    fragColor = vec4(color, float(transparency) / 255.0);
+}
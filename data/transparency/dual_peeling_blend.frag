@@ -0,0 +1,18 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec2 v_uv;
+
+layout (location = 0) out vec4 fragColor;
+
+uniform sampler2D backLayerTexture;
+
+
+void main()
+{
+    fragColor = texelFetch(backLayerTexture, ivec2(gl_FragCoord.xy), 0);
+
+    // Keeps the occlusion query at zero once no back layer is left
+    if (fragColor.a == 0.0)
+        discard;
+}
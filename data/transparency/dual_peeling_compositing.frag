@@ -0,0 +1,20 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec2 v_uv;
+
+layout (location = 0) out vec3 fragColor;
+
+uniform sampler2D frontColorTexture;
+uniform sampler2D backColorTexture;
+
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+
+    vec4 frontColor = texelFetch(frontColorTexture, coordinate, 0);
+    vec3 backColor = texelFetch(backColorTexture, coordinate, 0).rgb;
+
+    fragColor = frontColor.rgb + backColor * (1.0 - frontColor.a);
+}
@@ -0,0 +1,15 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+layout(location = 0) out vec2 depth;
+
+uniform sampler2D opaqueDepthTexture;
+
+
+void main()
+{
+    if (gl_FragCoord.z > texelFetch(opaqueDepthTexture, ivec2(gl_FragCoord.xy), 0).r)
+        discard;
+
+    depth = vec2(-gl_FragCoord.z, gl_FragCoord.z);
+}
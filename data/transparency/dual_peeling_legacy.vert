@@ -0,0 +1,17 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+layout(location = 0) in vec3 a_vertex;
+layout(location = 1) in vec3 a_normal;
+
+out vec3 v_normal;
+
+uniform mat4 transform;
+uniform mat4 dequantization;
+
+
+void main()
+{
+    gl_Position = transform * dequantization * vec4(a_vertex, 1.0);
+    v_normal = a_normal;
+}
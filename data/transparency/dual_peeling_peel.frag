@@ -0,0 +1,61 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+
+layout(location = 0) out vec2 depth;
+layout(location = 1) out vec4 frontColor;
+layout(location = 2) out vec4 backColor;
+
+uniform sampler2D depthTexture;
+uniform sampler2D frontColorTexture;
+uniform sampler2D opaqueDepthTexture;
+uniform uint transparency;
+
+
+// All outputs are max blended, outputs that must not change a target are set to its cleared value
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+    float fragmentDepth = gl_FragCoord.z;
+
+    if (fragmentDepth > texelFetch(opaqueDepthTexture, coordinate, 0).r)
+        discard;
+
+    vec2 previousDepth = texelFetch(depthTexture, coordinate, 0).xy;
+    vec4 previousFrontColor = texelFetch(frontColorTexture, coordinate, 0);
+
+    float nearestDepth = -previousDepth.x;
+    float farthestDepth = previousDepth.y;
+
+    depth = vec2(-1.0);
+    frontColor = previousFrontColor;
+    backColor = vec4(0.0);
+
+    // Peeled before
+    if (fragmentDepth < nearestDepth || fragmentDepth > farthestDepth)
+        return;
+
+    // Peeled later
+    if (fragmentDepth > nearestDepth && fragmentDepth < farthestDepth)
+    {
+        depth = vec2(-fragmentDepth, fragmentDepth);
+        return;
+    }
+
+    float alpha = float(transparency) / 255.0;
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+
+    // Front to back compositing under the front layers, accumulated alpha in w
+    if (fragmentDepth == nearestDepth)
+    {
+        float transmittance = 1.0 - previousFrontColor.a;
+
+        frontColor.rgb += color * alpha * transmittance;
+        frontColor.a = 1.0 - transmittance * (1.0 - alpha);
+    }
+    else
+    {
+        backColor = vec4(color, alpha);
+    }
+}
@@ -0,0 +1,29 @@
+#version 150 core
+#extension GL_ARB_sample_shading : require
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out float fragTransparency;
+
+uniform uint transparency;
+uniform sampler2DMS stochasticDepthTexture;
+
+// Tolerates the quantization of the stochastic depth, which the hardware depth test would compare exactly
+const float depthTolerance = 1e-6;
+
+
+void main()
+{
+    float alpha = float(transparency) / 255.0;
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+
+    // The depth test only rejects fragments behind the opaque geometry, as needed for the total alpha.
+    // Color is only accumulated from fragments that are not behind the stochastic depth of the sample.
+    float stochasticDepth = texelFetch(stochasticDepthTexture, ivec2(gl_FragCoord.xy), gl_SampleID).r;
+    float visible = gl_FragCoord.z <= stochasticDepth + depthTolerance ? 1.0 : 0.0;
+
+    fragColor = vec4(color * alpha, alpha) * visible;
+    fragTransparency = alpha;
+}
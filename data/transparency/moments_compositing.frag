@@ -0,0 +1,26 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec2 v_uv;
+
+layout (location = 0) out vec3 fragColor;
+
+uniform sampler2D opaqueColorTexture;
+uniform sampler2D zerothMomentTexture;
+uniform sampler2D accumulationTexture;
+
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+
+    vec3 opaqueColor = texelFetch(opaqueColorTexture, coordinate, 0).rgb;
+    float zerothMoment = texelFetch(zerothMomentTexture, coordinate, 0).r;
+    vec4 accumulation = texelFetch(accumulationTexture, coordinate, 0);
+
+    // Total transmittance is exact, only its distribution among the fragments is reconstructed
+    float transmittance = exp(-zerothMoment);
+    vec3 transparentColor = accumulation.rgb / clamp(accumulation.a, 1e-4, 5e4);
+
+    fragColor = opaqueColor * transmittance + transparentColor * (1.0 - transmittance);
+}
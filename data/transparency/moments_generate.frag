@@ -0,0 +1,35 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+layout(location = 0) out float zerothMoment;
+layout(location = 1) out vec4 moments;
+layout(location = 2) out vec4 higherMoments;
+
+uniform uint transparency;
+uniform int numMoments;
+uniform float zNear;
+uniform float zFar;
+
+
+// Logarithmic depth in [-1, 1], spreads the moments more evenly than window space depth
+float warpedDepth()
+{
+    float ndc = gl_FragCoord.z * 2.0 - 1.0;
+    float linear = 2.0 * zNear * zFar / (zFar + zNear - ndc * (zFar - zNear));
+
+    return log(linear / zNear) / log(zFar / zNear) * 2.0 - 1.0;
+}
+
+void main()
+{
+    float alpha = float(transparency) / 255.0;
+    float absorbance = -log(max(1.0 - alpha, 1e-5));
+
+    float z = warpedDepth();
+    float z2 = z * z;
+    float z4 = z2 * z2;
+
+    zerothMoment = absorbance;
+    moments = vec4(z, z2, z2 * z, z4) * absorbance;
+    higherMoments = numMoments == 8 ? vec4(z4 * z, z4 * z2, z4 * z2 * z, z4 * z4) * absorbance : vec4(0.0);
+}
@@ -0,0 +1,219 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+
+layout(location = 0) out vec4 accumulation;
+
+uniform sampler2D zerothMomentTexture;
+uniform sampler2D momentsTexture;
+uniform sampler2D higherMomentsTexture;
+
+uniform uint transparency;
+uniform int numMoments;
+uniform float momentBias;
+uniform float overestimation;
+uniform float zNear;
+uniform float zFar;
+
+const int kMaxMoments = 8;
+const int kMaxPoints = kMaxMoments / 2 + 1;
+
+// Moments of a canonical distribution the measured ones are biased towards, see Münstermann et al.
+const float kBiasFour[4] = float[4](0.0, 0.375, 0.0, 0.375);
+const float kBiasEight[8] = float[8](0.0, 0.75, 0.0, 0.67666666666666664, 0.0, 0.63, 0.0, 0.60030303030303034);
+
+
+float warpedDepth()
+{
+    float ndc = gl_FragCoord.z * 2.0 - 1.0;
+    float linear = 2.0 * zNear * zFar / (zFar + zNear - ndc * (zFar - zNear));
+
+    return log(linear / zNear) / log(zFar / zNear) * 2.0 - 1.0;
+}
+
+// Solves the Hankel system B c = r with B_ij = b_(i+j) using an LDL^T decomposition
+void solveHankel(in float b[kMaxMoments + 1], in float r[kMaxPoints], int n, out float c[kMaxPoints])
+{
+    float L[kMaxPoints * kMaxPoints];
+    float D[kMaxPoints];
+
+    for (int j = 0; j < n; ++j)
+    {
+        float d = b[2 * j];
+
+        for (int k = 0; k < j; ++k)
+            d -= L[j * kMaxPoints + k] * L[j * kMaxPoints + k] * D[k];
+
+        D[j] = max(d, 1e-12);
+
+        for (int i = j + 1; i < n; ++i)
+        {
+            float l = b[i + j];
+
+            for (int k = 0; k < j; ++k)
+                l -= L[i * kMaxPoints + k] * L[j * kMaxPoints + k] * D[k];
+
+            L[i * kMaxPoints + j] = l / D[j];
+        }
+    }
+
+    float y[kMaxPoints];
+
+    for (int i = 0; i < n; ++i)
+    {
+        y[i] = r[i];
+
+        for (int k = 0; k < i; ++k)
+            y[i] -= L[i * kMaxPoints + k] * y[k];
+    }
+
+    for (int i = n - 1; i >= 0; --i)
+    {
+        c[i] = y[i] / D[i];
+
+        for (int k = i + 1; k < n; ++k)
+            c[i] -= L[k * kMaxPoints + i] * c[k];
+    }
+}
+
+// Laguerre's method, converges from any start for polynomials with only real roots
+float findRoot(in float p[kMaxPoints], int degree)
+{
+    float x = 0.0;
+    float n = float(degree);
+
+    for (int iteration = 0; iteration < 32; ++iteration)
+    {
+        float value = p[degree], first = 0.0, second = 0.0;
+
+        for (int k = degree - 1; k >= 0; --k)
+        {
+            second = second * x + first;
+            first = first * x + value;
+            value = value * x + p[k];
+        }
+
+        if (abs(value) < 1e-10)
+            break;
+
+        float g = first / value;
+        float h = g * g - 2.0 * second / value;
+        float s = sqrt(max((n - 1.0) * (n * h - g * g), 0.0));
+        float denominator = abs(g + s) > abs(g - s) ? g + s : g - s;
+
+        if (denominator == 0.0)
+            break;
+
+        float step = n / denominator;
+        x -= step;
+
+        if (abs(step) < 1e-6)
+            break;
+    }
+
+    return x;
+}
+
+// Optical depth in front of the fragment divided by the zeroth moment
+float normalizedAbsorbance(in float b[kMaxMoments + 1], int numPoints, float depth)
+{
+    int degree = numPoints - 1;
+
+    float r[kMaxPoints];
+    float c[kMaxPoints];
+
+    for (int i = 0; i < numPoints; ++i)
+        r[i] = pow(depth, float(i));
+
+    solveHankel(b, r, numPoints, c);
+
+    // Support of the canonical representation, the fragment depth and the roots of the kernel polynomial
+    float z[kMaxPoints];
+    z[0] = depth;
+
+    for (int i = 1; i < numPoints; ++i)
+    {
+        int remaining = degree - i + 1;
+        z[i] = findRoot(c, remaining);
+
+        // Deflate by the found root
+        float carry = c[remaining];
+
+        for (int k = remaining - 1; k >= 0; --k)
+        {
+            float coefficient = c[k];
+            c[k] = carry;
+            carry = coefficient + carry * z[i];
+        }
+    }
+
+    // Newton divided differences of the weight factors, full weight in front of the fragment
+    float dd[kMaxPoints];
+
+    for (int i = 0; i < numPoints; ++i)
+        dd[i] = i == 0 ? overestimation : (z[i] < depth ? 1.0 : 0.0);
+
+    for (int j = 1; j < numPoints; ++j)
+    {
+        for (int i = degree; i >= j; --i)
+        {
+            float difference = z[i] - z[i - j];
+            dd[i] = (dd[i] - dd[i - 1]) / (abs(difference) < 1e-7 ? 1e-7 : difference);
+        }
+    }
+
+    // Monomial form of the interpolating polynomial, whose dot product with the moments is the sum of the weights
+    float polynomial[kMaxPoints];
+
+    for (int i = 0; i < numPoints; ++i)
+        polynomial[i] = 0.0;
+
+    polynomial[0] = dd[degree];
+
+    for (int i = degree - 1; i >= 0; --i)
+    {
+        for (int k = degree - i; k >= 1; --k)
+            polynomial[k] = polynomial[k - 1] - z[i] * polynomial[k];
+
+        polynomial[0] = dd[i] - z[i] * polynomial[0];
+    }
+
+    float result = 0.0;
+
+    for (int k = 0; k < numPoints; ++k)
+        result += polynomial[k] * b[k];
+
+    return clamp(result, 0.0, 1.0);
+}
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+
+    float zerothMoment = texelFetch(zerothMomentTexture, coordinate, 0).r;
+    vec4 moments = texelFetch(momentsTexture, coordinate, 0);
+    vec4 higherMoments = texelFetch(higherMomentsTexture, coordinate, 0);
+
+    // Normalized moments, fully transparent fragments still contribute a zero vector
+    float scale = 1.0 / max(zerothMoment, 1e-7);
+
+    float b[kMaxMoments + 1];
+    b[0] = 1.0;
+
+    for (int k = 0; k < 4; ++k)
+    {
+        b[k + 1] = moments[k] * scale;
+        b[k + 5] = higherMoments[k] * scale;
+    }
+
+    for (int k = 0; k < numMoments; ++k)
+        b[k + 1] = mix(b[k + 1], numMoments == 8 ? kBiasEight[k] : kBiasFour[k % 4], momentBias);
+
+    float alpha = float(transparency) / 255.0;
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+
+    float transmittance = exp(-zerothMoment * normalizedAbsorbance(b, numMoments / 2 + 1, warpedDepth()));
+
+    accumulation = vec4(color * alpha, alpha) * transmittance;
+}
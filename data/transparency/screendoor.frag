@@ -1,11 +1,10 @@
 #version 150 core
 
 in vec3 v_normal;
+flat in float v_transparency;
 
 out vec4 fragColor;
 
-uniform float transparency;
-
 void main()
 {
     float[] thresholdMatrix = float[16](
@@ -18,7 +17,7 @@ void main()
     int index = int(mod(floor(gl_FragCoord.y), 4) * 4 + mod(floor(gl_FragCoord.x), 4));
     float threshold = thresholdMatrix[index];
 
-    if (threshold > transparency)
+    if (threshold > v_transparency)
         discard;
 
 	fragColor = vec4(v_normal * 0.5 + 0.5, 1.0);
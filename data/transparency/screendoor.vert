@@ -1,15 +1,31 @@
-#version 150 core
-#extension GL_ARB_explicit_attrib_location : require
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
 
 layout(location = 0) in vec3 a_vertex;
 layout(location = 1) in vec3 a_normal;
 
 out vec3 v_normal;
+flat out float v_transparency;
+
+struct DrawData
+{
+    mat4 dequantization;
+    uint index;
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer
+{
+    DrawData draws[];
+};
 
 uniform mat4 transform;
+uniform float transparency;
 
 void main()
 {
-	gl_Position = transform * vec4(a_vertex, 1.0);
+	gl_Position = transform * draws[gl_BaseInstanceARB].dequantization * vec4(a_vertex, 1.0);
     v_normal = a_normal;
+
+    // Every other object is transparent
+    v_transparency = draws[gl_BaseInstanceARB].index % 2u == 0u ? transparency : 1.0;
 }
@@ -2,11 +2,10 @@
 #extension GL_ARB_sample_shading : enable
 
 in vec3 v_normal;
+flat in float v_transparency;
 
 out vec4 fragColor;
 
-uniform float transparency;
-
 void main()
 {
     float[] thresholdMatrix = float[16](
@@ -21,7 +20,7 @@ void main()
     int index = (fragCoord.y * 2 + sampleCoord.y) * 4 + (fragCoord.x * 2 + sampleCoord.x);
     float threshold = thresholdMatrix[index];
 
-    if (threshold > transparency)
+    if (threshold > v_transparency)
         discard;
 
 	fragColor = vec4(v_normal * 0.5 + 0.5, 1.0);
@@ -0,0 +1,47 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec2 v_uv;
+
+layout (location = 0) out vec4 fragColor;
+
+uniform sampler2D currentColorTexture;
+uniform sampler2D historyTexture;
+uniform sampler2DMS depthTexture;
+uniform mat4 reprojection;
+uniform float historyWeight;
+
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+    ivec2 size = textureSize(currentColorTexture, 0);
+
+    vec3 currentColor = texelFetch(currentColorTexture, coordinate, 0).rgb;
+
+    // Clamping to the neighborhood of the current frame rejects history of disoccluded or changed surfaces
+    vec3 minimum = currentColor;
+    vec3 maximum = currentColor;
+
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec3 neighbor = texelFetch(currentColorTexture, clamp(coordinate + ivec2(x, y), ivec2(0), size - 1), 0).rgb;
+            minimum = min(minimum, neighbor);
+            maximum = max(maximum, neighbor);
+        }
+    }
+
+    // Sample 0 holds the opaque depth only with fused passes. In the other modes, the coverage pass writes
+    // the depth of the nearest transparent surface that kept the sample, which is reprojected instead.
+    // Either lies on the view ray, mismatches of surfaces behind it are left to the clamping above.
+    float depth = texelFetch(depthTexture, coordinate, 0).r;
+    vec4 previous = reprojection * vec4(v_uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec2 previousUv = previous.xy / previous.w * 0.5 + 0.5;
+
+    bool inside = all(greaterThanEqual(previousUv, vec2(0.0))) && all(lessThanEqual(previousUv, vec2(1.0)));
+    vec3 historyColor = clamp(texture(historyTexture, previousUv).rgb, minimum, maximum);
+
+    fragColor = vec4(mix(currentColor, historyColor, inside ? historyWeight : 0.0), 1.0);
+}
@@ -1,12 +1,23 @@
-#version 150 core
-#extension GL_ARB_explicit_attrib_location : require
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
 
 layout(location = 0) in vec3 a_vertex;
 
+struct DrawData
+{
+    mat4 dequantization;
+    uint index;
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer
+{
+    DrawData draws[];
+};
+
 uniform mat4 transform;
 
 
 void main()
 {
-    gl_Position = transform * vec4(a_vertex, 1.0);
+    gl_Position = transform * draws[gl_BaseInstanceARB].dequantization * vec4(a_vertex, 1.0);
 }
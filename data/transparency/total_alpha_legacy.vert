@@ -0,0 +1,13 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+layout(location = 0) in vec3 a_vertex;
+
+uniform mat4 transform;
+uniform mat4 dequantization;
+
+
+void main()
+{
+    gl_Position = transform * dequantization * vec4(a_vertex, 1.0);
+}
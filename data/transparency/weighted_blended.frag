@@ -0,0 +1,25 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec3 v_normal;
+
+layout(location = 0) out vec4 accumulation;
+layout(location = 1) out float revealage;
+
+uniform uint transparency;
+
+
+// Depth weight of equation 10 in McGuire and Bavoil, "Weighted Blended Order-Independent Transparency"
+float weight(float depth, float alpha)
+{
+    return alpha * clamp(3e3 * pow(1.0 - depth, 3.0), 1e-2, 3e3);
+}
+
+void main()
+{
+    float alpha = float(transparency) / 255.0;
+    vec3 color = vec3(v_normal * 0.5 + 0.5);
+
+    accumulation = vec4(color * alpha, alpha) * weight(gl_FragCoord.z, alpha);
+    revealage = alpha;
+}
@@ -0,0 +1,25 @@
+#version 150 core
+#extension GL_ARB_explicit_attrib_location : require
+
+in vec2 v_uv;
+
+layout (location = 0) out vec3 fragColor;
+
+uniform sampler2D opaqueColorTexture;
+uniform sampler2D accumulationTexture;
+uniform sampler2D revealageTexture;
+
+
+void main()
+{
+    ivec2 coordinate = ivec2(gl_FragCoord.xy);
+
+    vec3 opaqueColor = texelFetch(opaqueColorTexture, coordinate, 0).rgb;
+    vec4 accumulation = texelFetch(accumulationTexture, coordinate, 0);
+    float revealage = texelFetch(revealageTexture, coordinate, 0).r;
+
+    // Weighted average color of all transparent fragments, clamped against fp16 overflow
+    vec3 transparentColor = accumulation.rgb / clamp(accumulation.a, 1e-4, 5e4);
+
+    fragColor = opaqueColor * revealage + transparentColor * (1.0 - revealage);
+}
@@ -0,0 +1,221 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stochastic/MasksTableGenerator.h>
+
+
+namespace
+{
+
+const auto s_alphaRes = MasksTableGeneratorBase::s_alphaRes;
+const auto s_numMasks = MasksTableGeneratorBase::s_numMasks;
+const auto s_tileSize = MasksTableGeneratorBase::s_tileSize;
+
+const double s_pi = 3.14159265358979323846;
+
+struct Statistics
+{
+    double maxCoverageError;    ///< max over rows of |mean coverage - alpha|
+    double rmsSampleBias;       ///< RMS over rows and samples of |P(sample covered) - alpha|
+    double rmsPixelError;       ///< RMS of per-entry coverage - alpha
+    double rmsBlockError;       ///< RMS of 4x4 box filtered coverage - alpha
+    double lowFrequencyEnergy;  ///< fraction of noise power below half the Nyquist frequency
+};
+
+/**
+ *  @brief
+ *    Coverage of all entries of a table, one row per alpha
+ */
+std::vector<std::vector<double>> coverages(
+    const std::vector<unsigned char> & table,
+    unsigned int numSamples,
+    unsigned int maskSize,
+    std::vector<std::vector<double>> & sampleFrequencies)
+{
+    auto result = std::vector<std::vector<double>>(s_alphaRes, std::vector<double>(s_numMasks));
+    sampleFrequencies.assign(s_alphaRes, std::vector<double>(numSamples, 0.0));
+
+    for (auto alpha = 0u; alpha < s_alphaRes; ++alpha)
+    {
+        for (auto i = 0u; i < s_numMasks; ++i)
+        {
+            auto mask = uint32_t{0u};
+            std::memcpy(&mask, &table[(alpha * s_numMasks + i) * maskSize], maskSize);
+
+            auto numCovered = 0u;
+            for (auto sample = 0u; sample < numSamples; ++sample)
+            {
+                if (mask & (1u << sample))
+                {
+                    ++numCovered;
+                    sampleFrequencies[alpha][sample] += 1.0 / s_numMasks;
+                }
+            }
+
+            result[alpha][i] = static_cast<double>(numCovered) / numSamples;
+        }
+    }
+
+    return result;
+}
+
+double lowFrequencyEnergy(const std::vector<double> & noise)
+{
+    // Direct DFT over the toroidal tile; the tile is small enough
+    auto lowEnergy = 0.0;
+    auto totalEnergy = 0.0;
+
+    for (auto v = 0u; v < s_tileSize; ++v)
+    {
+        for (auto u = 0u; u < s_tileSize; ++u)
+        {
+            auto re = 0.0, im = 0.0;
+
+            for (auto y = 0u; y < s_tileSize; ++y)
+            {
+                for (auto x = 0u; x < s_tileSize; ++x)
+                {
+                    const auto phase = -2.0 * s_pi * (static_cast<double>(u * x + v * y) / s_tileSize);
+                    re += noise[y * s_tileSize + x] * std::cos(phase);
+                    im += noise[y * s_tileSize + x] * std::sin(phase);
+                }
+            }
+
+            const auto fu = static_cast<double>(std::min(u, s_tileSize - u));
+            const auto fv = static_cast<double>(std::min(v, s_tileSize - v));
+            const auto power = re * re + im * im;
+
+            totalEnergy += power;
+
+            if (std::sqrt(fu * fu + fv * fv) < s_tileSize / 4.0)
+                lowEnergy += power;
+        }
+    }
+
+    return totalEnergy > 0.0 ? lowEnergy / totalEnergy : 0.0;
+}
+
+Statistics analyze(unsigned int numSamples, MaskDistribution distribution, unsigned int seed)
+{
+    static const auto blockSize = 4u;
+
+    const auto maskSize = MasksTableGeneratorBase::maskSize(numSamples);
+    const auto table = MasksTableGeneratorBase::generateTable(numSamples, maskSize, distribution, seed);
+
+    auto sampleFrequencies = std::vector<std::vector<double>>{};
+    const auto coverage = coverages(table, numSamples, maskSize, sampleFrequencies);
+
+    auto statistics = Statistics{};
+    auto numSpectra = 0u;
+
+    for (auto alpha = 0u; alpha < s_alphaRes; ++alpha)
+    {
+        const auto expected = static_cast<double>(alpha) / (s_alphaRes - 1u);
+        const auto & row = coverage[alpha];
+
+        auto mean = 0.0;
+        for (auto value : row)
+            mean += value / s_numMasks;
+
+        statistics.maxCoverageError = std::max(statistics.maxCoverageError, std::abs(mean - expected));
+
+        for (auto frequency : sampleFrequencies[alpha])
+            statistics.rmsSampleBias += (frequency - expected) * (frequency - expected) / (s_alphaRes * numSamples);
+
+        auto noise = std::vector<double>(s_numMasks);
+        for (auto i = 0u; i < s_numMasks; ++i)
+        {
+            noise[i] = row[i] - expected;
+            statistics.rmsPixelError += noise[i] * noise[i] / (s_alphaRes * s_numMasks);
+        }
+
+        for (auto y = 0u; y < s_tileSize; ++y)
+        {
+            for (auto x = 0u; x < s_tileSize; ++x)
+            {
+                auto block = 0.0;
+
+                for (auto by = 0u; by < blockSize; ++by)
+                    for (auto bx = 0u; bx < blockSize; ++bx)
+                        block += noise[((y + by) % s_tileSize) * s_tileSize + (x + bx) % s_tileSize];
+
+                block /= blockSize * blockSize;
+                statistics.rmsBlockError += block * block / (s_alphaRes * s_numMasks);
+            }
+        }
+
+        // Spectra of a few representative rows
+        if (alpha % 32u == 16u)
+        {
+            statistics.lowFrequencyEnergy += lowFrequencyEnergy(noise);
+            ++numSpectra;
+        }
+    }
+
+    statistics.rmsSampleBias = std::sqrt(statistics.rmsSampleBias);
+    statistics.rmsPixelError = std::sqrt(statistics.rmsPixelError);
+    statistics.rmsBlockError = std::sqrt(statistics.rmsBlockError);
+    statistics.lowFrequencyEnergy /= numSpectra;
+
+    return statistics;
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+    const auto seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : MasksTableGeneratorBase::s_defaultSeed;
+
+    const std::pair<MaskDistribution, const char *> distributions[] = {
+        { MaskDistribution::Random, "Random" },
+        { MaskDistribution::Stratified, "Stratified" },
+        { MaskDistribution::LowDiscrepancy, "LowDiscrepancy" },
+        { MaskDistribution::BlueNoise, "BlueNoise" }
+    };
+
+    const unsigned int sampleCounts[] = { 2u, 4u, 8u, 16u, 32u };
+
+    std::cout << "Masks table analysis (seed " << seed << ")" << std::endl
+        << "  coverage: max |mean coverage - alpha| over all rows" << std::endl
+        << "  bias:     RMS |P(sample covered) - alpha|" << std::endl
+        << "  pixel:    RMS per-entry coverage error" << std::endl
+        << "  block:    RMS coverage error of 4x4 pixel neighborhoods (tiled lookup)" << std::endl
+        << "  lowfreq:  fraction of noise power below half Nyquist (lower is bluer)" << std::endl
+        << std::endl;
+
+    std::cout << std::left
+        << std::setw(9) << "samples"
+        << std::setw(16) << "distribution"
+        << std::setw(12) << "coverage"
+        << std::setw(12) << "bias"
+        << std::setw(12) << "pixel"
+        << std::setw(12) << "block"
+        << std::setw(12) << "lowfreq" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(5);
+
+    for (auto numSamples : sampleCounts)
+    {
+        for (const auto & distribution : distributions)
+        {
+            const auto statistics = analyze(numSamples, distribution.first, seed);
+
+            std::cout
+                << std::setw(9) << numSamples
+                << std::setw(16) << distribution.second
+                << std::setw(12) << statistics.maxCoverageError
+                << std::setw(12) << statistics.rmsSampleBias
+                << std::setw(12) << statistics.rmsPixelError
+                << std::setw(12) << statistics.rmsBlockError
+                << std::setw(12) << statistics.lowFrequencyEnergy << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <assimp/scene.h>
+
+#include <AssimpLoader.h>
+#include <AssimpProcessing.h>
+#include <MeshOptimizer.h>
+#include <PlyLoader.h>
+#include <PolygonalGeometry.h>
+#include <stochastic/MasksTableGenerator.h>
+
+
+namespace
+{
+
+std::string dataPath(const std::string & filename)
+{
+    return std::string{GLEXAMPLES_DATA_PATH} + "/transparency/" + filename;
+}
+
+}
+
+static void MasksTableGenerator_generate(benchmark::State & state)
+{
+    const auto numSamples = static_cast<unsigned int>(state.range(0));
+    const auto numThreads = static_cast<unsigned int>(state.range(1));
+    const auto maskSize = MasksTableGeneratorBase::maskSize(numSamples);
+
+    for (auto _ : state)
+    {
+        auto table = MasksTableGeneratorBase::generateTable(numSamples, maskSize, MaskDistribution::Random,
+            MasksTableGeneratorBase::s_defaultSeed, numThreads);
+        benchmark::DoNotOptimize(table.data());
+    }
+}
+BENCHMARK(MasksTableGenerator_generate)
+    ->ArgNames({ "samples", "threads" })
+    ->ArgsProduct({ { 1, 2, 4, 8, 16, 32 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond);
+
+static void MasksTableGenerator_blueNoise(benchmark::State & state)
+{
+    const auto numSamples = static_cast<unsigned int>(state.range(0));
+    const auto maskSize = MasksTableGeneratorBase::maskSize(numSamples);
+
+    for (auto _ : state)
+    {
+        auto table = MasksTableGeneratorBase::generateTable(numSamples, maskSize, MaskDistribution::BlueNoise);
+        benchmark::DoNotOptimize(table.data());
+    }
+}
+BENCHMARK(MasksTableGenerator_blueNoise)
+    ->ArgName("samples")
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond);
+
+static void AssimpProcessing_convertToGeometries(benchmark::State & state, const char * filename)
+{
+    const auto numThreads = static_cast<unsigned int>(state.range(0));
+
+    const auto scene = AssimpLoader{}.load(dataPath(filename), nullptr);
+
+    if (!scene)
+    {
+        state.SkipWithError("Could not load file");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        auto geometries = AssimpProcessing::convertToGeometries(scene, numThreads);
+        benchmark::DoNotOptimize(geometries.data());
+    }
+
+    delete scene;
+}
+BENCHMARK_CAPTURE(AssimpProcessing_convertToGeometries, scene, "transparency_scene.obj")
+    ->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(AssimpProcessing_convertToGeometries, dragon, "dragon.obj")
+    ->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(AssimpProcessing_convertToGeometries, bunny, "bunny.ply")
+    ->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+static void AssimpLoader_loadPly(benchmark::State & state)
+{
+    for (auto _ : state)
+    {
+        const auto scene = AssimpLoader{}.load(dataPath("bunny.ply"), nullptr);
+
+        if (!scene)
+        {
+            state.SkipWithError("Could not load file");
+            return;
+        }
+
+        auto geometries = AssimpProcessing::convertToGeometries(scene);
+        benchmark::DoNotOptimize(geometries.data());
+
+        delete scene;
+    }
+}
+BENCHMARK(AssimpLoader_loadPly)->Unit(benchmark::kMillisecond);
+
+static void PlyLoader_load(benchmark::State & state)
+{
+    for (auto _ : state)
+    {
+        const auto geometry = PlyLoader{}.load(dataPath("bunny.ply"), nullptr);
+
+        if (!geometry)
+        {
+            state.SkipWithError("Could not load file");
+            return;
+        }
+
+        benchmark::DoNotOptimize(geometry->indices().data());
+
+        delete geometry;
+    }
+}
+BENCHMARK(PlyLoader_load)->Unit(benchmark::kMillisecond);
+
+static void PolygonalGeometry_move(benchmark::State & state)
+{
+    const auto scene = AssimpLoader{}.load(dataPath("dragon.obj"), nullptr);
+
+    if (!scene)
+    {
+        state.SkipWithError("Could not load file");
+        return;
+    }
+
+    auto geometries = AssimpProcessing::convertToGeometries(scene);
+    delete scene;
+
+    for (auto _ : state)
+    {
+        auto moved = std::move(geometries);
+        benchmark::DoNotOptimize(moved.data());
+        geometries = std::move(moved);
+    }
+}
+BENCHMARK(PolygonalGeometry_move);
+
+static void MeshOptimizer_optimize(benchmark::State & state, const char * filename)
+{
+    const auto scene = AssimpLoader{}.load(dataPath(filename), nullptr);
+
+    if (!scene)
+    {
+        state.SkipWithError("Could not load file");
+        return;
+    }
+
+    const auto geometries = AssimpProcessing::convertToGeometries(scene);
+    delete scene;
+
+    for (auto _ : state)
+    {
+        auto optimized = geometries;
+
+        for (auto & geometry : optimized)
+            MeshOptimizer::optimize(geometry);
+
+        benchmark::DoNotOptimize(optimized.data());
+    }
+}
+BENCHMARK_CAPTURE(MeshOptimizer_optimize, bunny, "bunny.ply")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
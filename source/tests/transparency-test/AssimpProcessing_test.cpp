@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <assimp/scene.h>
+
+#include <AssimpLoader.h>
+#include <AssimpProcessing.h>
+#include <PolygonalGeometry.h>
+
+
+class AssimpProcessing_test : public testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(AssimpProcessing_test, ConvertsAllMeshes)
+{
+    const auto filename = std::string{GLEXAMPLES_DATA_PATH} + "/transparency/" + GetParam();
+
+    const auto scene = AssimpLoader{}.load(filename, nullptr);
+    ASSERT_NE(nullptr, scene);
+
+    const auto geometries = AssimpProcessing::convertToGeometries(scene);
+    ASSERT_EQ(scene->mNumMeshes, geometries.size());
+
+    for (auto i = 0u; i < scene->mNumMeshes; ++i)
+    {
+        const auto mesh = scene->mMeshes[i];
+        const auto & geometry = geometries[i];
+
+        EXPECT_EQ(mesh->mNumFaces * 3u, geometry.indices().size());
+        EXPECT_EQ(mesh->mNumVertices, geometry.vertices().size());
+
+        ASSERT_TRUE(geometry.hasNormals());
+        EXPECT_EQ(mesh->mNumVertices, geometry.normals().size());
+
+        for (auto index : geometry.indices())
+            ASSERT_LT(index, geometry.vertices().size());
+
+        const auto & vertex = mesh->mVertices[mesh->mNumVertices - 1u];
+        EXPECT_EQ(glm::vec3(vertex.x, vertex.y, vertex.z), geometry.vertices().back());
+    }
+
+    delete scene;
+}
+
+TEST_P(AssimpProcessing_test, ThreadCountDoesNotChangeResult)
+{
+    const auto filename = std::string{GLEXAMPLES_DATA_PATH} + "/transparency/" + GetParam();
+
+    const auto scene = AssimpLoader{}.load(filename, nullptr);
+    ASSERT_NE(nullptr, scene);
+
+    const auto sequential = AssimpProcessing::convertToGeometries(scene, 1u);
+    const auto concurrent = AssimpProcessing::convertToGeometries(scene, 4u);
+    ASSERT_EQ(sequential.size(), concurrent.size());
+
+    for (auto i = 0u; i < sequential.size(); ++i)
+    {
+        EXPECT_EQ(sequential[i].indices(), concurrent[i].indices());
+        EXPECT_EQ(sequential[i].vertices(), concurrent[i].vertices());
+        EXPECT_EQ(sequential[i].normals(), concurrent[i].normals());
+    }
+
+    delete scene;
+}
+
+TEST_P(AssimpProcessing_test, LoaderReportsProgress)
+{
+    const auto filename = std::string{GLEXAMPLES_DATA_PATH} + "/transparency/" + GetParam();
+
+    auto numCalls = 0u;
+
+    const auto scene = AssimpLoader{}.load(filename, [&numCalls](int current, int total)
+    {
+        EXPECT_EQ(100, total);
+        EXPECT_GE(current, 0);
+        EXPECT_LE(current, total);
+        ++numCalls;
+    });
+    ASSERT_NE(nullptr, scene);
+
+    EXPECT_GT(numCalls, 0u);
+
+    delete scene;
+}
+
+INSTANTIATE_TEST_CASE_P(BundledMeshes, AssimpProcessing_test, testing::Values(
+    "transparency_scene.obj",
+    "dragon.obj",
+    "bunny.ply"));
@@ -0,0 +1,114 @@
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <BinaryMesh.h>
+#include <PolygonalGeometry.h>
+
+
+namespace
+{
+
+std::vector<PolygonalGeometry> createGeometries()
+{
+    auto withNormals = PolygonalGeometry{};
+    withNormals.setIndices({ 0u, 1u, 2u, 2u, 1u, 3u });
+    withNormals.setVertices({ glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f) });
+    withNormals.setNormals(std::vector<glm::vec3>(4u, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+    auto withoutNormals = PolygonalGeometry{};
+    withoutNormals.setIndices({ 0u, 1u, 2u });
+    withoutNormals.setVertices({ glm::vec3(2.0f), glm::vec3(3.0f), glm::vec3(4.0f) });
+
+    return { withNormals, withoutNormals };
+}
+
+}
+
+TEST(BinaryMesh_test, RoundTrip)
+{
+    const auto geometries = createGeometries();
+    const BinaryMesh mesh{BinaryMesh::serialize(geometries, 42u, 1234u)};
+
+    ASSERT_TRUE(mesh.isValid());
+    EXPECT_EQ(42u, mesh.sourceSize());
+    EXPECT_EQ(1234u, mesh.sourceTime());
+    ASSERT_EQ(geometries.size(), mesh.numMeshes());
+
+    for (auto i = 0u; i < mesh.numMeshes(); ++i)
+    {
+        const auto & geometry = geometries[i];
+
+        ASSERT_EQ(geometry.indices().size(), mesh.numIndices(i));
+        ASSERT_EQ(geometry.vertices().size(), mesh.numVertices(i));
+
+        EXPECT_EQ(geometry.indices(), std::vector<unsigned int>(mesh.indices(i), mesh.indices(i) + mesh.numIndices(i)));
+        EXPECT_EQ(geometry.vertices(), std::vector<glm::vec3>(mesh.vertices(i), mesh.vertices(i) + mesh.numVertices(i)));
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(mesh.vertices(i)) % 16u);
+        EXPECT_EQ(geometry.hasNormals(), mesh.normals(i) != nullptr);
+    }
+}
+
+TEST(BinaryMesh_test, RejectsCorruptData)
+{
+    auto data = BinaryMesh::serialize(createGeometries(), 0u, 0u);
+    data.back() ^= 1;
+
+    EXPECT_FALSE(BinaryMesh{std::move(data)}.isValid());
+}
+
+TEST(BinaryMesh_test, RejectsTruncatedData)
+{
+    auto data = BinaryMesh::serialize(createGeometries(), 0u, 0u);
+    data.resize(data.size() / 2u);
+
+    EXPECT_FALSE(BinaryMesh{std::move(data)}.isValid());
+    EXPECT_FALSE(BinaryMesh{std::vector<char>{}}.isValid());
+}
+
+TEST(BinaryMesh_test, ClustersCoverMesh)
+{
+    const auto numTriangles = 1000u;
+
+    auto vertices = std::vector<glm::vec3>{};
+    auto indices = std::vector<unsigned int>{};
+
+    for (auto i = 0u; i < numTriangles * 3u; ++i)
+    {
+        vertices.push_back(glm::vec3{static_cast<float>(i), static_cast<float>(i % 7u), -static_cast<float>(i)});
+        indices.push_back(i);
+    }
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(indices);
+    geometry.setVertices(vertices);
+
+    const BinaryMesh mesh{BinaryMesh::serialize({ geometry }, 0u, 0u)};
+
+    ASSERT_TRUE(mesh.isValid());
+
+    const auto & lod = mesh.lods(0)[0];
+    ASSERT_LT(1u, lod.numClusters);
+
+    auto nextIndex = 0u;
+
+    for (auto c = lod.firstCluster; c < lod.firstCluster + lod.numClusters; ++c)
+    {
+        const auto & cluster = mesh.clusters(0)[c];
+
+        EXPECT_EQ(nextIndex, cluster.firstIndex);
+        nextIndex += cluster.numIndices;
+
+        for (auto i = cluster.firstIndex; i < cluster.firstIndex + cluster.numIndices; ++i)
+        {
+            const auto & vertex = vertices[indices[i]];
+            EXPECT_EQ(vertex, glm::max(cluster.bounds.min(), glm::min(cluster.bounds.max(), vertex)));
+        }
+    }
+
+    EXPECT_EQ(indices.size(), nextIndex);
+    EXPECT_EQ(glm::vec3(0.0f, 0.0f, -static_cast<float>(indices.size() - 1u)), mesh.bounds(0).min());
+}
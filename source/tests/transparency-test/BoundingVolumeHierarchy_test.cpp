@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <BoundingBox.h>
+#include <BoundingVolumeHierarchy.h>
+#include <Frustum.h>
+
+
+namespace
+{
+
+std::vector<BoundingBox> createBoxes(unsigned int count)
+{
+    auto generator = std::mt19937{};
+    auto position = std::uniform_real_distribution<float>{-50.0f, 50.0f};
+    auto size = std::uniform_real_distribution<float>{0.1f, 4.0f};
+
+    auto boxes = std::vector<BoundingBox>{};
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto min = glm::vec3{position(generator), position(generator), position(generator)};
+        boxes.push_back(BoundingBox{min, min + glm::vec3{size(generator), size(generator), size(generator)}});
+    }
+
+    return boxes;
+}
+
+glm::mat4 createViewProjection(const glm::vec3 & eye, const glm::vec3 & center)
+{
+    return glm::perspective(0.8f, 1.5f, 0.1f, 60.0f) * glm::lookAt(eye, center, glm::vec3{0.0f, 1.0f, 0.0f});
+}
+
+}
+
+TEST(BoundingVolumeHierarchy_test, FrustumClassifiesBoxes)
+{
+    const auto frustum = Frustum{createViewProjection(glm::vec3{0.0f, 0.0f, 10.0f}, glm::vec3{0.0f})};
+
+    EXPECT_EQ(Frustum::Intersection::Inside, frustum.test(BoundingBox{glm::vec3{-1.0f}, glm::vec3{1.0f}}));
+    EXPECT_EQ(Frustum::Intersection::Outside, frustum.test(BoundingBox{glm::vec3{-1.0f, -1.0f, 11.0f}, glm::vec3{1.0f, 1.0f, 12.0f}}));
+    EXPECT_EQ(Frustum::Intersection::Outside, frustum.test(BoundingBox{glm::vec3{100.0f, -1.0f, -1.0f}, glm::vec3{101.0f, 1.0f, 1.0f}}));
+    EXPECT_EQ(Frustum::Intersection::Intersecting, frustum.test(BoundingBox{glm::vec3{-1.0f, -1.0f, 9.0f}, glm::vec3{1.0f, 1.0f, 11.0f}}));
+}
+
+TEST(BoundingVolumeHierarchy_test, MatchesBruteForce)
+{
+    const auto boxes = createBoxes(1000u);
+
+    auto hierarchy = BoundingVolumeHierarchy{};
+    hierarchy.build(boxes);
+
+    ASSERT_EQ(boxes.size(), hierarchy.numBoxes());
+
+    const auto views = std::vector<glm::mat4>{
+        createViewProjection(glm::vec3{0.0f, 0.0f, 80.0f}, glm::vec3{0.0f}),
+        createViewProjection(glm::vec3{0.0f}, glm::vec3{1.0f, 0.2f, 0.0f}),
+        createViewProjection(glm::vec3{-60.0f, 30.0f, 0.0f}, glm::vec3{10.0f, 0.0f, 5.0f}) };
+
+    for (const auto & viewProjection : views)
+    {
+        const auto frustum = Frustum{viewProjection};
+
+        auto visible = std::vector<bool>{};
+        const auto numVisible = hierarchy.cull(frustum, visible);
+
+        ASSERT_EQ(boxes.size(), visible.size());
+
+        auto expectedNumVisible = 0u;
+
+        for (auto i = 0u; i < boxes.size(); ++i)
+        {
+            const auto expected = frustum.test(boxes[i]) != Frustum::Intersection::Outside;
+            EXPECT_EQ(expected, visible[i]) << "box " << i;
+            expectedNumVisible += expected ? 1u : 0u;
+        }
+
+        EXPECT_EQ(expectedNumVisible, numVisible);
+        EXPECT_LT(0u, numVisible);
+        EXPECT_GT(boxes.size(), numVisible);
+    }
+}
+
+TEST(BoundingVolumeHierarchy_test, EmptyBoxesAreNeverVisible)
+{
+    auto boxes = createBoxes(10u);
+    boxes[3] = BoundingBox{};
+
+    auto hierarchy = BoundingVolumeHierarchy{};
+    hierarchy.build(boxes);
+
+    // Orthographic view containing all boxes
+    const auto viewProjection = glm::scale(glm::mat4{1.0f}, glm::vec3{0.01f});
+
+    auto visible = std::vector<bool>{};
+    const auto numVisible = hierarchy.cull(Frustum{viewProjection}, visible);
+
+    EXPECT_FALSE(visible[3]);
+    EXPECT_EQ(9u, numVisible);
+}
@@ -0,0 +1,64 @@
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <vector>
+
+#include <stochastic/MaskSourceBenchmark.h>
+#include <stochastic/StochasticTransparencyOptions.h>
+
+
+namespace
+{
+
+const auto kFramesPerConfiguration = MaskSourceBenchmark::s_warmupFrames + MaskSourceBenchmark::s_measuredFrames;
+
+}
+
+TEST(MaskSourceBenchmark_test, SampleCountsArePowersOfTwoUpToMaximum)
+{
+    EXPECT_EQ(std::vector<uint16_t>({ 1u, 2u, 4u, 8u }), MaskSourceBenchmark{8u}.sampleCounts());
+    EXPECT_EQ(std::vector<uint16_t>({ 1u, 2u, 4u, 6u }), MaskSourceBenchmark{6u}.sampleCounts());
+    EXPECT_EQ(std::vector<uint16_t>({ 1u }), MaskSourceBenchmark{1u}.sampleCounts());
+}
+
+TEST(MaskSourceBenchmark_test, VisitsEachConfigurationOnce)
+{
+    auto benchmark = MaskSourceBenchmark{4u};
+
+    const auto expectedSources = std::vector<MaskSource>{
+        MaskSource::Table, MaskSource::NativeAlphaToCoverage, MaskSource::IntegerHash };
+
+    for (auto numSamples : { 1u, 2u, 4u })
+    {
+        for (auto source : expectedSources)
+        {
+            for (auto frame = 0u; frame < kFramesPerConfiguration; ++frame)
+            {
+                ASSERT_FALSE(benchmark.finished());
+                EXPECT_EQ(source, benchmark.maskSource());
+                EXPECT_EQ(numSamples, benchmark.numSamples());
+
+                benchmark.addFrame(1.0f);
+            }
+        }
+    }
+
+    EXPECT_TRUE(benchmark.finished());
+}
+
+TEST(MaskSourceBenchmark_test, AveragesMeasuredFramesOnly)
+{
+    auto benchmark = MaskSourceBenchmark{2u};
+
+    for (auto frame = 0u; frame < kFramesPerConfiguration; ++frame)
+        benchmark.addFrame(frame < MaskSourceBenchmark::s_warmupFrames ? 100.0f : 2.0f);
+
+    EXPECT_FLOAT_EQ(2.0f, benchmark.averageTime(MaskSource::Table, 1u));
+    EXPECT_EQ(0.0f, benchmark.averageTime(MaskSource::NativeAlphaToCoverage, 1u));
+    EXPECT_EQ(0.0f, benchmark.averageTime(MaskSource::Table, 16u));
+
+    auto stream = std::ostringstream{};
+    benchmark.print(stream);
+
+    EXPECT_NE(std::string::npos, stream.str().find("2.000"));
+}
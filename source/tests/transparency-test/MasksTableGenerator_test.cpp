@@ -0,0 +1,126 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include <stochastic/MasksTableGenerator.h>
+
+
+namespace
+{
+
+uint32_t maskAt(const std::vector<unsigned char> & table, unsigned int maskSize, unsigned int alpha, unsigned int index)
+{
+    auto mask = uint32_t{0u};
+    std::memcpy(&mask, &table[(alpha * MasksTableGeneratorBase::s_numMasks + index) * maskSize], maskSize);
+    return mask;
+}
+
+unsigned int bitCount(uint32_t mask)
+{
+    auto count = 0u;
+
+    for (; mask != 0u; mask &= mask - 1u)
+        ++count;
+
+    return count;
+}
+
+}
+
+class MasksTableGenerator_test : public testing::TestWithParam<std::tuple<unsigned int, MaskDistribution>>
+{
+};
+
+TEST_P(MasksTableGenerator_test, RowsMatchAlpha)
+{
+    const auto numSamples = std::get<0>(GetParam());
+    const auto distribution = std::get<1>(GetParam());
+    const auto maskSize = MasksTableGeneratorBase::maskSize(numSamples);
+
+    const auto table = MasksTableGeneratorBase::generateTable(numSamples, maskSize, distribution);
+    ASSERT_EQ(MasksTableGeneratorBase::s_alphaRes * MasksTableGeneratorBase::s_numMasks * maskSize, table.size());
+
+    const auto unusedBits = numSamples < 32u ? ~((1u << numSamples) - 1u) : 0u;
+
+    for (auto alpha = 0u; alpha < MasksTableGeneratorBase::s_alphaRes; ++alpha)
+    {
+        const auto expected = numSamples * (static_cast<float>(alpha) / (MasksTableGeneratorBase::s_alphaRes - 1u));
+        const auto low = static_cast<unsigned int>(std::floor(expected));
+
+        auto sum = 0u;
+
+        for (auto i = 0u; i < MasksTableGeneratorBase::s_numMasks; ++i)
+        {
+            const auto mask = maskAt(table, maskSize, alpha, i);
+            const auto count = bitCount(mask);
+
+            ASSERT_EQ(0u, mask & unusedBits);
+            ASSERT_TRUE(count == low || count == low + 1u) << "alpha " << alpha << ", entry " << i;
+
+            sum += count;
+        }
+
+        // Mixing ratio is quantized to whole entries
+        const auto mean = static_cast<float>(sum) / MasksTableGeneratorBase::s_numMasks;
+        EXPECT_NEAR(expected, mean, numSamples / static_cast<float>(MasksTableGeneratorBase::s_numMasks)) << "alpha " << alpha;
+    }
+
+    const auto fullMask = numSamples < 32u ? (1u << numSamples) - 1u : ~0u;
+
+    EXPECT_EQ(0u, maskAt(table, maskSize, 0u, 0u));
+    EXPECT_EQ(fullMask, maskAt(table, maskSize, MasksTableGeneratorBase::s_alphaRes - 1u, 0u));
+}
+
+TEST_P(MasksTableGenerator_test, IndependentOfThreadCount)
+{
+    const auto numSamples = std::get<0>(GetParam());
+    const auto distribution = std::get<1>(GetParam());
+    const auto maskSize = MasksTableGeneratorBase::maskSize(numSamples);
+
+    const auto serial = MasksTableGeneratorBase::generateTable(numSamples, maskSize, distribution, 42u, 1u);
+    const auto parallel = MasksTableGeneratorBase::generateTable(numSamples, maskSize, distribution, 42u, 7u);
+
+    EXPECT_EQ(serial, parallel);
+}
+
+INSTANTIATE_TEST_CASE_P(SampleCounts, MasksTableGenerator_test, testing::Combine(
+    testing::Values(1u, 2u, 4u, 8u, 16u, 32u),
+    testing::Values(
+        MaskDistribution::Random,
+        MaskDistribution::Stratified,
+        MaskDistribution::LowDiscrepancy,
+        MaskDistribution::BlueNoise)));
+
+TEST(MasksTableGenerator_properties_test, SeedChangesTable)
+{
+    const auto a = MasksTableGeneratorBase::generateTable(8u, 1u, MaskDistribution::Random, 1u);
+    const auto b = MasksTableGeneratorBase::generateTable(8u, 1u, MaskDistribution::Random, 2u);
+
+    EXPECT_NE(a, b);
+}
+
+TEST(MasksTableGenerator_properties_test, SamplesAreUsedEvenly)
+{
+    static const auto numSamples = 8u;
+
+    const auto table = MasksTableGeneratorBase::generateTable(numSamples, 1u, MaskDistribution::Stratified);
+    const auto alpha = MasksTableGeneratorBase::s_alphaRes / 2u;
+
+    auto counts = std::vector<unsigned int>(numSamples, 0u);
+
+    for (auto i = 0u; i < MasksTableGeneratorBase::s_numMasks; ++i)
+    {
+        const auto mask = maskAt(table, 1u, alpha, i);
+
+        for (auto sample = 0u; sample < numSamples; ++sample)
+            counts[sample] += (mask >> sample) & 1u;
+    }
+
+    const auto expected = static_cast<float>(alpha) / (MasksTableGeneratorBase::s_alphaRes - 1u) * MasksTableGeneratorBase::s_numMasks;
+
+    for (auto count : counts)
+        EXPECT_NEAR(expected, static_cast<float>(count), 0.05f * MasksTableGeneratorBase::s_numMasks);
+}
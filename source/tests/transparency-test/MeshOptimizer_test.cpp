@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <MeshOptimizer.h>
+#include <PolygonalGeometry.h>
+
+#include "TestGeometry.h"
+
+
+namespace
+{
+
+std::vector<std::vector<unsigned int>> sortedTriangles(const PolygonalGeometry & geometry)
+{
+    auto triangles = std::vector<std::vector<unsigned int>>{};
+
+    for (auto i = 0u; i < geometry.indices().size(); i += 3u)
+    {
+        auto triangle = std::vector<unsigned int>{};
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            const auto & vertex = geometry.vertices()[geometry.indices()[i + j]];
+            triangle.push_back(static_cast<unsigned int>(vertex.y) * 1000u + static_cast<unsigned int>(vertex.x));
+        }
+
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+}
+
+TEST(MeshOptimizer_test, ImprovesCacheMissRatio)
+{
+    auto geometry = createGrid(32u);
+    shuffleTriangles(geometry, 42u);
+    const auto before = MeshOptimizer::analyze(geometry);
+
+    MeshOptimizer::optimize(geometry);
+    const auto after = MeshOptimizer::analyze(geometry);
+
+    EXPECT_LT(after.acmr, before.acmr);
+    EXPECT_LT(after.acmr, 1.0f);
+    EXPECT_GE(after.atvr, 1.0f);
+}
+
+TEST(MeshOptimizer_test, KeepsTrianglesAndWinding)
+{
+    auto geometry = createGrid(16u);
+    shuffleTriangles(geometry, 42u);
+    const auto triangles = sortedTriangles(geometry);
+
+    MeshOptimizer::optimize(geometry);
+
+    EXPECT_EQ(triangles, sortedTriangles(geometry));
+    EXPECT_EQ(geometry.vertices().size(), geometry.normals().size());
+}
+
+TEST(MeshOptimizer_test, VertexFetchFollowsFirstUse)
+{
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices({ 3u, 1u, 3u, 1u, 0u, 3u });
+    geometry.setVertices({ glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(2.0f), glm::vec3(3.0f) });
+
+    MeshOptimizer::optimizeVertexFetch(geometry);
+
+    EXPECT_EQ(std::vector<unsigned int>({ 0u, 1u, 0u, 1u, 2u, 0u }), geometry.indices());
+    EXPECT_EQ(std::vector<glm::vec3>({ glm::vec3(3.0f), glm::vec3(1.0f), glm::vec3(0.0f) }), geometry.vertices());
+    EXPECT_FALSE(geometry.hasNormals());
+}
+
+TEST(MeshOptimizer_test, OverdrawOfSingleLayerIsOne)
+{
+    const auto geometry = createGrid(8u);
+
+    EXPECT_FLOAT_EQ(1.0f, MeshOptimizer::overdraw(geometry.indices(), geometry.vertices()));
+}
+
+TEST(MeshOptimizer_test, IgnoresNonTriangleMeshes)
+{
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices({ 0u, 1u });
+    geometry.setVertices({ glm::vec3(0.0f), glm::vec3(1.0f) });
+
+    MeshOptimizer::optimize(geometry);
+
+    EXPECT_EQ(std::vector<unsigned int>({ 0u, 1u }), geometry.indices());
+}
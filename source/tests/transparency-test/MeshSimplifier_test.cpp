@@ -0,0 +1,127 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <BinaryMesh.h>
+#include <MeshSimplifier.h>
+#include <PolygonalGeometry.h>
+
+
+namespace
+{
+
+/** Unit sphere from a latitude longitude grid */
+PolygonalGeometry createSphere(unsigned int rings, unsigned int segments)
+{
+    static const auto pi = 3.14159265f;
+
+    auto vertices = std::vector<glm::vec3>{};
+    for (auto ring = 0u; ring <= rings; ++ring)
+    {
+        const auto theta = pi * static_cast<float>(ring) / static_cast<float>(rings);
+
+        for (auto segment = 0u; segment < segments; ++segment)
+        {
+            const auto phi = 2.0f * pi * static_cast<float>(segment) / static_cast<float>(segments);
+            vertices.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+
+    auto indices = std::vector<unsigned int>{};
+    for (auto ring = 0u; ring < rings; ++ring)
+    {
+        for (auto segment = 0u; segment < segments; ++segment)
+        {
+            const auto a = ring * segments + segment;
+            const auto b = ring * segments + (segment + 1u) % segments;
+            indices.insert(indices.end(), { a, b, a + segments, a + segments, b, b + segments });
+        }
+    }
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(vertices));
+    return geometry;
+}
+
+}
+
+TEST(MeshSimplifier_test, LevelsDecreaseInSize)
+{
+    const auto geometry = createSphere(64u, 128u);
+    const auto levels = MeshSimplifier::buildLevels(geometry);
+
+    ASSERT_LT(1u, levels.size());
+    EXPECT_LE(levels.size(), MeshSimplifier::s_maxLevels);
+    EXPECT_EQ(geometry.indices(), levels[0].indices);
+    EXPECT_EQ(0.0f, levels[0].error);
+
+    for (auto i = 1u; i < levels.size(); ++i)
+    {
+        EXPECT_EQ(0u, levels[i].indices.size() % 3u);
+        EXPECT_LE(levels[i].indices.size(), levels[i - 1u].indices.size() * MeshSimplifier::s_minReduction);
+        EXPECT_GE(levels[i].error, levels[i - 1u].error);
+    }
+}
+
+TEST(MeshSimplifier_test, ErrorBoundsVertexDeviation)
+{
+    const auto geometry = createSphere(32u, 64u);
+
+    auto error = 0.0f;
+    const auto indices = MeshSimplifier::simplify(geometry.indices(), geometry.vertices(), 8u, error);
+
+    ASSERT_FALSE(indices.empty());
+    EXPECT_LT(indices.size(), geometry.indices().size());
+
+    // Cells are a quarter unit wide, no vertex moves further than a cell diagonal
+    EXPECT_GT(error, 0.0f);
+    EXPECT_LE(error, std::sqrt(3.0f) * 0.25f);
+
+    // All remaining vertices lie on the unit sphere
+    for (const auto index : indices)
+        EXPECT_NEAR(1.0f, glm::length(geometry.vertices()[index]), 1e-4f);
+}
+
+TEST(MeshSimplifier_test, SelectsCoarserLevelsWithDistance)
+{
+    const auto errors = std::vector<float>{ 0.0f, 0.01f, 0.1f, 1.0f };
+    static const auto projectionScale = 1000.0f;
+
+    EXPECT_EQ(0u, MeshSimplifier::selectLevel(errors, 0.0f, projectionScale, 1.0f));
+    EXPECT_EQ(0u, MeshSimplifier::selectLevel(errors, 1.0f, projectionScale, 1.0f));
+    EXPECT_EQ(1u, MeshSimplifier::selectLevel(errors, 10.0f, projectionScale, 1.0f));
+    EXPECT_EQ(2u, MeshSimplifier::selectLevel(errors, 100.0f, projectionScale, 1.0f));
+    EXPECT_EQ(3u, MeshSimplifier::selectLevel(errors, 1000.0f, projectionScale, 1.0f));
+    EXPECT_EQ(2u, MeshSimplifier::selectLevel(errors, 10.0f, projectionScale, 10.0f));
+}
+
+TEST(MeshSimplifier_test, BinaryMeshStoresLevels)
+{
+    const auto geometry = createSphere(64u, 128u);
+    const BinaryMesh mesh{BinaryMesh::serialize({ geometry }, 0u, 0u)};
+
+    ASSERT_TRUE(mesh.isValid());
+    ASSERT_LT(1u, mesh.numLods(0));
+
+    const auto lods = mesh.lods(0);
+    EXPECT_EQ(geometry.indices().size(), lods[0].numIndices);
+
+    auto numIndices = 0u;
+    auto numClusters = 0u;
+
+    for (auto level = 0u; level < mesh.numLods(0); ++level)
+    {
+        EXPECT_EQ(numIndices, lods[level].firstIndex);
+        EXPECT_EQ(numClusters, lods[level].firstCluster);
+
+        numIndices += lods[level].numIndices;
+        numClusters += lods[level].numClusters;
+    }
+
+    EXPECT_EQ(mesh.numIndices(0), numIndices);
+    EXPECT_EQ(mesh.numClusters(0), numClusters);
+}
@@ -0,0 +1,68 @@
+#include <gmock/gmock.h>
+
+#include <set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <MeshletBuilder.h>
+#include <PolygonalGeometry.h>
+
+#include "TestGeometry.h"
+
+
+TEST(MeshletBuilder_test, RespectsLimits)
+{
+    const auto geometry = createGrid(40u);
+    const auto & indices = geometry.indices();
+    const auto meshlets = MeshletBuilder::build(geometry);
+
+    auto nextIndex = 0u;
+
+    for (const auto & meshlet : meshlets)
+    {
+        ASSERT_EQ(nextIndex, meshlet.firstIndex);
+        nextIndex += meshlet.numIndices;
+
+        const auto unique = std::set<unsigned int>(indices.begin() + meshlet.firstIndex, indices.begin() + nextIndex);
+
+        EXPECT_LE(unique.size(), MeshletBuilder::s_maxVertices);
+        EXPECT_LE(meshlet.numIndices, MeshletBuilder::s_maxTriangles * 3u);
+        EXPECT_EQ(0u, meshlet.numIndices % 3u);
+
+        for (const auto index : unique)
+        {
+            const auto & vertex = geometry.vertices()[index];
+            EXPECT_LE(glm::distance(meshlet.center, vertex), meshlet.radius * 1.0001f);
+        }
+    }
+
+    EXPECT_EQ(indices.size(), nextIndex);
+}
+
+TEST(MeshletBuilder_test, CullsBackFacingMeshlets)
+{
+    const auto meshlets = MeshletBuilder::build(createGrid(20u));
+    ASSERT_FALSE(meshlets.empty());
+
+    for (const auto & meshlet : meshlets)
+    {
+        EXPECT_EQ(glm::vec3(0.0f, 0.0f, 1.0f), meshlet.coneAxis);
+
+        EXPECT_TRUE(MeshletBuilder::isBackFacing(meshlet, glm::vec3(10.0f, 10.0f, -50.0f)));
+        EXPECT_FALSE(MeshletBuilder::isBackFacing(meshlet, glm::vec3(10.0f, 10.0f, 50.0f)));
+    }
+}
+
+TEST(MeshletBuilder_test, KeepsMeshletsWithOpposingNormals)
+{
+    auto geometry = PolygonalGeometry{};
+    geometry.setVertices({ glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) });
+    geometry.setIndices({ 0u, 1u, 2u, 0u, 2u, 1u });
+
+    const auto meshlets = MeshletBuilder::build(geometry);
+    ASSERT_EQ(1u, meshlets.size());
+
+    EXPECT_FALSE(MeshletBuilder::isBackFacing(meshlets[0], glm::vec3(0.2f, 0.2f, -5.0f)));
+    EXPECT_FALSE(MeshletBuilder::isBackFacing(meshlets[0], glm::vec3(0.2f, 0.2f, 5.0f)));
+}
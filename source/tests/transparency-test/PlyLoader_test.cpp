@@ -0,0 +1,205 @@
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <PlyLoader.h>
+#include <PolygonalGeometry.h>
+
+
+namespace
+{
+
+const auto kQuadHeader = std::string{
+    "element vertex 4\n"
+    "property float x\n"
+    "property float y\n"
+    "property float z\n"
+    "element face 1\n"
+    "property list uchar int vertex_indices\n"
+    "end_header\n"};
+
+const auto kQuadVertices = std::vector<glm::vec3>{
+    glm::vec3(0.0f, 0.0f, 0.0f),
+    glm::vec3(1.0f, 0.0f, 0.0f),
+    glm::vec3(1.0f, 1.0f, 0.0f),
+    glm::vec3(0.0f, 1.0f, 0.0f) };
+
+template <typename T>
+void append(std::string & data, T value, bool bigEndian)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+    // Tests run on little endian hosts only
+    if (bigEndian)
+        std::reverse(bytes, bytes + sizeof(T));
+
+    data.append(bytes, sizeof(T));
+}
+
+std::string binaryQuad(bool bigEndian)
+{
+    auto data = std::string{"ply\nformat "} + (bigEndian ? "binary_big_endian" : "binary_little_endian") + " 1.0\n" + kQuadHeader;
+
+    for (const auto & vertex : kQuadVertices)
+    {
+        append(data, vertex.x, bigEndian);
+        append(data, vertex.y, bigEndian);
+        append(data, vertex.z, bigEndian);
+    }
+
+    append(data, std::uint8_t{4u}, bigEndian);
+
+    for (auto index : { 0, 1, 2, 3 })
+        append(data, std::int32_t{index}, bigEndian);
+
+    return data;
+}
+
+}
+
+TEST(PlyLoader_test, ParsesAsciiAndTriangulatesPolygons)
+{
+    const auto data = std::string{"ply\nformat ascii 1.0\ncomment quad\n"} + kQuadHeader +
+        "0 0 0\n1 0 0\n1 1 0\n0 1 0\n4 0 1 2 3\n";
+
+    auto geometry = PolygonalGeometry{};
+    ASSERT_TRUE(PlyLoader::parse(data.data(), data.size(), geometry));
+
+    EXPECT_EQ(std::vector<unsigned int>({ 0u, 1u, 2u, 0u, 2u, 3u }), geometry.indices());
+    EXPECT_EQ(kQuadVertices, geometry.vertices());
+}
+
+TEST(PlyLoader_test, BinaryMatchesAscii)
+{
+    const auto ascii = std::string{"ply\nformat ascii 1.0\n"} + kQuadHeader +
+        "0 0 0\n1 0 0\n1 1 0\n0 1 0\n4 0 1 2 3\n";
+
+    auto expected = PolygonalGeometry{};
+    ASSERT_TRUE(PlyLoader::parse(ascii.data(), ascii.size(), expected));
+
+    for (auto bigEndian : { false, true })
+    {
+        const auto data = binaryQuad(bigEndian);
+
+        auto geometry = PolygonalGeometry{};
+        ASSERT_TRUE(PlyLoader::parse(data.data(), data.size(), geometry));
+
+        EXPECT_EQ(expected.indices(), geometry.indices());
+        EXPECT_EQ(expected.vertices(), geometry.vertices());
+        EXPECT_EQ(expected.normals(), geometry.normals());
+    }
+}
+
+TEST(PlyLoader_test, ComputesNormalsOnlyIfMissing)
+{
+    const auto computed = std::string{"ply\nformat ascii 1.0\n"} + kQuadHeader +
+        "0 0 0\n1 0 0\n1 1 0\n0 1 0\n4 0 1 2 3\n";
+
+    auto geometry = PolygonalGeometry{};
+    ASSERT_TRUE(PlyLoader::parse(computed.data(), computed.size(), geometry));
+
+    ASSERT_TRUE(geometry.hasNormals());
+    EXPECT_EQ(std::vector<glm::vec3>(4u, glm::vec3(0.0f, 0.0f, 1.0f)), geometry.normals());
+
+    const auto stored = std::string{
+        "ply\nformat ascii 1.0\n"
+        "element vertex 3\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "property float nx\nproperty float ny\nproperty float nz\n"
+        "element face 1\n"
+        "property list uchar uint vertex_index\n"
+        "end_header\n"
+        "0 0 0 1 0 0\n1 0 0 1 0 0\n0 1 0 1 0 0\n3 0 1 2\n"};
+
+    ASSERT_TRUE(PlyLoader::parse(stored.data(), stored.size(), geometry));
+    EXPECT_EQ(std::vector<glm::vec3>(3u, glm::vec3(1.0f, 0.0f, 0.0f)), geometry.normals());
+}
+
+TEST(PlyLoader_test, SkipsUnknownElementsAndProperties)
+{
+    const auto data = std::string{
+        "ply\nformat ascii 1.0\n"
+        "element vertex 3\n"
+        "property float x\nproperty float confidence\nproperty float y\nproperty float z\n"
+        "element material 1\n"
+        "property list uchar float weights\n"
+        "element face 1\n"
+        "property uchar flags\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"
+        "0 0.5 0 0\n1 0.5 0 0\n0 0.5 1 0\n"
+        "2 0.25 0.75\n"
+        "7 3 2 1 0\n"};
+
+    auto geometry = PolygonalGeometry{};
+    ASSERT_TRUE(PlyLoader::parse(data.data(), data.size(), geometry));
+
+    EXPECT_EQ(std::vector<unsigned int>({ 2u, 1u, 0u }), geometry.indices());
+    EXPECT_EQ(glm::vec3(0.0f, 1.0f, 0.0f), geometry.vertices()[2]);
+}
+
+TEST(PlyLoader_test, RejectsMalformedFiles)
+{
+    const auto truncated = binaryQuad(false);
+    const auto outOfRange = std::string{"ply\nformat ascii 1.0\n"} + kQuadHeader +
+        "0 0 0\n1 0 0\n1 1 0\n0 1 0\n3 0 1 4\n";
+
+    auto geometry = PolygonalGeometry{};
+    EXPECT_FALSE(PlyLoader::parse(truncated.data(), truncated.size() - 1u, geometry));
+    EXPECT_FALSE(PlyLoader::parse(outOfRange.data(), outOfRange.size(), geometry));
+    EXPECT_FALSE(PlyLoader::parse("solid stl\n", 10u, geometry));
+}
+
+TEST(PlyLoader_test, RejectsCountsExceedingTheData)
+{
+    const auto header = std::string{
+        "element vertex 4000000000000\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "element face 4000000000000\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"};
+
+    const auto binary = std::string{"ply\nformat binary_little_endian 1.0\n"} + header + std::string(48u, '\0');
+    const auto ascii = std::string{"ply\nformat ascii 1.0\n"} + header + "0 0 0\n1 0 0\n1 1 0\n";
+    const auto negativeCount = std::string{"ply\nformat ascii 1.0\n"} + kQuadHeader +
+        "0 0 0\n1 0 0\n1 1 0\n0 1 0\n-4 0 1 2 3\n";
+
+    auto geometry = PolygonalGeometry{};
+    EXPECT_FALSE(PlyLoader::parse(binary.data(), binary.size(), geometry));
+    EXPECT_FALSE(PlyLoader::parse(ascii.data(), ascii.size(), geometry));
+    EXPECT_FALSE(PlyLoader::parse(negativeCount.data(), negativeCount.size(), geometry));
+}
+
+TEST(PlyLoader_test, IgnoresExtensionCase)
+{
+    EXPECT_TRUE(PlyLoader{}.canLoad(".PLY"));
+    EXPECT_TRUE(PlyLoader{}.canLoad("Ply"));
+    EXPECT_FALSE(PlyLoader{}.canLoad(".obj"));
+}
+
+TEST(PlyLoader_test, LoadsBunny)
+{
+    const auto filename = std::string{GLEXAMPLES_DATA_PATH} + "/transparency/bunny.ply";
+
+    auto numCalls = 0;
+    const auto geometry = PlyLoader{}.load(filename, [&numCalls](int current, int total)
+    {
+        EXPECT_LE(current, total);
+        ++numCalls;
+    });
+
+    ASSERT_NE(nullptr, geometry);
+    EXPECT_EQ(35947u, geometry->vertices().size());
+    EXPECT_EQ(69451u * 3u, geometry->indices().size());
+    EXPECT_EQ(geometry->vertices().size(), geometry->normals().size());
+    EXPECT_LT(0, numCalls);
+
+    delete geometry;
+}
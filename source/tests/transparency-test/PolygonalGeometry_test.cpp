@@ -0,0 +1,47 @@
+#include <gmock/gmock.h>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <PolygonalGeometry.h>
+
+
+TEST(PolygonalGeometry_test, MoveKeepsStorage)
+{
+    auto indices = std::vector<unsigned int>{ 0u, 1u, 2u };
+    auto vertices = std::vector<glm::vec3>{ glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(2.0f) };
+    auto normals = std::vector<glm::vec3>(3u, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    const auto indicesData = indices.data();
+    const auto verticesData = vertices.data();
+    const auto normalsData = normals.data();
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(vertices));
+    geometry.setNormals(std::move(normals));
+
+    EXPECT_EQ(indicesData, geometry.indices().data());
+    EXPECT_EQ(verticesData, geometry.vertices().data());
+    EXPECT_EQ(normalsData, geometry.normals().data());
+    EXPECT_TRUE(geometry.hasNormals());
+
+    const auto moved = std::move(geometry);
+
+    EXPECT_EQ(indicesData, moved.indices().data());
+    EXPECT_EQ(verticesData, moved.vertices().data());
+    EXPECT_EQ(normalsData, moved.normals().data());
+}
+
+TEST(PolygonalGeometry_test, CopyDoesNotAlias)
+{
+    const auto indices = std::vector<unsigned int>{ 0u, 1u, 2u };
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(indices);
+
+    EXPECT_EQ(indices, geometry.indices());
+    EXPECT_NE(indices.data(), geometry.indices().data());
+    EXPECT_FALSE(geometry.hasNormals());
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <PolygonalGeometry.h>
+
+
+/** Regular grid of size x size quads in the xy plane, facing +z */
+inline PolygonalGeometry createGrid(unsigned int size)
+{
+    auto vertices = std::vector<glm::vec3>{};
+    for (auto y = 0u; y <= size; ++y)
+    {
+        for (auto x = 0u; x <= size; ++x)
+            vertices.push_back(glm::vec3(static_cast<float>(x), static_cast<float>(y), 0.0f));
+    }
+
+    auto indices = std::vector<unsigned int>{};
+    for (auto y = 0u; y < size; ++y)
+    {
+        for (auto x = 0u; x < size; ++x)
+        {
+            const auto i = y * (size + 1u) + x;
+            indices.insert(indices.end(), { i, i + 1u, i + size + 2u, i, i + size + 2u, i + size + 1u });
+        }
+    }
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(vertices));
+    geometry.setNormals(std::vector<glm::vec3>(geometry.vertices().size(), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+    return geometry;
+}
+
+/** Reorders the triangles randomly, keeping their winding */
+inline void shuffleTriangles(PolygonalGeometry & geometry, unsigned int seed)
+{
+    const auto & indices = geometry.indices();
+
+    auto triangles = std::vector<std::array<unsigned int, 3u>>{};
+    for (auto i = 0u; i + 2u < indices.size(); i += 3u)
+        triangles.push_back({{ indices[i], indices[i + 1u], indices[i + 2u] }});
+
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{seed});
+
+    auto shuffled = std::vector<unsigned int>{};
+    for (const auto & triangle : triangles)
+        shuffled.insert(shuffled.end(), triangle.begin(), triangle.end());
+
+    geometry.setIndices(std::move(shuffled));
+}
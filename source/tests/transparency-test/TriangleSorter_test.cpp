@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <sorted/TriangleSorter.h>
+
+
+namespace
+{
+
+void createTriangles(unsigned int count, std::vector<unsigned int> & indices, std::vector<glm::vec3> & vertices)
+{
+    auto generator = std::mt19937{};
+    auto position = std::uniform_real_distribution<float>{-10.0f, 10.0f};
+
+    for (auto i = 0u; i < count * 3u; ++i)
+    {
+        vertices.push_back(glm::vec3{position(generator), position(generator), position(generator)});
+        indices.push_back(i);
+    }
+}
+
+float viewDepth(const glm::mat4 & view, const std::vector<glm::vec3> & vertices, const unsigned int * triangle)
+{
+    const auto centroid = (vertices[triangle[0]] + vertices[triangle[1]] + vertices[triangle[2]]) / 3.0f;
+    return (view * glm::vec4{centroid, 1.0f}).z;
+}
+
+}
+
+class TriangleSorter_test : public testing::TestWithParam<unsigned int>
+{
+};
+
+INSTANTIATE_TEST_CASE_P(Threads, TriangleSorter_test, testing::Values(1u, 3u, 8u));
+
+TEST_P(TriangleSorter_test, SortsBackToFront)
+{
+    auto indices = std::vector<unsigned int>{};
+    auto vertices = std::vector<glm::vec3>{};
+    createTriangles(5000u, indices, vertices);
+
+    auto sorter = TriangleSorter{indices, vertices, GetParam()};
+    ASSERT_EQ(5000u, sorter.numTriangles());
+
+    const auto views = std::vector<glm::mat4>{
+        glm::lookAt(glm::vec3{0.0f, 0.0f, 30.0f}, glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f}),
+        glm::lookAt(glm::vec3{-20.0f, 15.0f, 5.0f}, glm::vec3{1.0f, 0.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 0.0f}) };
+
+    for (const auto & view : views)
+    {
+        const auto & sorted = sorter.sort(view);
+        ASSERT_EQ(indices.size(), sorted.size());
+
+        for (auto i = 3u; i < sorted.size(); i += 3u)
+            EXPECT_LE(viewDepth(view, vertices, &sorted[i - 3u]), viewDepth(view, vertices, &sorted[i]));
+
+        auto permutation = sorted;
+        std::sort(permutation.begin(), permutation.end());
+        EXPECT_EQ(indices, permutation);
+    }
+}
+
+TEST_P(TriangleSorter_test, KeepsOrderOfEqualDepths)
+{
+    const auto vertices = std::vector<glm::vec3>{ glm::vec3{0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f} };
+    const auto indices = std::vector<unsigned int>{ 0u, 1u, 2u, 1u, 2u, 0u, 2u, 0u, 1u };
+
+    auto sorter = TriangleSorter{indices, vertices, GetParam()};
+
+    EXPECT_EQ(indices, sorter.sort(glm::mat4{1.0f}));
+}
@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <VertexPacking.h>
+
+
+namespace
+{
+
+const auto positions = std::vector<glm::vec3>{
+    glm::vec3(-1.0f, 2.0f, 0.5f),
+    glm::vec3(3.0f, -4.0f, 0.25f),
+    glm::vec3(0.1f, 0.2f, 0.3f) };
+
+const auto normals = std::vector<glm::vec3>{
+    glm::vec3(1.0f, 0.0f, 0.0f),
+    glm::vec3(0.0f, -1.0f, 0.0f),
+    glm::vec3(0.0f, 0.6f, 0.8f) };
+
+glm::vec3 dequantize(const glm::mat4 & dequantization, const glm::vec3 & stored)
+{
+    const auto position = dequantization * glm::vec4(stored, 1.0f);
+    return glm::vec3(position.x, position.y, position.z);
+}
+
+}
+
+TEST(VertexPacking_test, HalfRoundTrip)
+{
+    for (auto value : { 0.0f, 1.0f, -1.0f, 0.5f, 0.333f, -0.0001f, 1e-6f })
+        EXPECT_NEAR(value, VertexPacking::unpackHalf(VertexPacking::packHalf(value)), std::abs(value) * 1e-3f + 1e-7f);
+
+    EXPECT_EQ(0x3c00u, VertexPacking::packHalf(1.0f));
+    EXPECT_EQ(0xbc00u, VertexPacking::packHalf(-1.0f));
+    EXPECT_EQ(0x3800u, VertexPacking::packHalf(0.5f));
+}
+
+TEST(VertexPacking_test, NormalRoundTrip)
+{
+    for (const auto & normal : normals)
+    {
+        const auto unpacked = VertexPacking::unpackNormal(VertexPacking::packNormal(normal));
+
+        for (auto c = 0; c < 3; ++c)
+            EXPECT_NEAR(normal[c], unpacked[c], 1.0f / 511.0f);
+    }
+}
+
+TEST(VertexPacking_test, LayoutIsTight)
+{
+    EXPECT_EQ(16u, VertexPacking::layout(PositionFormat::Float, true).stride);
+    EXPECT_EQ(12u, VertexPacking::layout(PositionFormat::Float, false).stride);
+    EXPECT_EQ(12u, VertexPacking::layout(PositionFormat::Quantized, true).stride);
+    EXPECT_EQ(8u, VertexPacking::layout(PositionFormat::HalfFloat, true).normalOffset);
+    EXPECT_EQ(0u, VertexPacking::layout(PositionFormat::HalfFloat, false).normalOffset);
+}
+
+TEST(VertexPacking_test, QuantizedPositionsAreRestored)
+{
+    auto dequantization = glm::mat4{};
+    const auto data = VertexPacking::interleave(positions.data(), normals.data(), 3u, PositionFormat::Quantized, dequantization);
+
+    const auto layout = VertexPacking::layout(PositionFormat::Quantized, true);
+    ASSERT_EQ(3u * layout.stride, data.size());
+
+    for (auto i = 0u; i < positions.size(); ++i)
+    {
+        uint16_t stored[4];
+        std::memcpy(stored, data.data() + i * layout.stride, sizeof(stored));
+
+        const auto position = dequantize(dequantization,
+            glm::vec3(stored[0] / 65535.0f, stored[1] / 65535.0f, stored[2] / 65535.0f));
+
+        for (auto c = 0; c < 3; ++c)
+            EXPECT_NEAR(positions[i][c], position[c], 1e-4f);
+    }
+}
+
+TEST(VertexPacking_test, HalfFloatPositionsAreRestored)
+{
+    auto dequantization = glm::mat4{};
+    const auto data = VertexPacking::interleave(positions.data(), nullptr, 3u, PositionFormat::HalfFloat, dequantization);
+
+    const auto layout = VertexPacking::layout(PositionFormat::HalfFloat, false);
+    ASSERT_EQ(3u * layout.stride, data.size());
+
+    for (auto i = 0u; i < positions.size(); ++i)
+    {
+        uint16_t stored[4];
+        std::memcpy(stored, data.data() + i * layout.stride, sizeof(stored));
+
+        const auto position = dequantize(dequantization, glm::vec3(
+            VertexPacking::unpackHalf(stored[0]),
+            VertexPacking::unpackHalf(stored[1]),
+            VertexPacking::unpackHalf(stored[2])));
+
+        for (auto c = 0; c < 3; ++c)
+            EXPECT_NEAR(positions[i][c], position[c], 5e-3f);
+    }
+}
@@ -0,0 +1,38 @@
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <vector>
+
+#include <WorkerPool.h>
+
+
+TEST(WorkerPool_test, RunsTaskOncePerThread)
+{
+    WorkerPool pool{4u};
+    ASSERT_EQ(4u, pool.numThreads());
+
+    auto calls = std::vector<std::atomic<unsigned int>>(pool.numThreads());
+
+    for (auto & count : calls)
+        count = 0u;
+
+    for (auto run = 0u; run < 100u; ++run)
+        pool.run([&calls] (unsigned int thread) { ++calls[thread]; });
+
+    for (const auto & count : calls)
+        EXPECT_EQ(100u, count);
+}
+
+TEST(WorkerPool_test, SingleThreadRunsOnCaller)
+{
+    WorkerPool pool{1u};
+    auto calls = 0u;
+
+    pool.run([&calls] (unsigned int thread)
+    {
+        EXPECT_EQ(0u, thread);
+        ++calls;
+    });
+
+    EXPECT_EQ(1u, calls);
+}
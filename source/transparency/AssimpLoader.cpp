@@ -7,6 +7,35 @@
 #include <assimp/cimport.h>
 #include <assimp/types.h>
 #include <assimp/postprocess.h>
+#include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
+
+
+namespace
+{
+
+/** Forwards Assimp's progress in percent to a gloperate style progress callback */
+class ProgressForwarder : public Assimp::ProgressHandler
+{
+public:
+    ProgressForwarder(const std::function<void(int, int)> & progress)
+    :   m_progress(progress)
+    {
+    }
+
+    bool Update(float percentage) override
+    {
+        if (percentage >= 0.0f)
+            m_progress(static_cast<int>(percentage * 100.0f), 100);
+
+        return true;
+    }
+
+private:
+    const std::function<void(int, int)> & m_progress;
+};
+
+}
 
 bool AssimpLoader::canLoad(const std::string & ext) const
 {
@@ -75,17 +104,28 @@ std::string AssimpLoader::allLoadingTypes() const
     return string;
 }
 
-aiScene * AssimpLoader::load(const std::string & filename, std::function<void(int, int)> /*progress*/) const
+aiScene * AssimpLoader::load(const std::string & filename, std::function<void(int, int)> progress) const
 {
-    auto scene = aiImportFile(
-        filename.c_str(),
+    Assimp::Importer importer;
+    ProgressForwarder progressForwarder{progress};
+
+    if (progress)
+        importer.SetProgressHandler(&progressForwarder);
+
+    importer.ReadFile(
+        filename,
         aiProcess_Triangulate           |
         aiProcess_JoinIdenticalVertices |
         aiProcess_SortByPType |
         aiProcess_GenNormals);
 
+    // The importer deletes its handler on destruction, so restore the default one
+    importer.SetProgressHandler(nullptr);
+
+    const auto scene = importer.GetOrphanedScene();
+
     if (scene == nullptr)
-        std::cout << aiGetErrorString();
+        std::cout << importer.GetErrorString();
 
-    return const_cast<aiScene *>(scene);
+    return scene;
 }
@@ -15,8 +15,11 @@ public:
     std::string allLoadingTypes() const override;
 
     /**
+     *  @param progress
+     *    Called with the import progress in percent (current, 100), may be empty
+     *
      *  @remarks
-     *    Scene must be deleted with `aiReleaseImport(scene)`
+     *    Scene is owned by the caller and must be deleted with `delete scene`
      */
     aiScene * load(const std::string & filename, std::function<void(int, int)> progress) const override;
 };
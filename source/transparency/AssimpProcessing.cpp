@@ -1,21 +1,44 @@
 #include "AssimpProcessing.h"
 
+#include <atomic>
 #include <cassert>
+#include <cstring>
 
 #include <glm/glm.hpp>
 
 #include <assimp/scene.h>
 #include <assimp/mesh.h>
 
+#include "ParallelFor.h"
 #include "PolygonalGeometry.h"
 
 
-std::vector<PolygonalGeometry> AssimpProcessing::convertToGeometries(const aiScene * scene)
+namespace
 {
-    auto geometries = std::vector<PolygonalGeometry>{};
 
-    for (auto i = 0u; i < scene->mNumMeshes; ++i)
-        geometries.push_back(convertToGeometry(scene->mMeshes[i]));
+static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "aiVector3D has to be layout compatible to glm::vec3");
+
+std::vector<glm::vec3> convertVectors(const aiVector3D * data, unsigned int count)
+{
+    const auto begin = reinterpret_cast<const glm::vec3 *>(data);
+
+    return std::vector<glm::vec3>(begin, begin + count);
+}
+
+}
+
+std::vector<PolygonalGeometry> AssimpProcessing::convertToGeometries(const aiScene * scene, unsigned int numThreads)
+{
+    auto geometries = std::vector<PolygonalGeometry>(scene->mNumMeshes);
+
+    // Meshes differ a lot in size, so workers fetch the next mesh instead of a fixed range
+    std::atomic<unsigned int> next{0u};
+
+    parallelFor(scene->mNumMeshes, [scene, &geometries, &next](unsigned int, unsigned int)
+    {
+        for (auto i = next++; i < scene->mNumMeshes; i = next++)
+            geometries[i] = convertToGeometry(scene->mMeshes[i]);
+    }, numThreads);
 
     return geometries;
 }
@@ -24,33 +47,36 @@ PolygonalGeometry AssimpProcessing::convertToGeometry(const aiMesh * mesh)
 {
     auto geometry = PolygonalGeometry{};
 
-    auto indices = std::vector<unsigned int>{};
+    // Triangulated meshes allow sizing the index buffer without a counting pass
+    auto numIndices = std::size_t{0u};
+
+    if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+    {
+        numIndices = mesh->mNumFaces * std::size_t{3u};
+    }
+    else
+    {
+        for (auto i = 0u; i < mesh->mNumFaces; ++i)
+            numIndices += mesh->mFaces[i].mNumIndices;
+    }
+
+    auto indices = std::vector<unsigned int>(numIndices);
+    auto index = indices.data();
+
     for (auto i = 0u; i < mesh->mNumFaces; ++i)
     {
         const auto & face = mesh->mFaces[i];
-        for (auto j = 0u; j < face.mNumIndices; ++j)
-            indices.push_back(face.mIndices[j]);
+        assert(index + face.mNumIndices <= indices.data() + indices.size());
+
+        std::memcpy(index, face.mIndices, face.mNumIndices * sizeof(unsigned int));
+        index += face.mNumIndices;
     }
     geometry.setIndices(std::move(indices));
 
-    auto vertices = std::vector<glm::vec3>{};
-    for (auto i = 0u; i < mesh->mNumVertices; ++i)
-    {
-        const auto & vertex = mesh->mVertices[i];
-        vertices.push_back({ vertex.x, vertex.y, vertex.z });
-    }
-    geometry.setVertices(std::move(vertices));
+    geometry.setVertices(convertVectors(mesh->mVertices, mesh->mNumVertices));
 
     if (mesh->HasNormals())
-    {
-        auto normals = std::vector<glm::vec3>{};
-        for (auto i = 0u; i < mesh->mNumVertices; ++i)
-        {
-            const auto & normal = mesh->mNormals[i];
-            normals.push_back({ normal.x, normal.y, normal.z });
-        }
-        geometry.setNormals(std::move(normals));
-    }
+        geometry.setNormals(convertVectors(mesh->mNormals, mesh->mNumVertices));
 
     return geometry;
 }
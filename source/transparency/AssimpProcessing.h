@@ -10,6 +10,10 @@ class PolygonalGeometry;
 class AssimpProcessing
 {
 public:
-    static std::vector<PolygonalGeometry> convertToGeometries(const aiScene * scene);
+    /**
+     *  @param numThreads
+     *    Number of meshes converted concurrently, 0 uses std::thread::hardware_concurrency()
+     */
+    static std::vector<PolygonalGeometry> convertToGeometries(const aiScene * scene, unsigned int numThreads = 0u);
     static PolygonalGeometry convertToGeometry(const aiMesh * mesh);
 };
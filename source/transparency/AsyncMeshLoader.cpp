@@ -0,0 +1,91 @@
+#include "AsyncMeshLoader.h"
+
+#include "BinaryMesh.h"
+#include "MeshCache.h"
+#include "SceneDrawable.h"
+
+
+AsyncMeshLoader::AsyncMeshLoader(
+    const std::string & filename,
+    const MeshCache & cache,
+    std::function<void(int, int)> progress)
+:   m_numUploaded{0u}
+,   m_progress{0}
+,   m_finished{false}
+,   m_failed{false}
+{
+    m_thread = std::thread{&AsyncMeshLoader::load, this, filename, cache, progress};
+}
+
+AsyncMeshLoader::~AsyncMeshLoader()
+{
+    m_thread.join();
+}
+
+int AsyncMeshLoader::progress() const
+{
+    return m_progress;
+}
+
+bool AsyncMeshLoader::hasFailed() const
+{
+    return m_failed;
+}
+
+bool AsyncMeshLoader::isFinished() const
+{
+    return m_finished;
+}
+
+std::unique_ptr<BinaryMesh> AsyncMeshLoader::takeMesh()
+{
+    if (!m_finished)
+        return nullptr;
+
+    return std::move(m_mesh);
+}
+
+void AsyncMeshLoader::load(
+    const std::string & filename,
+    const MeshCache & cache,
+    std::function<void(int, int)> progress)
+{
+    auto mesh = cache.load(filename, [this, &progress](int current, int total)
+    {
+        m_progress = total > 0 ? current * 100 / total : 0;
+
+        if (progress)
+            progress(current, total);
+    });
+
+    // m_mesh is only accessed by upload() after m_finished has been set
+    m_failed = !mesh;
+    m_mesh = std::move(mesh);
+    m_progress = 100;
+    m_finished = true;
+}
+
+bool AsyncMeshLoader::upload(SceneDrawable & scene, std::size_t maxBytes)
+{
+    if (!m_finished)
+        return false;
+
+    if (!m_mesh)
+        return true;
+
+    if (m_numUploaded == 0u)
+        scene.allocate(*m_mesh);
+
+    auto numBytes = std::size_t{0u};
+
+    while (m_numUploaded < m_mesh->numMeshes() && (numBytes == 0u || numBytes < maxBytes))
+        numBytes += scene.add(*m_mesh, m_numUploaded++);
+
+    if (m_numUploaded < m_mesh->numMeshes())
+        return false;
+
+    // Everything lives in GL buffers now, so the mapping is not needed anymore
+    m_mesh.reset();
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+
+class BinaryMesh;
+class MeshCache;
+class SceneDrawable;
+
+/**
+ *  @brief
+ *    Loads a scene through MeshCache on a worker thread and uploads it incrementally
+ *
+ *  @remarks
+ *    upload() has to be called from the thread owning the GL context, e.g., once per frame.
+ */
+class AsyncMeshLoader
+{
+public:
+    /**
+     *  @param progress
+     *    Called from the worker thread while the scene is imported, may be empty
+     */
+    AsyncMeshLoader(
+        const std::string & filename,
+        const MeshCache & cache,
+        std::function<void(int, int)> progress = nullptr);
+
+    /** Blocks until the worker thread has finished */
+    ~AsyncMeshLoader();
+
+    /** Import progress in percent */
+    int progress() const;
+
+    /** Only meaningful once upload() returned true or isFinished() */
+    bool hasFailed() const;
+
+    /** true once the worker thread has finished loading */
+    bool isFinished() const;
+
+    /**
+     *  @brief
+     *    Hands the loaded meshes over instead of uploading them to a SceneDrawable
+     *
+     *  @return
+     *    nullptr if loading has not finished or failed
+     */
+    std::unique_ptr<BinaryMesh> takeMesh();
+
+    /**
+     *  @brief
+     *    Adds loaded meshes that have not been uploaded yet to scene
+     *
+     *  @param maxBytes
+     *    Upload budget for this call, the first pending mesh is uploaded regardless of its size
+     *
+     *  @return
+     *    true if loading has finished or failed and all meshes have been uploaded
+     */
+    bool upload(SceneDrawable & scene, std::size_t maxBytes);
+
+protected:
+    void load(const std::string & filename, const MeshCache & cache, std::function<void(int, int)> progress);
+
+private:
+    std::unique_ptr<BinaryMesh> m_mesh;
+    unsigned int m_numUploaded;
+
+    std::atomic<int> m_progress;
+    std::atomic<bool> m_finished;
+    std::atomic<bool> m_failed;
+
+    std::thread m_thread;
+};
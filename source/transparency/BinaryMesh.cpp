@@ -0,0 +1,318 @@
+#include "BinaryMesh.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <glm/glm.hpp>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "CacheFile.h"
+#include "MappedFile.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "PolygonalGeometry.h"
+
+
+namespace
+{
+
+struct BinaryMeshHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numMeshes;
+    uint32_t reserved;
+    uint64_t sourceSize;
+    uint64_t sourceTime;
+    uint64_t fileSize;
+    uint64_t checksum;
+};
+
+struct BinaryMeshEntry
+{
+    uint64_t indicesOffset;
+    uint64_t verticesOffset;
+    uint64_t normalsOffset;
+    uint64_t clustersOffset;
+    uint64_t lodsOffset;
+    uint32_t numIndices;
+    uint32_t numVertices;
+    uint32_t numClusters;
+    uint32_t numLods;
+};
+
+static_assert(sizeof(BinaryMesh::Cluster) == 64u, "Clusters are stored as is");
+static_assert(sizeof(BinaryMesh::Lod) == 20u, "Levels of detail are stored as is");
+
+const char s_magic[4] = { 'M', 'E', 'S', 'H' };
+
+const auto s_alignment = uint64_t{16u};
+
+uint64_t align(uint64_t offset)
+{
+    return (offset + s_alignment - 1u) & ~(s_alignment - 1u);
+}
+
+const BinaryMeshHeader & header(const char * data)
+{
+    return *reinterpret_cast<const BinaryMeshHeader *>(data);
+}
+
+const BinaryMeshEntry & entry(const char * data, unsigned int mesh)
+{
+    return reinterpret_cast<const BinaryMeshEntry *>(data + sizeof(BinaryMeshHeader))[mesh];
+}
+
+}
+
+std::vector<char> BinaryMesh::serialize(
+    const std::vector<PolygonalGeometry> & geometries,
+    uint64_t sourceSize,
+    uint64_t sourceTime)
+{
+    auto entries = std::vector<BinaryMeshEntry>(geometries.size());
+    auto indices = std::vector<std::vector<unsigned int>>(geometries.size());
+    auto clusters = std::vector<std::vector<BinaryMesh::Cluster>>(geometries.size());
+    auto lods = std::vector<std::vector<BinaryMesh::Lod>>(geometries.size());
+    auto offset = align(sizeof(BinaryMeshHeader) + entries.size() * sizeof(BinaryMeshEntry));
+
+    for (auto i = 0u; i < geometries.size(); ++i)
+    {
+        const auto & geometry = geometries[i];
+        auto & entry = entries[i];
+
+        for (const auto & level : MeshSimplifier::buildLevels(geometry))
+        {
+            auto lod = BinaryMesh::Lod{};
+            lod.firstIndex = static_cast<uint32_t>(indices[i].size());
+            lod.numIndices = static_cast<uint32_t>(level.indices.size());
+            lod.firstCluster = static_cast<uint32_t>(clusters[i].size());
+            lod.error = level.error;
+
+            for (auto cluster : MeshletBuilder::build(level.indices, geometry.vertices()))
+            {
+                cluster.firstIndex += lod.firstIndex;
+                clusters[i].push_back(cluster);
+            }
+
+            lod.numClusters = static_cast<uint32_t>(clusters[i].size()) - lod.firstCluster;
+
+            indices[i].insert(indices[i].end(), level.indices.begin(), level.indices.end());
+            lods[i].push_back(lod);
+        }
+
+        entry.numIndices = static_cast<uint32_t>(indices[i].size());
+        entry.numVertices = static_cast<uint32_t>(geometry.vertices().size());
+        entry.numClusters = static_cast<uint32_t>(clusters[i].size());
+        entry.numLods = static_cast<uint32_t>(lods[i].size());
+
+        entry.indicesOffset = offset;
+        offset = align(offset + entry.numIndices * sizeof(unsigned int));
+
+        entry.verticesOffset = offset;
+        offset = align(offset + entry.numVertices * sizeof(glm::vec3));
+
+        entry.normalsOffset = 0u;
+
+        if (geometry.hasNormals())
+        {
+            entry.normalsOffset = offset;
+            offset = align(offset + entry.numVertices * sizeof(glm::vec3));
+        }
+
+        entry.clustersOffset = offset;
+        offset = align(offset + entry.numClusters * sizeof(BinaryMesh::Cluster));
+
+        entry.lodsOffset = offset;
+        offset = align(offset + entry.numLods * sizeof(BinaryMesh::Lod));
+    }
+
+    auto data = std::vector<char>(offset, 0);
+
+    std::memcpy(data.data() + sizeof(BinaryMeshHeader), entries.data(), entries.size() * sizeof(BinaryMeshEntry));
+
+    for (auto i = 0u; i < geometries.size(); ++i)
+    {
+        const auto & geometry = geometries[i];
+        const auto & entry = entries[i];
+
+        std::memcpy(data.data() + entry.indicesOffset, indices[i].data(), entry.numIndices * sizeof(unsigned int));
+        std::memcpy(data.data() + entry.verticesOffset, geometry.vertices().data(), entry.numVertices * sizeof(glm::vec3));
+
+        if (entry.normalsOffset != 0u)
+            std::memcpy(data.data() + entry.normalsOffset, geometry.normals().data(), entry.numVertices * sizeof(glm::vec3));
+
+        std::memcpy(data.data() + entry.clustersOffset, clusters[i].data(), entry.numClusters * sizeof(BinaryMesh::Cluster));
+        std::memcpy(data.data() + entry.lodsOffset, lods[i].data(), entry.numLods * sizeof(BinaryMesh::Lod));
+    }
+
+    auto header = BinaryMeshHeader{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.numMeshes = static_cast<uint32_t>(geometries.size());
+    header.reserved = 0u;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.fileSize = offset;
+    header.checksum = CacheFile::checksum(data.data() + sizeof(BinaryMeshHeader), data.size() - sizeof(BinaryMeshHeader));
+
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    return data;
+}
+
+bool BinaryMesh::write(const std::string & filename, const std::vector<char> & data)
+{
+    const auto temporary = filename + ".tmp";
+
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    stream.write(data.data(), data.size());
+    stream.close();
+
+    if (!stream)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return CacheFile::replace(temporary, filename);
+}
+
+BinaryMesh::BinaryMesh(const std::string & filename)
+:   m_file{widgetzeug::make_unique<MappedFile>(filename)}
+,   m_data{m_file->data()}
+,   m_size{m_file->size()}
+,   m_valid{false}
+{
+    m_valid = validate();
+}
+
+BinaryMesh::BinaryMesh(std::vector<char> && data)
+:   m_buffer{std::move(data)}
+,   m_data{m_buffer.data()}
+,   m_size{m_buffer.size()}
+,   m_valid{false}
+{
+    m_valid = validate();
+}
+
+BinaryMesh::~BinaryMesh() = default;
+
+bool BinaryMesh::validate() const
+{
+    if (m_data == nullptr || m_size < sizeof(BinaryMeshHeader))
+        return false;
+
+    const auto & fileHeader = header(m_data);
+
+    if (std::memcmp(fileHeader.magic, s_magic, sizeof(s_magic)) != 0
+        || fileHeader.version != s_version
+        || fileHeader.fileSize != m_size
+        || sizeof(BinaryMeshHeader) + fileHeader.numMeshes * sizeof(BinaryMeshEntry) > m_size)
+        return false;
+
+    const auto payload = m_data + sizeof(BinaryMeshHeader);
+
+    if (CacheFile::checksum(payload, m_size - sizeof(BinaryMeshHeader)) != fileHeader.checksum)
+        return false;
+
+    for (auto i = 0u; i < fileHeader.numMeshes; ++i)
+    {
+        const auto & meshEntry = entry(m_data, i);
+        const auto vertexBlockSize = uint64_t{meshEntry.numVertices} * sizeof(glm::vec3);
+
+        if (meshEntry.indicesOffset + uint64_t{meshEntry.numIndices} * sizeof(unsigned int) > m_size
+            || meshEntry.verticesOffset + vertexBlockSize > m_size
+            || meshEntry.normalsOffset + vertexBlockSize > m_size
+            || meshEntry.clustersOffset + uint64_t{meshEntry.numClusters} * sizeof(Cluster) > m_size
+            || meshEntry.lodsOffset + uint64_t{meshEntry.numLods} * sizeof(Lod) > m_size
+            || meshEntry.numLods == 0u)
+            return false;
+    }
+
+    return true;
+}
+
+bool BinaryMesh::isValid() const
+{
+    return m_valid;
+}
+
+uint64_t BinaryMesh::sourceSize() const
+{
+    return header(m_data).sourceSize;
+}
+
+uint64_t BinaryMesh::sourceTime() const
+{
+    return header(m_data).sourceTime;
+}
+
+unsigned int BinaryMesh::numMeshes() const
+{
+    return header(m_data).numMeshes;
+}
+
+const unsigned int * BinaryMesh::indices(unsigned int mesh) const
+{
+    return reinterpret_cast<const unsigned int *>(m_data + entry(m_data, mesh).indicesOffset);
+}
+
+unsigned int BinaryMesh::numIndices(unsigned int mesh) const
+{
+    return entry(m_data, mesh).numIndices;
+}
+
+const glm::vec3 * BinaryMesh::vertices(unsigned int mesh) const
+{
+    return reinterpret_cast<const glm::vec3 *>(m_data + entry(m_data, mesh).verticesOffset);
+}
+
+unsigned int BinaryMesh::numVertices(unsigned int mesh) const
+{
+    return entry(m_data, mesh).numVertices;
+}
+
+const glm::vec3 * BinaryMesh::normals(unsigned int mesh) const
+{
+    const auto offset = entry(m_data, mesh).normalsOffset;
+
+    if (offset == 0u)
+        return nullptr;
+
+    return reinterpret_cast<const glm::vec3 *>(m_data + offset);
+}
+
+const BinaryMesh::Cluster * BinaryMesh::clusters(unsigned int mesh) const
+{
+    return reinterpret_cast<const Cluster *>(m_data + entry(m_data, mesh).clustersOffset);
+}
+
+unsigned int BinaryMesh::numClusters(unsigned int mesh) const
+{
+    return entry(m_data, mesh).numClusters;
+}
+
+const BinaryMesh::Lod * BinaryMesh::lods(unsigned int mesh) const
+{
+    return reinterpret_cast<const Lod *>(m_data + entry(m_data, mesh).lodsOffset);
+}
+
+unsigned int BinaryMesh::numLods(unsigned int mesh) const
+{
+    return entry(m_data, mesh).numLods;
+}
+
+BoundingBox BinaryMesh::bounds(unsigned int mesh) const
+{
+    const auto meshClusters = clusters(mesh);
+
+    auto box = BoundingBox{};
+
+    for (auto i = 0u; i < numClusters(mesh); ++i)
+        box.extend(meshClusters[i].bounds);
+
+    return box;
+}
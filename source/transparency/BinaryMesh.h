@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/fwd.hpp>
+
+#include "BoundingBox.h"
+
+
+class MappedFile;
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Compact binary representation of the meshes of a scene, usually memory-mapped from disk
+ *
+ *  @remarks
+ *    The format consists of a header, one entry per mesh and 16 byte aligned index,
+ *    vertex and normal blocks that can be handed to the GL without conversion.
+ *    Each mesh stores several levels of detail, see MeshSimplifier. The indices of all levels are
+ *    stored consecutively and refer to the same vertices. Each level is split into clusters of
+ *    consecutive triangles with precomputed bounds for culling, see MeshletBuilder.
+ *    A content hash over everything following the header guards against corruption,
+ *    size and modification time of the source file guard against staleness.
+ *    Accessors other than isValid() require a valid mesh.
+ */
+class BinaryMesh
+{
+public:
+    static const uint32_t s_version = 4u;
+
+public:
+    struct Cluster
+    {
+        uint32_t firstIndex; ///< relative to the indices of the mesh
+        uint32_t numIndices;
+        BoundingBox bounds;
+        glm::vec3 center;
+        float radius;
+        glm::vec3 coneAxis;   ///< mean triangle normal, zero if the cone is disabled
+        float coneCutoff;
+    };
+
+    struct Lod
+    {
+        uint32_t firstIndex;   ///< relative to the indices of the mesh
+        uint32_t numIndices;
+        uint32_t firstCluster;
+        uint32_t numClusters;
+        float error;           ///< maximum vertex deviation from the original mesh
+    };
+
+public:
+    static std::vector<char> serialize(
+        const std::vector<PolygonalGeometry> & geometries,
+        uint64_t sourceSize,
+        uint64_t sourceTime);
+
+    static bool write(const std::string & filename, const std::vector<char> & data);
+
+public:
+    /** Maps filename */
+    BinaryMesh(const std::string & filename);
+
+    /** Uses serialized data, e.g., if it could not be written to disk */
+    BinaryMesh(std::vector<char> && data);
+
+    ~BinaryMesh();
+
+    bool isValid() const;
+
+    uint64_t sourceSize() const;
+    uint64_t sourceTime() const;
+
+    unsigned int numMeshes() const;
+
+    /** Indices of all levels of detail, level 0 first */
+    const unsigned int * indices(unsigned int mesh) const;
+    unsigned int numIndices(unsigned int mesh) const;
+
+    const glm::vec3 * vertices(unsigned int mesh) const;
+    unsigned int numVertices(unsigned int mesh) const;
+
+    /** nullptr if the mesh has no normals */
+    const glm::vec3 * normals(unsigned int mesh) const;
+
+    /** Clusters of all levels of detail */
+    const Cluster * clusters(unsigned int mesh) const;
+    unsigned int numClusters(unsigned int mesh) const;
+
+    /** At least one level per mesh, the original geometry */
+    const Lod * lods(unsigned int mesh) const;
+    unsigned int numLods(unsigned int mesh) const;
+
+    /** Union of the cluster bounds */
+    BoundingBox bounds(unsigned int mesh) const;
+
+protected:
+    bool validate() const;
+
+private:
+    std::unique_ptr<MappedFile> m_file;
+    std::vector<char> m_buffer;
+
+    const char * m_data;
+    std::size_t m_size;
+    bool m_valid;
+};
@@ -0,0 +1,53 @@
+#include "BoundingBox.h"
+
+#include <limits>
+
+
+BoundingBox::BoundingBox()
+:   m_min{std::numeric_limits<float>::max()}
+,   m_max{-std::numeric_limits<float>::max()}
+{
+}
+
+BoundingBox::BoundingBox(const glm::vec3 & min, const glm::vec3 & max)
+:   m_min{min}
+,   m_max{max}
+{
+}
+
+bool BoundingBox::isEmpty() const
+{
+    return m_min.x > m_max.x || m_min.y > m_max.y || m_min.z > m_max.z;
+}
+
+const glm::vec3 & BoundingBox::min() const
+{
+    return m_min;
+}
+
+const glm::vec3 & BoundingBox::max() const
+{
+    return m_max;
+}
+
+glm::vec3 BoundingBox::center() const
+{
+    return (m_min + m_max) * 0.5f;
+}
+
+glm::vec3 BoundingBox::extent() const
+{
+    return isEmpty() ? glm::vec3{0.0f} : m_max - m_min;
+}
+
+void BoundingBox::extend(const glm::vec3 & point)
+{
+    m_min = glm::min(m_min, point);
+    m_max = glm::max(m_max, point);
+}
+
+void BoundingBox::extend(const BoundingBox & box)
+{
+    m_min = glm::min(m_min, box.m_min);
+    m_max = glm::max(m_max, box.m_max);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+/**
+ *  @brief
+ *    Axis-aligned bounding box, default constructed boxes are empty
+ */
+class BoundingBox
+{
+public:
+    BoundingBox();
+    BoundingBox(const glm::vec3 & min, const glm::vec3 & max);
+
+    bool isEmpty() const;
+
+    const glm::vec3 & min() const;
+    const glm::vec3 & max() const;
+
+    glm::vec3 center() const;
+    glm::vec3 extent() const;
+
+    void extend(const glm::vec3 & point);
+    void extend(const BoundingBox & box);
+
+private:
+    glm::vec3 m_min;
+    glm::vec3 m_max;
+};
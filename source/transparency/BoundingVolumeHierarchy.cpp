@@ -0,0 +1,141 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+
+#include "Frustum.h"
+
+
+void BoundingVolumeHierarchy::build(const std::vector<BoundingBox> & boxes)
+{
+    m_boxes = boxes;
+    m_nodes.clear();
+    m_items.clear();
+
+    for (auto i = 0u; i < m_boxes.size(); ++i)
+    {
+        if (!m_boxes[i].isEmpty())
+            m_items.push_back(i);
+    }
+
+    if (m_items.empty())
+        return;
+
+    m_nodes.reserve(2u * m_items.size() / s_maxLeafSize + 1u);
+    build(0u, static_cast<uint32_t>(m_items.size()));
+}
+
+uint32_t BoundingVolumeHierarchy::build(uint32_t first, uint32_t count)
+{
+    const auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{});
+
+    auto bounds = BoundingBox{};
+    auto centroids = BoundingBox{};
+
+    for (auto i = first; i < first + count; ++i)
+    {
+        bounds.extend(m_boxes[m_items[i]]);
+        centroids.extend(m_boxes[m_items[i]].center());
+    }
+
+    m_nodes[index].bounds = bounds;
+
+    if (count <= s_maxLeafSize)
+    {
+        m_nodes[index].first = first;
+        m_nodes[index].count = count;
+        return index;
+    }
+
+    const auto extent = centroids.extent();
+    const auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    const auto begin = m_items.begin() + first;
+    const auto middle = begin + count / 2u;
+    const auto & boxes = m_boxes;
+
+    std::nth_element(begin, middle, begin + count, [&boxes, axis] (uint32_t a, uint32_t b)
+    {
+        return boxes[a].center()[axis] < boxes[b].center()[axis];
+    });
+
+    build(first, count / 2u);
+    const auto right = build(first + count / 2u, count - count / 2u);
+
+    m_nodes[index].first = right;
+    m_nodes[index].count = 0u;
+
+    return index;
+}
+
+unsigned int BoundingVolumeHierarchy::cull(const Frustum & frustum, std::vector<bool> & visible) const
+{
+    visible.assign(m_boxes.size(), false);
+
+    if (m_nodes.empty())
+        return 0u;
+
+    auto numVisible = 0u;
+    auto stack = std::vector<uint32_t>{ 0u };
+
+    while (!stack.empty())
+    {
+        const auto index = stack.back();
+        const auto & node = m_nodes[index];
+        stack.pop_back();
+
+        const auto intersection = frustum.test(node.bounds);
+
+        if (intersection == Frustum::Intersection::Outside)
+            continue;
+
+        if (intersection == Frustum::Intersection::Inside)
+        {
+            numVisible += accept(index, visible);
+            continue;
+        }
+
+        if (node.count == 0u)
+        {
+            stack.push_back(node.first);
+            stack.push_back(index + 1u);
+            continue;
+        }
+
+        for (auto i = node.first; i < node.first + node.count; ++i)
+        {
+            const auto item = m_items[i];
+
+            if (frustum.test(m_boxes[item]) == Frustum::Intersection::Outside)
+                continue;
+
+            visible[item] = true;
+            ++numVisible;
+        }
+    }
+
+    return numVisible;
+}
+
+unsigned int BoundingVolumeHierarchy::accept(uint32_t index, std::vector<bool> & visible) const
+{
+    const auto & node = m_nodes[index];
+
+    if (node.count == 0u)
+        return accept(index + 1u, visible) + accept(node.first, visible);
+
+    for (auto i = node.first; i < node.first + node.count; ++i)
+        visible[m_items[i]] = true;
+
+    return node.count;
+}
+
+unsigned int BoundingVolumeHierarchy::numBoxes() const
+{
+    return static_cast<unsigned int>(m_boxes.size());
+}
+
+unsigned int BoundingVolumeHierarchy::numNodes() const
+{
+    return static_cast<unsigned int>(m_nodes.size());
+}
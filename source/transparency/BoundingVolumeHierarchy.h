@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "BoundingBox.h"
+
+
+class Frustum;
+
+/**
+ *  @brief
+ *    Binary AABB tree over a set of boxes, e.g., the clusters of a scene
+ *
+ *  @remarks
+ *    Nodes are split at the centroid median along their largest extent.
+ *    Subtrees entirely inside the frustum are accepted without testing their leaves.
+ */
+class BoundingVolumeHierarchy
+{
+public:
+    static const unsigned int s_maxLeafSize = 4u;
+
+public:
+    /** Empty boxes are never visible */
+    void build(const std::vector<BoundingBox> & boxes);
+
+    /**
+     *  @param visible
+     *    Resized to the number of boxes, receives whether each box intersects the frustum
+     *  @return
+     *    Number of visible boxes
+     */
+    unsigned int cull(const Frustum & frustum, std::vector<bool> & visible) const;
+
+    unsigned int numBoxes() const;
+    unsigned int numNodes() const;
+
+protected:
+    struct Node
+    {
+        BoundingBox bounds;
+        uint32_t first;  ///< first item of leaves, right child of inner nodes, the left child follows its parent
+        uint32_t count;  ///< number of items, zero for inner nodes
+    };
+
+protected:
+    uint32_t build(uint32_t first, uint32_t count);
+
+    unsigned int accept(uint32_t node, std::vector<bool> & visible) const;
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_items;
+    std::vector<BoundingBox> m_boxes;
+};
@@ -0,0 +1,44 @@
+#include "CacheFile.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+
+uint64_t CacheFile::checksum(const void * data, std::size_t size)
+{
+    auto hash = uint64_t{14695981039346656037ull};
+    const auto bytes = static_cast<const unsigned char *>(data);
+
+    for (auto i = std::size_t{0}; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void CacheFile::makeDirectory(const std::string & directory)
+{
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+bool CacheFile::replace(const std::string & temporary, const std::string & filename)
+{
+    std::remove(filename.c_str());
+
+    if (std::rename(temporary.c_str(), filename.c_str()) == 0)
+        return true;
+
+    std::remove(temporary.c_str());
+    return false;
+}
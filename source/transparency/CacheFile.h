@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ *  @brief
+ *    Helpers shared by the on-disk caches
+ */
+class CacheFile
+{
+public:
+    /** 64-bit FNV-1a */
+    static uint64_t checksum(const void * data, std::size_t size);
+
+    /** Creates directory if it does not exist; parent directories have to exist */
+    static void makeDirectory(const std::string & directory);
+
+    /**
+     *  @brief
+     *    Replaces filename by temporary
+     *
+     *  @remarks
+     *    Caches write to a temporary file first, so that readers never map a partially written file.
+     */
+    static bool replace(const std::string & temporary, const std::string & filename);
+};
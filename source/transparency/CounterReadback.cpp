@@ -0,0 +1,64 @@
+#include "CounterReadback.h"
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+
+using namespace gl;
+
+CounterReadback::CounterReadback()
+:   m_current(0u)
+{
+    for (auto & buffer : m_buffers)
+    {
+        buffer = new globjects::Buffer{};
+        buffer->setData(sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+}
+
+CounterReadback::~CounterReadback() = default;
+
+void CounterReadback::copy(globjects::Buffer * buffer, GLintptr offset)
+{
+    m_current = 1u - m_current;
+
+    buffer->copySubData(m_buffers[m_current], offset, 0, sizeof(GLuint));
+    m_fences[m_current] = globjects::Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+}
+
+bool CounterReadback::read(GLuint & value)
+{
+    // Newest copy first, commands complete in order so older copies are superseded by it
+    for (auto i = 0u; i < m_buffers.size(); ++i)
+    {
+        const auto index = (m_current + i) % m_buffers.size();
+        const auto & fence = m_fences[index];
+
+        if (!fence)
+            continue;
+
+        const auto status = fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0u);
+
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        m_buffers[index]->getSubData(0, sizeof(value), &value);
+
+        // Newer copies stay in flight and are returned by a later call
+        for (auto j = i; j < m_buffers.size(); ++j)
+            m_fences[(m_current + j) % m_buffers.size()] = nullptr;
+
+        return true;
+    }
+
+    return false;
+}
+
+void CounterReadback::discard()
+{
+    for (auto & fence : m_fences)
+        fence = nullptr;
+}
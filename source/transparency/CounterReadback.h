@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/ref_ptr.h>
+
+
+namespace globjects
+{
+    class Buffer;
+    class Sync;
+}
+
+/**
+ *  @brief
+ *    Reads back a counter written by the GPU without waiting for it
+ *
+ *  @remarks
+ *    Copies are double buffered and fenced, read() returns the newest copy that has arrived,
+ *    which usually lags one or two frames behind. Requires a current context.
+ */
+class CounterReadback
+{
+public:
+    CounterReadback();
+    ~CounterReadback();
+
+    /** Copies the GLuint at offset of buffer, writes to buffer have to be made visible with GL_BUFFER_UPDATE_BARRIER_BIT */
+    void copy(globjects::Buffer * buffer, gl::GLintptr offset = 0);
+
+    /** Returns false if no copy has arrived since the last call */
+    bool read(gl::GLuint & value);
+
+    /** Drops copies still in flight, e.g., after the counted resource changed */
+    void discard();
+
+private:
+    std::array<globjects::ref_ptr<globjects::Buffer>, 2u> m_buffers;
+    std::array<globjects::ref_ptr<globjects::Sync>, 2u> m_fences;
+    unsigned int m_current;
+};
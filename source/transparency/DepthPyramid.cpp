@@ -0,0 +1,110 @@
+#include "DepthPyramid.h"
+
+#include <algorithm>
+
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/Texture.h>
+
+
+using namespace gl;
+
+namespace
+{
+
+const auto kLocalSize = 8;
+
+GLuint numGroups(int size)
+{
+    return static_cast<GLuint>((size + kLocalSize - 1) / kLocalSize);
+}
+
+}
+
+DepthPyramid::DepthPyramid()
+:   m_size{0}
+,   m_numLevels{0}
+{
+    m_initProgram = new globjects::Program{};
+    m_initProgram->attach(globjects::Shader::fromFile(GL_COMPUTE_SHADER, "data/transparency/depth_pyramid_init.comp"));
+
+    m_reduceProgram = new globjects::Program{};
+    m_reduceProgram->attach(globjects::Shader::fromFile(GL_COMPUTE_SHADER, "data/transparency/depth_pyramid.comp"));
+}
+
+DepthPyramid::~DepthPyramid() = default;
+
+void DepthPyramid::resize(const glm::ivec2 & size)
+{
+    m_size = size;
+    m_numLevels = 1;
+
+    for (auto extent = std::max(size.x, size.y); extent > 1; extent /= 2)
+        ++m_numLevels;
+
+    m_texture = new globjects::Texture{GL_TEXTURE_2D};
+    m_texture->setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    m_texture->setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    m_texture->setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    m_texture->setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_texture->storage2D(m_numLevels, GL_R32F, size.x, size.y);
+}
+
+void DepthPyramid::update(globjects::Texture * depth, const glm::ivec2 & size, int numSamples)
+{
+    if (size != m_size)
+        resize(size);
+
+    depth->bindActive(GL_TEXTURE0);
+    m_texture->bindImageTexture(0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+    m_initProgram->setUniform("depthTexture", 0);
+    m_initProgram->setUniform("numSamples", numSamples);
+    m_initProgram->setUniform("size", m_size);
+
+    m_initProgram->use();
+    m_initProgram->dispatchCompute(numGroups(m_size.x), numGroups(m_size.y), 1u);
+    m_initProgram->release();
+
+    auto levelSize = m_size;
+
+    m_reduceProgram->use();
+
+    for (auto level = 1; level < m_numLevels; ++level)
+    {
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        const auto sourceSize = levelSize;
+        levelSize = glm::max(levelSize / 2, glm::ivec2{1});
+
+        m_texture->bindImageTexture(0, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        m_texture->bindImageTexture(1, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        m_reduceProgram->setUniform("sourceSize", sourceSize);
+        m_reduceProgram->setUniform("size", levelSize);
+        m_reduceProgram->dispatchCompute(numGroups(levelSize.x), numGroups(levelSize.y), 1u);
+    }
+
+    m_reduceProgram->release();
+
+    // Culling samples the pyramid through a texture unit
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    globjects::Texture::unbindImageTexture(0);
+    globjects::Texture::unbindImageTexture(1);
+}
+
+globjects::Texture * DepthPyramid::texture() const
+{
+    return m_texture;
+}
+
+const glm::ivec2 & DepthPyramid::size() const
+{
+    return m_size;
+}
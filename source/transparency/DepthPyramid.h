@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <globjects/base/ref_ptr.h>
+
+
+namespace globjects
+{
+    class Program;
+    class Texture;
+}
+
+/**
+ *  @brief
+ *    Hierarchical depth buffer for occlusion culling
+ *
+ *  @remarks
+ *    Each texel of a level stores the farthest depth of the texels it covers on the level below.
+ *    Level 0 is built from a multisampled depth texture, taking the farthest sample of each pixel.
+ */
+class DepthPyramid
+{
+public:
+    DepthPyramid();
+    ~DepthPyramid();
+
+    /** Rebuilds all levels from depth, reallocates if size changed */
+    void update(globjects::Texture * depth, const glm::ivec2 & size, int numSamples);
+
+    globjects::Texture * texture() const;
+    const glm::ivec2 & size() const;
+
+protected:
+    void resize(const glm::ivec2 & size);
+
+private:
+    globjects::ref_ptr<globjects::Program> m_initProgram;
+    globjects::ref_ptr<globjects::Program> m_reduceProgram;
+    globjects::ref_ptr<globjects::Texture> m_texture;
+
+    glm::ivec2 m_size;
+    int m_numLevels;
+};
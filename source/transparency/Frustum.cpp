@@ -0,0 +1,55 @@
+#include "Frustum.h"
+
+#include "BoundingBox.h"
+
+
+Frustum::Frustum(const glm::mat4 & viewProjection)
+{
+    // Gribb and Hartmann, clip space is -w <= x, y, z <= w
+    const auto row = [&viewProjection] (int i)
+    {
+        return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+    };
+
+    m_planes[0] = row(3) + row(0);
+    m_planes[1] = row(3) - row(0);
+    m_planes[2] = row(3) + row(1);
+    m_planes[3] = row(3) - row(1);
+    m_planes[4] = row(3) + row(2);
+    m_planes[5] = row(3) - row(2);
+
+    for (auto & plane : m_planes)
+        plane = plane / glm::length(glm::vec3{plane});
+}
+
+Frustum::Intersection Frustum::test(const BoundingBox & box) const
+{
+    auto result = Intersection::Inside;
+
+    for (const auto & plane : m_planes)
+    {
+        // Corners farthest along and against the plane normal
+        const auto positive = glm::vec3{
+            plane.x >= 0.0f ? box.max().x : box.min().x,
+            plane.y >= 0.0f ? box.max().y : box.min().y,
+            plane.z >= 0.0f ? box.max().z : box.min().z };
+
+        const auto negative = glm::vec3{
+            plane.x >= 0.0f ? box.min().x : box.max().x,
+            plane.y >= 0.0f ? box.min().y : box.max().y,
+            plane.z >= 0.0f ? box.min().z : box.max().z };
+
+        if (glm::dot(glm::vec3{plane}, positive) + plane.w < 0.0f)
+            return Intersection::Outside;
+
+        if (glm::dot(glm::vec3{plane}, negative) + plane.w < 0.0f)
+            result = Intersection::Intersecting;
+    }
+
+    return result;
+}
+
+const std::array<glm::vec4, 6> & Frustum::planes() const
+{
+    return m_planes;
+}
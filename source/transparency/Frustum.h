@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+
+class BoundingBox;
+
+/**
+ *  @brief
+ *    View frustum as six planes extracted from a view projection matrix
+ *
+ *  @remarks
+ *    Plane normals point inwards and have unit length, i.e., planes yield signed distances.
+ */
+class Frustum
+{
+public:
+    enum class Intersection
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+public:
+    Frustum(const glm::mat4 & viewProjection);
+
+    /** Conservative, boxes near frustum corners may be classified as intersecting */
+    Intersection test(const BoundingBox & box) const;
+
+    const std::array<glm::vec4, 6> & planes() const;
+
+private:
+    std::array<glm::vec4, 6> m_planes;
+};
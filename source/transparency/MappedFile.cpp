@@ -0,0 +1,106 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string & filename)
+:   m_data{nullptr}
+,   m_size{0u}
+,   m_file{INVALID_HANDLE_VALUE}
+,   m_mapping{nullptr}
+{
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE)
+        return;
+
+    auto size = LARGE_INTEGER{};
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        return;
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (m_mapping == nullptr)
+        return;
+
+    m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (m_data != nullptr)
+        m_size = static_cast<std::size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string & filename)
+:   m_data{nullptr}
+,   m_size{0u}
+,   m_file{-1}
+{
+    m_file = open(filename.c_str(), O_RDONLY);
+
+    if (m_file == -1)
+        return;
+
+    struct stat status;
+    if (fstat(m_file, &status) != 0 || status.st_size == 0)
+        return;
+
+    const auto size = static_cast<std::size_t>(status.st_size);
+    const auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, m_file, 0);
+
+    if (data == MAP_FAILED)
+        return;
+
+    m_data = static_cast<const char *>(data);
+    m_size = size;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+        munmap(const_cast<char *>(m_data), m_size);
+
+    if (m_file != -1)
+        close(m_file);
+}
+
+#endif
+
+bool MappedFile::isValid() const
+{
+    return m_data != nullptr;
+}
+
+const char * MappedFile::data() const
+{
+    return m_data;
+}
+
+std::size_t MappedFile::size() const
+{
+    return m_size;
+}
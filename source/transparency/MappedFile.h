@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ *  @brief
+ *    Read-only memory mapping of a whole file
+ *
+ *  @remarks
+ *    The mapping is released on destruction. Check isValid() before accessing data().
+ */
+class MappedFile
+{
+public:
+    MappedFile(const std::string & filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    bool isValid() const;
+
+    const char * data() const;
+    std::size_t size() const;
+
+private:
+    const char * m_data;
+    std::size_t m_size;
+
+#ifdef _WIN32
+    void * m_file;
+    void * m_mapping;
+#else
+    int m_file;
+#endif
+};
@@ -0,0 +1,180 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <assimp/scene.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "AssimpLoader.h"
+#include "AssimpProcessing.h"
+#include "BinaryMesh.h"
+#include "CacheFile.h"
+#include "MeshOptimizer.h"
+#include "ParallelFor.h"
+#include "PlyLoader.h"
+#include "PolygonalGeometry.h"
+
+
+MeshCache::MeshCache(const std::string & directory, bool optimize)
+:   m_directory{directory}
+,   m_optimize{optimize}
+{
+}
+
+MeshCache::~MeshCache() = default;
+
+std::unique_ptr<BinaryMesh> MeshCache::load(
+    const std::string & filename,
+    std::function<void(int, int)> progress) const
+{
+    struct stat status;
+    if (stat(filename.c_str(), &status) != 0)
+    {
+        std::cout << "Could not find file " << filename << std::endl;
+        return nullptr;
+    }
+
+    const auto sourceSize = static_cast<uint64_t>(status.st_size);
+    const auto sourceTime = static_cast<uint64_t>(status.st_mtime);
+
+    const auto cached = cacheFilename(filename);
+    auto mesh = widgetzeug::make_unique<BinaryMesh>(cached);
+
+    if (mesh->isValid() && mesh->sourceSize() == sourceSize && mesh->sourceTime() == sourceTime)
+        return mesh;
+
+    mesh.reset();
+
+    auto geometries = std::vector<PolygonalGeometry>{};
+
+    if (!import(filename, progress, geometries))
+        return nullptr;
+
+    if (m_optimize)
+        optimize(filename, geometries);
+
+    auto data = BinaryMesh::serialize(geometries, sourceSize, sourceTime);
+
+    CacheFile::makeDirectory(m_directory);
+
+    if (!BinaryMesh::write(cached, data))
+        std::cout << "Could not write mesh cache " << cached << std::endl;
+
+    return widgetzeug::make_unique<BinaryMesh>(std::move(data));
+}
+
+std::string MeshCache::cacheFilename(const std::string & filename) const
+{
+    // Hash of the path keeps equally named files in different directories apart
+    const auto separator = filename.find_last_of("/\\");
+    const auto basename = separator == std::string::npos ? filename : filename.substr(separator + 1);
+    const auto hash = CacheFile::checksum(filename.data(), filename.size());
+
+    std::stringstream stream;
+    stream << m_directory << "/" << basename << "." << std::hex << std::setw(16) << std::setfill('0') << hash << (m_optimize ? ".optimized" : "") << ".mesh";
+
+    return stream.str();
+}
+
+bool MeshCache::import(
+    const std::string & filename,
+    std::function<void(int, int)> progress,
+    std::vector<PolygonalGeometry> & geometries) const
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto report = [&filename, &start] (const char * loader)
+    {
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Imported " << filename << " with " << loader << " in " << elapsed << " ms" << std::endl;
+    };
+
+    const auto separator = filename.find_last_of('.');
+    const auto extension = separator == std::string::npos ? std::string{} : filename.substr(separator);
+
+    const auto plyLoader = PlyLoader{};
+
+    if (plyLoader.canLoad(extension))
+    {
+        const auto geometry = plyLoader.load(filename, progress);
+
+        if (geometry)
+        {
+            geometries.push_back(std::move(*geometry));
+            delete geometry;
+
+            report("PlyLoader");
+            return true;
+        }
+
+        // Files PlyLoader rejects are given to Assimp, which may still be able to read them
+    }
+
+    const auto scene = AssimpLoader{}.load(filename, progress);
+
+    if (!scene)
+        return false;
+
+    geometries = AssimpProcessing::convertToGeometries(scene);
+    delete scene;
+
+    report("Assimp");
+    return true;
+}
+
+void MeshCache::optimize(const std::string & filename, std::vector<PolygonalGeometry> & geometries) const
+{
+    const auto numMeshes = static_cast<unsigned int>(geometries.size());
+
+    auto before = std::vector<MeshOptimizer::Statistics>(numMeshes);
+    auto after = std::vector<MeshOptimizer::Statistics>(numMeshes);
+
+    std::atomic<unsigned int> next{0u};
+
+    parallelFor(numMeshes, [&geometries, &before, &after, &next, numMeshes](unsigned int, unsigned int)
+    {
+        for (auto i = next++; i < numMeshes; i = next++)
+        {
+            before[i] = MeshOptimizer::analyze(geometries[i]);
+            MeshOptimizer::optimize(geometries[i]);
+            after[i] = MeshOptimizer::analyze(geometries[i]);
+        }
+    });
+
+    // Report averages weighted by triangle count
+    auto numTriangles = std::size_t{0u};
+    for (const auto & geometry : geometries)
+        numTriangles += geometry.indices().size() / 3u;
+
+    const auto total = [&geometries, numTriangles](const std::vector<MeshOptimizer::Statistics> & statistics)
+    {
+        auto sum = MeshOptimizer::Statistics{ 0.0f, 0.0f, 0.0f };
+
+        for (auto i = 0u; i < statistics.size(); ++i)
+        {
+            const auto weight = static_cast<float>(geometries[i].indices().size() / 3u) / std::max(numTriangles, std::size_t{1u});
+
+            sum.acmr += statistics[i].acmr * weight;
+            sum.atvr += statistics[i].atvr * weight;
+            sum.overdraw += statistics[i].overdraw * weight;
+        }
+
+        return sum;
+    };
+
+    const auto totalBefore = total(before);
+    const auto totalAfter = total(after);
+
+    std::cout << "Optimized " << filename << " (" << numTriangles << " triangles):" << std::endl
+        << "  ACMR " << totalBefore.acmr << " -> " << totalAfter.acmr << std::endl
+        << "  ATVR " << totalBefore.atvr << " -> " << totalAfter.atvr << std::endl
+        << "  overdraw " << totalBefore.overdraw << " -> " << totalAfter.overdraw << std::endl;
+}
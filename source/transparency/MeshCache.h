@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class BinaryMesh;
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Imports scenes once and serves them as memory-mapped BinaryMesh afterwards
+ *
+ *  @remarks
+ *    PLY files are read by PlyLoader, everything else and PLY files it rejects go through Assimp.
+ *    A cached file is reused as long as size and modification time of its source match.
+ *    Optimized and unoptimized meshes are cached separately.
+ */
+class MeshCache
+{
+public:
+    /**
+     *  @param optimize
+     *    Run MeshOptimizer on imported meshes and report its statistics
+     */
+    MeshCache(const std::string & directory, bool optimize = false);
+    ~MeshCache();
+
+    /**
+     *  @param progress
+     *    Forwarded to the loader if the file has to be imported, may be empty
+     *
+     *  @return
+     *    Meshes of filename, nullptr if the file could neither be loaded from cache nor imported
+     */
+    std::unique_ptr<BinaryMesh> load(
+        const std::string & filename,
+        std::function<void(int, int)> progress = nullptr) const;
+
+protected:
+    std::string cacheFilename(const std::string & filename) const;
+
+    /** Prints the loader used and the time spent, including conversion to PolygonalGeometry and rejected PLY attempts */
+    bool import(
+        const std::string & filename,
+        std::function<void(int, int)> progress,
+        std::vector<PolygonalGeometry> & geometries) const;
+
+    void optimize(const std::string & filename, std::vector<PolygonalGeometry> & geometries) const;
+
+private:
+    const std::string m_directory;
+    const bool m_optimize;
+};
@@ -0,0 +1,520 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <glm/glm.hpp>
+
+#include "PolygonalGeometry.h"
+
+
+namespace
+{
+
+/**
+ *  Simulates a FIFO cache through per vertex time stamps: a vertex is cached
+ *  as long as fewer than s_cacheSize vertices have been transformed since it.
+ */
+class CacheSimulation
+{
+public:
+    CacheSimulation(unsigned int numVertices)
+    :   m_times(numVertices, 0u)
+    ,   m_time(MeshOptimizer::s_cacheSize + 1u)
+    {
+    }
+
+    bool isCached(unsigned int vertex) const
+    {
+        return m_time - m_times[vertex] <= MeshOptimizer::s_cacheSize;
+    }
+
+    unsigned int age(unsigned int vertex) const
+    {
+        return m_time - m_times[vertex];
+    }
+
+    /** @return true on a cache miss */
+    bool transform(unsigned int vertex)
+    {
+        if (isCached(vertex))
+            return false;
+
+        m_times[vertex] = m_time++;
+        return true;
+    }
+
+    unsigned int transform(const unsigned int * triangle)
+    {
+        return transform(triangle[0]) + transform(triangle[1]) + transform(triangle[2]);
+    }
+
+    void flush()
+    {
+        m_time += MeshOptimizer::s_cacheSize + 1u;
+    }
+
+private:
+    std::vector<unsigned int> m_times;
+    unsigned int m_time;
+};
+
+/** Vertex to triangle adjacency in compressed row storage */
+struct Adjacency
+{
+    Adjacency(const std::vector<unsigned int> & indices, unsigned int numVertices)
+    :   offsets(numVertices + 1u, 0u)
+    ,   triangles(indices.size())
+    {
+        for (auto index : indices)
+            ++offsets[index + 1u];
+
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        auto fill = std::vector<unsigned int>(offsets.begin(), offsets.end() - 1);
+
+        for (auto i = 0u; i < indices.size(); ++i)
+            triangles[fill[indices[i]]++] = i / 3u;
+    }
+
+    unsigned int count(unsigned int vertex) const
+    {
+        return offsets[vertex + 1u] - offsets[vertex];
+    }
+
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> triangles;
+};
+
+int skipDeadEnd(
+    const std::vector<unsigned int> & live,
+    std::vector<unsigned int> & deadEnds,
+    unsigned int & cursor)
+{
+    while (!deadEnds.empty())
+    {
+        const auto vertex = deadEnds.back();
+        deadEnds.pop_back();
+
+        if (live[vertex] > 0u)
+            return static_cast<int>(vertex);
+    }
+
+    for (; cursor < live.size(); ++cursor)
+    {
+        if (live[cursor] > 0u)
+            return static_cast<int>(cursor);
+    }
+
+    return -1;
+}
+
+struct RasterStatistics
+{
+    unsigned int covered;
+    unsigned int shaded;
+};
+
+RasterStatistics rasterize(
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & positions,
+    unsigned int resolution)
+{
+    auto depths = std::vector<float>(resolution * resolution, std::numeric_limits<float>::max());
+    auto statistics = RasterStatistics{ 0u, 0u };
+
+    const auto edge = [](const glm::vec3 & a, const glm::vec3 & b, float x, float y)
+    {
+        return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    };
+
+    for (auto i = 0u; i + 2u < indices.size(); i += 3u)
+    {
+        const auto & v0 = positions[indices[i]];
+        const auto & v1 = positions[indices[i + 1u]];
+        const auto & v2 = positions[indices[i + 2u]];
+
+        const auto area = edge(v0, v1, v2.x, v2.y);
+
+        if (area == 0.0f)
+            continue;
+
+        const auto minimum = glm::min(v0, glm::min(v1, v2));
+        const auto maximum = glm::max(v0, glm::max(v1, v2));
+
+        const auto x0 = static_cast<unsigned int>(std::max(minimum.x, 0.0f));
+        const auto y0 = static_cast<unsigned int>(std::max(minimum.y, 0.0f));
+        const auto x1 = std::min(static_cast<unsigned int>(maximum.x + 1.0f), resolution);
+        const auto y1 = std::min(static_cast<unsigned int>(maximum.y + 1.0f), resolution);
+
+        for (auto y = y0; y < y1; ++y)
+        {
+            for (auto x = x0; x < x1; ++x)
+            {
+                const auto px = x + 0.5f;
+                const auto py = y + 0.5f;
+
+                const auto w0 = edge(v1, v2, px, py) / area;
+                const auto w1 = edge(v2, v0, px, py) / area;
+                const auto w2 = edge(v0, v1, px, py) / area;
+
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                    continue;
+
+                const auto depth = w0 * v0.z + w1 * v1.z + w2 * v2.z;
+                auto & stored = depths[y * resolution + x];
+
+                if (depth >= stored)
+                    continue;
+
+                if (stored == std::numeric_limits<float>::max())
+                    ++statistics.covered;
+
+                stored = depth;
+                ++statistics.shaded;
+            }
+        }
+    }
+
+    return statistics;
+}
+
+}
+
+const float MeshOptimizer::s_overdrawThreshold = 1.05f;
+
+void MeshOptimizer::optimize(PolygonalGeometry & geometry)
+{
+    if (geometry.indices().empty() || geometry.indices().size() % 3u != 0u)
+        return;
+
+    const auto numVertices = static_cast<unsigned int>(geometry.vertices().size());
+
+    auto clusters = std::vector<unsigned int>{};
+    const auto indices = optimizeVertexCache(geometry.indices(), numVertices, clusters);
+
+    geometry.setIndices(optimizeOverdraw(indices, geometry.vertices(), clusters));
+
+    optimizeVertexFetch(geometry);
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexCache(
+    const std::vector<unsigned int> & indices,
+    unsigned int numVertices,
+    std::vector<unsigned int> & clusters)
+{
+    const auto adjacency = Adjacency{indices, numVertices};
+
+    auto live = std::vector<unsigned int>(numVertices);
+    for (auto i = 0u; i < numVertices; ++i)
+        live[i] = adjacency.count(i);
+
+    auto emitted = std::vector<bool>(indices.size() / 3u, false);
+    auto cache = CacheSimulation{numVertices};
+    auto deadEnds = std::vector<unsigned int>{};
+    auto candidates = std::vector<unsigned int>{};
+    auto cursor = 0u;
+
+    auto result = std::vector<unsigned int>{};
+    result.reserve(indices.size());
+
+    clusters.clear();
+
+    if (indices.empty())
+        return result;
+
+    clusters.push_back(0u);
+
+    auto fanning = static_cast<int>(indices.front());
+
+    while (fanning >= 0)
+    {
+        candidates.clear();
+
+        // Emit all remaining triangles around the fanning vertex
+        for (auto i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i)
+        {
+            const auto triangle = adjacency.triangles[i];
+
+            if (emitted[triangle])
+                continue;
+
+            for (auto j = 0u; j < 3u; ++j)
+            {
+                const auto vertex = indices[triangle * 3u + j];
+
+                result.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+
+                --live[vertex];
+                cache.transform(vertex);
+            }
+
+            emitted[triangle] = true;
+        }
+
+        // Prefer the oldest candidate that stays in cache while its remaining triangles are emitted
+        auto next = -1;
+        auto bestPriority = -1;
+
+        for (auto vertex : candidates)
+        {
+            if (live[vertex] == 0u)
+                continue;
+
+            auto priority = 0;
+
+            if (cache.age(vertex) + 2u * live[vertex] <= s_cacheSize)
+                priority = static_cast<int>(cache.age(vertex));
+
+            if (priority > bestPriority)
+            {
+                next = static_cast<int>(vertex);
+                bestPriority = priority;
+            }
+        }
+
+        if (next < 0)
+        {
+            next = skipDeadEnd(live, deadEnds, cursor);
+
+            if (next >= 0)
+                clusters.push_back(static_cast<unsigned int>(result.size() / 3u));
+        }
+
+        fanning = next;
+    }
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeOverdraw(
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices,
+    const std::vector<unsigned int> & clusters,
+    float threshold)
+{
+    const auto numTriangles = static_cast<unsigned int>(indices.size() / 3u);
+
+    // Add soft boundaries wherever the cache miss ratio so far is close enough to the cluster's
+    auto cache = CacheSimulation{static_cast<unsigned int>(vertices.size())};
+    auto boundaries = std::vector<unsigned int>{};
+
+    for (auto c = 0u; c < clusters.size(); ++c)
+    {
+        const auto begin = clusters[c];
+        const auto end = c + 1u < clusters.size() ? clusters[c + 1u] : numTriangles;
+
+        cache.flush();
+
+        auto clusterMisses = 0u;
+        for (auto t = begin; t < end; ++t)
+            clusterMisses += cache.transform(&indices[t * 3u]);
+
+        const auto maxRatio = threshold * clusterMisses / (end - begin);
+
+        cache.flush();
+        boundaries.push_back(begin);
+
+        auto runBegin = begin;
+        auto runMisses = 0u;
+
+        for (auto t = begin; t + 1u < end; ++t)
+        {
+            runMisses += cache.transform(&indices[t * 3u]);
+
+            if (runMisses > maxRatio * (t + 1u - runBegin))
+                continue;
+
+            boundaries.push_back(t + 1u);
+            runBegin = t + 1u;
+            runMisses = 0u;
+
+            cache.flush();
+        }
+    }
+
+    // Sort clusters front to back as seen from outside, i.e., by signed distance of their centroid along their normal
+    auto meshCentroid = glm::vec3{0.0f};
+    for (const auto & vertex : vertices)
+        meshCentroid += vertex;
+    meshCentroid = meshCentroid / static_cast<float>(std::max(vertices.size(), std::size_t{1u}));
+
+    auto sortKeys = std::vector<float>(boundaries.size());
+
+    for (auto c = 0u; c < boundaries.size(); ++c)
+    {
+        const auto begin = boundaries[c];
+        const auto end = c + 1u < boundaries.size() ? boundaries[c + 1u] : numTriangles;
+
+        auto centroid = glm::vec3{0.0f};
+        auto normal = glm::vec3{0.0f};
+        auto area = 0.0f;
+
+        for (auto t = begin; t < end; ++t)
+        {
+            const auto & v0 = vertices[indices[t * 3u]];
+            const auto & v1 = vertices[indices[t * 3u + 1u]];
+            const auto & v2 = vertices[indices[t * 3u + 2u]];
+
+            const auto weightedNormal = glm::cross(v1 - v0, v2 - v0);
+            const auto triangleArea = glm::length(weightedNormal);
+
+            centroid += (v0 + v1 + v2) * (triangleArea / 3.0f);
+            normal += weightedNormal;
+            area += triangleArea;
+        }
+
+        const auto normalLength = glm::length(normal);
+
+        sortKeys[c] = area > 0.0f && normalLength > 0.0f
+            ? glm::dot(centroid / area - meshCentroid, normal / normalLength)
+            : 0.0f;
+    }
+
+    auto order = std::vector<unsigned int>(boundaries.size());
+    std::iota(order.begin(), order.end(), 0u);
+
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](unsigned int a, unsigned int b)
+    {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    auto result = std::vector<unsigned int>{};
+    result.reserve(indices.size());
+
+    for (auto c : order)
+    {
+        const auto begin = boundaries[c];
+        const auto end = c + 1u < boundaries.size() ? boundaries[c + 1u] : numTriangles;
+
+        result.insert(result.end(), indices.begin() + begin * 3u, indices.begin() + end * 3u);
+    }
+
+    return result;
+}
+
+void MeshOptimizer::optimizeVertexFetch(PolygonalGeometry & geometry)
+{
+    static const auto unused = std::numeric_limits<unsigned int>::max();
+
+    const auto & vertices = geometry.vertices();
+    const auto & normals = geometry.normals();
+
+    auto remap = std::vector<unsigned int>(vertices.size(), unused);
+    auto indices = geometry.indices();
+    auto numVertices = 0u;
+
+    for (auto & index : indices)
+    {
+        if (remap[index] == unused)
+            remap[index] = numVertices++;
+
+        index = remap[index];
+    }
+
+    auto newVertices = std::vector<glm::vec3>(numVertices);
+    auto newNormals = std::vector<glm::vec3>(geometry.hasNormals() ? numVertices : 0u);
+
+    for (auto i = 0u; i < remap.size(); ++i)
+    {
+        if (remap[i] == unused)
+            continue;
+
+        newVertices[remap[i]] = vertices[i];
+
+        if (geometry.hasNormals())
+            newNormals[remap[i]] = normals[i];
+    }
+
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(newVertices));
+    geometry.setNormals(std::move(newNormals));
+}
+
+MeshOptimizer::Statistics MeshOptimizer::analyze(const PolygonalGeometry & geometry)
+{
+    const auto & indices = geometry.indices();
+    const auto numVertices = static_cast<unsigned int>(geometry.vertices().size());
+
+    auto referenced = std::vector<bool>(numVertices, false);
+    for (auto index : indices)
+        referenced[index] = true;
+
+    const auto numReferenced = std::count(referenced.begin(), referenced.end(), true);
+    const auto acmr = averageCacheMissRatio(indices, numVertices);
+
+    auto statistics = Statistics{};
+    statistics.acmr = acmr;
+    statistics.atvr = numReferenced > 0 ? acmr * (indices.size() / 3u) / numReferenced : 0.0f;
+    statistics.overdraw = overdraw(indices, geometry.vertices());
+
+    return statistics;
+}
+
+float MeshOptimizer::averageCacheMissRatio(const std::vector<unsigned int> & indices, unsigned int numVertices)
+{
+    const auto numTriangles = indices.size() / 3u;
+
+    if (numTriangles == 0u)
+        return 0.0f;
+
+    auto cache = CacheSimulation{numVertices};
+    auto misses = 0u;
+
+    for (auto t = 0u; t < numTriangles; ++t)
+        misses += cache.transform(&indices[t * 3u]);
+
+    return static_cast<float>(misses) / numTriangles;
+}
+
+float MeshOptimizer::overdraw(const std::vector<unsigned int> & indices, const std::vector<glm::vec3> & vertices)
+{
+    static const auto resolution = 256u;
+
+    if (vertices.empty())
+        return 0.0f;
+
+    auto minimum = vertices.front();
+    auto maximum = vertices.front();
+
+    for (const auto & vertex : vertices)
+    {
+        minimum = glm::min(minimum, vertex);
+        maximum = glm::max(maximum, vertex);
+    }
+
+    const auto extent = maximum - minimum;
+    const auto scale = 1.0f / std::max(std::max(extent.x, extent.y), std::max(extent.z, std::numeric_limits<float>::min()));
+
+    auto covered = 0u;
+    auto shaded = 0u;
+    auto positions = std::vector<glm::vec3>(vertices.size());
+
+    // Render along both directions of each axis with x, y in pixels and z as depth
+    for (auto axis = 0u; axis < 3u; ++axis)
+    {
+        for (auto direction = 0u; direction < 2u; ++direction)
+        {
+            for (auto i = 0u; i < vertices.size(); ++i)
+            {
+                const auto normalized = (vertices[i] - minimum) * scale;
+
+                const auto x = normalized[(axis + 1u) % 3u];
+                const auto y = normalized[(axis + 2u) % 3u];
+                const auto z = normalized[axis];
+
+                positions[i] = glm::vec3{x * resolution, y * resolution, direction == 0u ? z : 1.0f - z};
+            }
+
+            const auto statistics = rasterize(indices, positions, resolution);
+
+            covered += statistics.covered;
+            shaded += statistics.shaded;
+        }
+    }
+
+    return covered > 0u ? static_cast<float>(shaded) / covered : 0.0f;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/fwd.hpp>
+
+
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Reorders triangle meshes for post-transform vertex cache locality, low overdraw and vertex fetch locality
+ *
+ *  @remarks
+ *    Triangle order follows Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw":
+ *    Tipsify splits the mesh into clusters, which are then sorted to draw outward facing clusters first.
+ *    Meshes whose index count is not a multiple of three are left untouched.
+ */
+class MeshOptimizer
+{
+public:
+    /** Size of the simulated FIFO post-transform cache */
+    static const unsigned int s_cacheSize = 16u;
+
+    /** Clusters are split as long as their cache miss ratio stays within this factor of the unsplit cluster */
+    static const float s_overdrawThreshold;
+
+public:
+    struct Statistics
+    {
+        float acmr;     ///< average cache miss ratio, transformed vertices per triangle
+        float atvr;     ///< average transformed to vertex ratio, 1.0 is optimal
+        float overdraw; ///< shaded per covered pixel over six axis aligned views, without back-face culling
+    };
+
+public:
+    /** Runs optimizeVertexCache, optimizeOverdraw and optimizeVertexFetch */
+    static void optimize(PolygonalGeometry & geometry);
+
+    /**
+     *  @param clusters
+     *    Receives the first triangle of each cluster, i.e., wherever Tipsify had to skip to a new dead-end
+     */
+    static std::vector<unsigned int> optimizeVertexCache(
+        const std::vector<unsigned int> & indices,
+        unsigned int numVertices,
+        std::vector<unsigned int> & clusters);
+
+    /**
+     *  @param clusters
+     *    Hard cluster boundaries as returned by optimizeVertexCache
+     */
+    static std::vector<unsigned int> optimizeOverdraw(
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices,
+        const std::vector<unsigned int> & clusters,
+        float threshold = s_overdrawThreshold);
+
+    /** Orders vertices by first use and drops unreferenced ones */
+    static void optimizeVertexFetch(PolygonalGeometry & geometry);
+
+    static Statistics analyze(const PolygonalGeometry & geometry);
+
+    static float averageCacheMissRatio(const std::vector<unsigned int> & indices, unsigned int numVertices);
+    static float overdraw(const std::vector<unsigned int> & indices, const std::vector<glm::vec3> & vertices);
+};
@@ -0,0 +1,208 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "BoundingBox.h"
+#include "PolygonalGeometry.h"
+
+
+namespace
+{
+
+using Triangle = std::array<unsigned int, 3>;
+
+/** Rotates the smallest index to the front, keeping the winding */
+Triangle normalize(unsigned int a, unsigned int b, unsigned int c)
+{
+    if (b < a && b < c)
+        return {{ b, c, a }};
+
+    if (c < a && c < b)
+        return {{ c, a, b }};
+
+    return {{ a, b, c }};
+}
+
+}
+
+const float MeshSimplifier::s_minReduction = 0.6f;
+
+const unsigned int MeshSimplifier::s_maxLevels;
+const unsigned int MeshSimplifier::s_minTriangles;
+
+std::vector<MeshSimplifier::Level> MeshSimplifier::buildLevels(const PolygonalGeometry & geometry)
+{
+    const auto & indices = geometry.indices();
+    const auto & vertices = geometry.vertices();
+
+    auto levels = std::vector<Level>{};
+    levels.push_back(Level{ indices, 0.0f });
+
+    const auto numTriangles = indices.size() / 3u;
+
+    if (indices.size() % 3u != 0u || numTriangles < s_minTriangles)
+        return levels;
+
+    // A closed surface on a grid of resolution r covers in the order of r * r cells
+    auto resolution = 1u;
+
+    while (resolution * resolution < numTriangles / 2u)
+        resolution *= 2u;
+
+    for (; resolution >= 2u && levels.size() < s_maxLevels; resolution /= 2u)
+    {
+        const auto & previous = levels.back();
+
+        if (previous.indices.size() / 3u < s_minTriangles)
+            break;
+
+        auto error = 0.0f;
+        auto simplified = simplify(indices, vertices, resolution, error);
+
+        if (simplified.empty() || simplified.size() > previous.indices.size() * s_minReduction)
+            continue;
+
+        levels.push_back(Level{ std::move(simplified), std::max(error, previous.error) });
+    }
+
+    return levels;
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices,
+    unsigned int resolution,
+    float & error)
+{
+    error = 0.0f;
+
+    auto bounds = BoundingBox{};
+
+    for (const auto index : indices)
+        bounds.extend(vertices[index]);
+
+    const auto extent = bounds.extent();
+    const auto cellSize = std::max(extent.x, std::max(extent.y, extent.z)) / static_cast<float>(resolution);
+
+    if (cellSize <= 0.0f)
+        return indices;
+
+    const auto cellOf = [&bounds, cellSize, resolution] (const glm::vec3 & vertex)
+    {
+        const auto cell = (vertex - bounds.min()) / cellSize;
+        const auto clamp = [resolution] (float coordinate)
+        {
+            return static_cast<uint64_t>(std::min(static_cast<unsigned int>(coordinate), resolution - 1u));
+        };
+
+        return clamp(cell.x) | clamp(cell.y) << 21u | clamp(cell.z) << 42u;
+    };
+
+    // Representative of each cell is the referenced vertex closest to the mean of its vertices
+    auto cells = std::unordered_map<uint64_t, std::pair<glm::vec3, unsigned int>>{};
+    auto vertexCells = std::vector<uint64_t>(vertices.size(), ~uint64_t{0u});
+
+    for (const auto index : indices)
+    {
+        if (vertexCells[index] != ~uint64_t{0u})
+            continue;
+
+        vertexCells[index] = cellOf(vertices[index]);
+
+        auto & cell = cells.emplace(vertexCells[index], std::make_pair(glm::vec3{0.0f}, 0u)).first->second;
+        cell.first += vertices[index];
+        cell.second += 1u;
+    }
+
+    for (auto & cell : cells)
+        cell.second.first = cell.second.first / static_cast<float>(cell.second.second);
+
+    auto representatives = std::unordered_map<uint64_t, unsigned int>{};
+
+    for (auto index = 0u; index < vertices.size(); ++index)
+    {
+        if (vertexCells[index] == ~uint64_t{0u})
+            continue;
+
+        const auto & mean = cells[vertexCells[index]].first;
+        const auto inserted = representatives.insert({ vertexCells[index], index });
+
+        if (!inserted.second && glm::distance(vertices[index], mean) < glm::distance(vertices[inserted.first->second], mean))
+            inserted.first->second = index;
+    }
+
+    auto remap = std::vector<unsigned int>(vertices.size(), 0u);
+
+    for (auto index = 0u; index < vertices.size(); ++index)
+    {
+        if (vertexCells[index] == ~uint64_t{0u})
+            continue;
+
+        remap[index] = representatives[vertexCells[index]];
+        error = std::max(error, glm::distance(vertices[index], vertices[remap[index]]));
+    }
+
+    // Drops collapsed triangles and duplicates, keeping the order of the remaining ones
+    auto triangles = std::vector<std::pair<Triangle, unsigned int>>{};
+
+    for (auto i = 0u; i < indices.size(); i += 3u)
+    {
+        const auto a = remap[indices[i]], b = remap[indices[i + 1u]], c = remap[indices[i + 2u]];
+
+        if (a == b || b == c || c == a)
+            continue;
+
+        triangles.push_back({ normalize(a, b, c), i });
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+
+    triangles.erase(std::unique(triangles.begin(), triangles.end(),
+        [] (const std::pair<Triangle, unsigned int> & lhs, const std::pair<Triangle, unsigned int> & rhs)
+        {
+            return lhs.first == rhs.first;
+        }), triangles.end());
+
+    std::sort(triangles.begin(), triangles.end(),
+        [] (const std::pair<Triangle, unsigned int> & lhs, const std::pair<Triangle, unsigned int> & rhs)
+        {
+            return lhs.second < rhs.second;
+        });
+
+    auto simplified = std::vector<unsigned int>{};
+    simplified.reserve(triangles.size() * 3u);
+
+    for (const auto & triangle : triangles)
+        simplified.insert(simplified.end(), triangle.first.begin(), triangle.first.end());
+
+    return simplified;
+}
+
+unsigned int MeshSimplifier::selectLevel(
+    const std::vector<float> & errors,
+    float distance,
+    float projectionScale,
+    float maxPixelError)
+{
+    auto level = 0u;
+
+    // Within the bounds every level could be arbitrarily large on screen
+    if (distance <= 0.0f)
+        return level;
+
+    for (auto i = 1u; i < errors.size(); ++i)
+    {
+        if (errors[i] * projectionScale / distance > maxPixelError)
+            break;
+
+        level = i;
+    }
+
+    return level;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/fwd.hpp>
+
+
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Generates levels of detail for triangle meshes by vertex clustering
+ *
+ *  @remarks
+ *    Vertices are snapped to a representative vertex of their grid cell, so all levels share
+ *    the vertex buffer of the original mesh and only differ in their indices.
+ *    Each level is a grid of half the resolution of the one before. The error of a level bounds
+ *    the distance of any vertex to its representative, i.e., the geometric deviation in object space.
+ */
+class MeshSimplifier
+{
+public:
+    static const unsigned int s_maxLevels = 5u;
+
+    /** Levels are only generated if they reduce the number of triangles at least by this factor */
+    static const float s_minReduction;
+
+    /** Meshes with fewer triangles are not simplified further */
+    static const unsigned int s_minTriangles = 64u;
+
+public:
+    struct Level
+    {
+        std::vector<unsigned int> indices;
+        float error;
+    };
+
+public:
+    /** Level 0 is the original mesh with zero error, errors increase monotonically */
+    static std::vector<Level> buildLevels(const PolygonalGeometry & geometry);
+
+    /**
+     *  @param resolution
+     *    Number of cells along the largest extent of the mesh
+     *  @param error
+     *    Receives the maximum distance of a vertex to its representative
+     */
+    static std::vector<unsigned int> simplify(
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices,
+        unsigned int resolution,
+        float & error);
+
+    /**
+     *  @brief
+     *    Selects the coarsest level whose error projects to at most maxPixelError
+     *
+     *  @param errors
+     *    Errors of all levels, in increasing order
+     *  @param distance
+     *    Distance of the eye to the mesh bounds
+     *  @param projectionScale
+     *    Pixels per unit at distance one, i.e., viewport height / (2 tan(fovy / 2))
+     */
+    static unsigned int selectLevel(
+        const std::vector<float> & errors,
+        float distance,
+        float projectionScale,
+        float maxPixelError);
+};
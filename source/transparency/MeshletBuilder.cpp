@@ -0,0 +1,187 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "PolygonalGeometry.h"
+
+
+namespace
+{
+
+void disableCone(BinaryMesh::Cluster & meshlet)
+{
+    // Makes isBackFacing() fail for every eye position outside of the meshlet
+    meshlet.coneAxis = glm::vec3{0.0f};
+    meshlet.coneCutoff = 1.0f;
+}
+
+}
+
+const unsigned int MeshletBuilder::s_maxVertices;
+const unsigned int MeshletBuilder::s_maxTriangles;
+
+std::vector<BinaryMesh::Cluster> MeshletBuilder::build(const PolygonalGeometry & geometry)
+{
+    return build(geometry.indices(), geometry.vertices());
+}
+
+std::vector<BinaryMesh::Cluster> MeshletBuilder::build(
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices)
+{
+    auto meshlets = std::vector<BinaryMesh::Cluster>{};
+
+    if (indices.size() % 3u != 0u)
+    {
+        static const auto runSize = std::size_t{s_maxTriangles * 3u};
+
+        for (auto first = std::size_t{0u}; first < indices.size(); first += runSize)
+        {
+            auto meshlet = BinaryMesh::Cluster{};
+            meshlet.firstIndex = static_cast<uint32_t>(first);
+            meshlet.numIndices = static_cast<uint32_t>(std::min(runSize, indices.size() - first));
+
+            computeBounds(meshlet, indices, vertices);
+            disableCone(meshlet);
+
+            meshlets.push_back(meshlet);
+        }
+
+        return meshlets;
+    }
+
+    // Stores the meshlet that last referenced a vertex, so that unique vertices are counted without clearing
+    auto lastMeshlet = std::vector<unsigned int>(vertices.size(), ~0u);
+
+    auto meshlet = BinaryMesh::Cluster{};
+    meshlet.firstIndex = 0u;
+    meshlet.numIndices = 0u;
+
+    auto numMeshletVertices = 0u;
+
+    const auto finish = [&] ()
+    {
+        computeBounds(meshlet, indices, vertices);
+        computeCone(meshlet, indices, vertices);
+        meshlets.push_back(meshlet);
+
+        meshlet = BinaryMesh::Cluster{};
+        meshlet.firstIndex = meshlets.back().firstIndex + meshlets.back().numIndices;
+        meshlet.numIndices = 0u;
+        numMeshletVertices = 0u;
+    };
+
+    const auto countNewVertices = [&] (std::size_t i)
+    {
+        const auto current = static_cast<unsigned int>(meshlets.size());
+        const auto a = indices[i], b = indices[i + 1u], c = indices[i + 2u];
+
+        return (lastMeshlet[a] != current ? 1u : 0u)
+            + (lastMeshlet[b] != current && b != a ? 1u : 0u)
+            + (lastMeshlet[c] != current && c != a && c != b ? 1u : 0u);
+    };
+
+    for (auto i = std::size_t{0u}; i < indices.size(); i += 3u)
+    {
+        auto numNewVertices = countNewVertices(i);
+
+        if (numMeshletVertices + numNewVertices > s_maxVertices || meshlet.numIndices == s_maxTriangles * 3u)
+        {
+            finish();
+            numNewVertices = countNewVertices(i);
+        }
+
+        for (auto j = i; j < i + 3u; ++j)
+            lastMeshlet[indices[j]] = static_cast<unsigned int>(meshlets.size());
+
+        numMeshletVertices += numNewVertices;
+        meshlet.numIndices += 3u;
+    }
+
+    if (meshlet.numIndices > 0u)
+        finish();
+
+    return meshlets;
+}
+
+bool MeshletBuilder::isBackFacing(const BinaryMesh::Cluster & meshlet, const glm::vec3 & eye)
+{
+    // Zeux, "Meshlet cone culling", with the cone apex replaced by the bounding sphere
+    const auto direction = meshlet.center - eye;
+
+    return glm::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(direction) + meshlet.radius;
+}
+
+void MeshletBuilder::computeBounds(
+    BinaryMesh::Cluster & meshlet,
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices)
+{
+    const auto last = meshlet.firstIndex + meshlet.numIndices;
+
+    meshlet.bounds = BoundingBox{};
+
+    for (auto i = meshlet.firstIndex; i < last; ++i)
+        meshlet.bounds.extend(vertices[indices[i]]);
+
+    meshlet.center = meshlet.bounds.center();
+    meshlet.radius = 0.0f;
+
+    for (auto i = meshlet.firstIndex; i < last; ++i)
+        meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, vertices[indices[i]]));
+}
+
+void MeshletBuilder::computeCone(
+    BinaryMesh::Cluster & meshlet,
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices)
+{
+    const auto last = meshlet.firstIndex + meshlet.numIndices;
+
+    auto normals = std::vector<glm::vec3>{};
+    normals.reserve(meshlet.numIndices / 3u);
+
+    auto axis = glm::vec3{0.0f};
+
+    for (auto i = meshlet.firstIndex; i < last; i += 3u)
+    {
+        const auto & a = vertices[indices[i]];
+        const auto normal = glm::cross(vertices[indices[i + 1u]] - a, vertices[indices[i + 2u]] - a);
+        const auto area = glm::length(normal);
+
+        // Degenerate triangles are never rasterized
+        if (area == 0.0f)
+            continue;
+
+        normals.push_back(normal / area);
+        axis += normals.back();
+    }
+
+    const auto axisLength = glm::length(axis);
+
+    if (normals.empty() || axisLength == 0.0f)
+    {
+        disableCone(meshlet);
+        return;
+    }
+
+    axis = axis / axisLength;
+
+    auto minDot = 1.0f;
+
+    for (const auto & normal : normals)
+        minDot = std::min(minDot, glm::dot(axis, normal));
+
+    // Normals spread over a hemisphere or more, some triangle is always front-facing
+    if (minDot <= 0.0f)
+    {
+        disableCone(meshlet);
+        return;
+    }
+
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
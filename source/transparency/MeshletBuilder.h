@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "BinaryMesh.h"
+
+
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Splits triangle meshes into meshlets, small runs of consecutive triangles with few unique vertices
+ *
+ *  @remarks
+ *    Triangles are taken in index order, so meshes should be optimized for vertex cache locality first.
+ *    Each meshlet gets a bounding box, a bounding sphere and a cone bounding its triangle normals,
+ *    which allows culling meshlets that are entirely back-facing, see isBackFacing().
+ *    Meshes whose index count is not a multiple of three are split into equally sized runs without cone.
+ */
+class MeshletBuilder
+{
+public:
+    static const unsigned int s_maxVertices = 64u;
+    static const unsigned int s_maxTriangles = 124u;
+
+public:
+    static std::vector<BinaryMesh::Cluster> build(const PolygonalGeometry & geometry);
+
+    static std::vector<BinaryMesh::Cluster> build(
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices);
+
+    /** Assumes counter-clockwise front faces */
+    static bool isBackFacing(const BinaryMesh::Cluster & meshlet, const glm::vec3 & eye);
+
+protected:
+    static void computeBounds(
+        BinaryMesh::Cluster & meshlet,
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices);
+
+    static void computeCone(
+        BinaryMesh::Cluster & meshlet,
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices);
+};
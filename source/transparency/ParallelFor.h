@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+/**
+ *  @brief
+ *    Splits [0, count) into contiguous chunks and calls function(begin, end) for each chunk concurrently
+ *
+ *  @param numThreads
+ *    Number of worker threads, 0 uses std::thread::hardware_concurrency()
+ *
+ *  @remarks
+ *    The calling thread processes the first chunk and blocks until all other chunks are done.
+ */
+template <typename Function>
+void parallelFor(unsigned int count, Function function, unsigned int numThreads = 0u)
+{
+    if (numThreads == 0u)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    numThreads = std::min(numThreads, count);
+
+    if (numThreads <= 1u)
+    {
+        if (count > 0u)
+            function(0u, count);
+
+        return;
+    }
+
+    const auto chunkSize = (count + numThreads - 1u) / numThreads;
+
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(numThreads - 1u);
+
+    for (auto begin = chunkSize; begin < count; begin += chunkSize)
+        threads.emplace_back(function, begin, std::min(begin + chunkSize, count));
+
+    function(0u, chunkSize);
+
+    for (auto & thread : threads)
+        thread.join();
+}
@@ -0,0 +1,58 @@
+#include "PassTimer.h"
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Query.h>
+
+
+using namespace gl;
+
+PassTimer::PassTimer(unsigned int numPasses)
+:   m_milliseconds(numPasses, 0.0f)
+,   m_current(0u)
+,   m_active(0u)
+{
+    for (auto i = 0u; i < m_queries.size(); ++i)
+    {
+        for (auto pass = 0u; pass < numPasses; ++pass)
+            m_queries[i].push_back(new globjects::Query{});
+
+        m_issued[i].resize(numPasses, false);
+    }
+}
+
+PassTimer::~PassTimer() = default;
+
+void PassTimer::begin(unsigned int pass)
+{
+    m_queries[m_current][pass]->begin(GL_TIME_ELAPSED);
+    m_issued[m_current][pass] = true;
+    m_active = pass;
+}
+
+void PassTimer::end()
+{
+    m_queries[m_current][m_active]->end(GL_TIME_ELAPSED);
+}
+
+void PassTimer::nextFrame()
+{
+    m_current = 1u - m_current;
+
+    // Queries of the frame before the last one, which has most likely finished by now
+    for (auto pass = 0u; pass < m_milliseconds.size(); ++pass)
+    {
+        const auto & query = m_queries[m_current][pass];
+
+        if (!m_issued[m_current][pass] || !query->resultAvailable())
+            continue;
+
+        m_milliseconds[pass] = static_cast<float>(query->get64(GL_QUERY_RESULT)) * 1e-6f;
+        m_issued[m_current][pass] = false;
+    }
+}
+
+float PassTimer::milliseconds(unsigned int pass) const
+{
+    return m_milliseconds[pass];
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <globjects/base/ref_ptr.h>
+
+
+namespace globjects
+{
+    class Query;
+}
+
+/**
+ *  @brief
+ *    GPU time of consecutive render passes, measured with timer queries
+ *
+ *  @remarks
+ *    Queries are double buffered, the times of a frame are read back at the end of the next frame
+ *    without waiting for the GPU. Passes must not be nested. Requires a current context.
+ */
+class PassTimer
+{
+public:
+    PassTimer(unsigned int numPasses);
+    ~PassTimer();
+
+    void begin(unsigned int pass);
+    void end();
+
+    /** Reads back the frame before the current one and swaps query sets */
+    void nextFrame();
+
+    /** Time of the pass in milliseconds, lags one or two frames behind */
+    float milliseconds(unsigned int pass) const;
+
+private:
+    std::array<std::vector<globjects::ref_ptr<globjects::Query>>, 2u> m_queries;
+    std::array<std::vector<bool>, 2u> m_issued;
+    std::vector<float> m_milliseconds;
+    unsigned int m_current;
+    unsigned int m_active;
+};
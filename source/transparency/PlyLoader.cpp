@@ -0,0 +1,712 @@
+#include "PlyLoader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+#include "PolygonalGeometry.h"
+
+
+namespace
+{
+
+enum class Format { Ascii, BinaryLittleEndian, BinaryBigEndian };
+
+enum class Type { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+struct Property
+{
+    std::string name;
+    bool isList;
+    Type countType; ///< only valid for lists
+    Type type;
+};
+
+struct Element
+{
+    std::string name;
+    std::size_t count;
+    std::vector<Property> properties;
+};
+
+/** Property indices of the attributes read from the vertex element, -1 if missing */
+struct VertexLayout
+{
+    int position[3];
+    int normal[3];
+};
+
+bool parseType(const std::string & name, Type & type)
+{
+    static const auto types = std::vector<std::pair<std::string, Type>>{
+        { "char", Type::Int8 }, { "int8", Type::Int8 },
+        { "uchar", Type::UInt8 }, { "uint8", Type::UInt8 },
+        { "short", Type::Int16 }, { "int16", Type::Int16 },
+        { "ushort", Type::UInt16 }, { "uint16", Type::UInt16 },
+        { "int", Type::Int32 }, { "int32", Type::Int32 },
+        { "uint", Type::UInt32 }, { "uint32", Type::UInt32 },
+        { "float", Type::Float32 }, { "float32", Type::Float32 },
+        { "double", Type::Float64 }, { "float64", Type::Float64 }};
+
+    const auto it = std::find_if(types.begin(), types.end(),
+        [&name](const std::pair<std::string, Type> & entry) { return entry.first == name; });
+
+    if (it == types.end())
+        return false;
+
+    type = it->second;
+    return true;
+}
+
+std::size_t sizeOf(Type type)
+{
+    switch (type)
+    {
+    case Type::Int8:
+    case Type::UInt8:
+        return 1u;
+    case Type::Int16:
+    case Type::UInt16:
+        return 2u;
+    case Type::Int32:
+    case Type::UInt32:
+    case Type::Float32:
+        return 4u;
+    case Type::Float64:
+    default:
+        return 8u;
+    }
+}
+
+bool isBigEndianHost()
+{
+    const auto probe = std::uint16_t{1u};
+    auto firstByte = std::uint8_t{};
+    std::memcpy(&firstByte, &probe, 1u);
+
+    return firstByte == 0u;
+}
+
+/** Reads the header up to and including end_header, returns the offset of the body or 0 on failure */
+std::size_t parseHeader(const char * data, std::size_t size, Format & format, std::vector<Element> & elements)
+{
+    auto offset = std::size_t{0u};
+    auto hasFormat = false;
+    auto isFirstLine = true;
+
+    while (offset < size)
+    {
+        const auto lineEnd = static_cast<const char *>(std::memchr(data + offset, '\n', size - offset));
+
+        if (!lineEnd)
+            return 0u;
+
+        auto stream = std::istringstream{std::string{data + offset, lineEnd}};
+        offset = static_cast<std::size_t>(lineEnd - data) + 1u;
+
+        auto keyword = std::string{};
+        stream >> keyword;
+
+        if (isFirstLine)
+        {
+            if (keyword != "ply")
+                return 0u;
+
+            isFirstLine = false;
+            continue;
+        }
+
+        if (keyword == "comment" || keyword == "obj_info" || keyword.empty())
+            continue;
+
+        if (keyword == "end_header")
+            return hasFormat ? offset : 0u;
+
+        if (keyword == "format")
+        {
+            auto name = std::string{};
+            stream >> name;
+
+            if (name == "ascii")
+                format = Format::Ascii;
+            else if (name == "binary_little_endian")
+                format = Format::BinaryLittleEndian;
+            else if (name == "binary_big_endian")
+                format = Format::BinaryBigEndian;
+            else
+                return 0u;
+
+            hasFormat = true;
+        }
+        else if (keyword == "element")
+        {
+            auto element = Element{};
+
+            if (!(stream >> element.name >> element.count))
+                return 0u;
+
+            elements.push_back(element);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+                return 0u;
+
+            auto property = Property{};
+            auto typeName = std::string{};
+            stream >> typeName;
+
+            property.isList = typeName == "list";
+
+            if (property.isList)
+            {
+                auto countTypeName = std::string{};
+                stream >> countTypeName >> typeName;
+
+                if (!parseType(countTypeName, property.countType))
+                    return 0u;
+            }
+
+            if (!parseType(typeName, property.type) || !(stream >> property.name))
+                return 0u;
+
+            elements.back().properties.push_back(property);
+        }
+        else
+        {
+            return 0u;
+        }
+    }
+
+    return 0u;
+}
+
+/** Sequential access to the binary body, converting from file byte order */
+class BinaryReader
+{
+public:
+    BinaryReader(const char * begin, const char * end, bool swap)
+    :   m_pos{begin}
+    ,   m_end{end}
+    ,   m_swap{swap}
+    {
+    }
+
+    const char * position() const
+    {
+        return m_pos;
+    }
+
+    std::size_t remaining() const
+    {
+        return static_cast<std::size_t>(m_end - m_pos);
+    }
+
+    bool skip(std::size_t size)
+    {
+        if (static_cast<std::size_t>(m_end - m_pos) < size)
+            return false;
+
+        m_pos += size;
+        return true;
+    }
+
+    bool read(Type type, double & value)
+    {
+        const auto size = sizeOf(type);
+        if (static_cast<std::size_t>(m_end - m_pos) < size)
+            return false;
+
+        value = convert(m_pos, type);
+        m_pos += size;
+        return true;
+    }
+
+    /** Converts a single value at data without bounds checks */
+    double convert(const char * data, Type type) const
+    {
+        unsigned char bytes[8];
+        const auto size = sizeOf(type);
+        std::memcpy(bytes, data, size);
+
+        if (m_swap)
+            std::reverse(bytes, bytes + size);
+
+        switch (type)
+        {
+        case Type::Int8:    return static_cast<double>(as<std::int8_t>(bytes));
+        case Type::UInt8:   return static_cast<double>(as<std::uint8_t>(bytes));
+        case Type::Int16:   return static_cast<double>(as<std::int16_t>(bytes));
+        case Type::UInt16:  return static_cast<double>(as<std::uint16_t>(bytes));
+        case Type::Int32:   return static_cast<double>(as<std::int32_t>(bytes));
+        case Type::UInt32:  return static_cast<double>(as<std::uint32_t>(bytes));
+        case Type::Float32: return static_cast<double>(as<float>(bytes));
+        case Type::Float64:
+        default:            return as<double>(bytes);
+        }
+    }
+
+private:
+    template <typename T>
+    static T as(const unsigned char * bytes)
+    {
+        auto value = T{};
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+private:
+    const char * m_pos;
+    const char * m_end;
+    bool m_swap;
+};
+
+/** Whitespace separated tokens of the ASCII body */
+class AsciiReader
+{
+public:
+    AsciiReader(const char * begin, const char * end)
+    :   m_pos{begin}
+    ,   m_end{end}
+    {
+    }
+
+    const char * position() const
+    {
+        return m_pos;
+    }
+
+    bool read(Type, double & value)
+    {
+        while (m_pos < m_end && isSpace(*m_pos))
+            ++m_pos;
+
+        const auto begin = m_pos;
+
+        while (m_pos < m_end && !isSpace(*m_pos))
+            ++m_pos;
+
+        // The mapping is not null terminated, so tokens are copied before conversion
+        const auto length = static_cast<std::size_t>(m_pos - begin);
+        char token[64];
+
+        if (length == 0u || length >= sizeof(token))
+            return false;
+
+        std::memcpy(token, begin, length);
+        token[length] = '\0';
+
+        auto tokenEnd = static_cast<char *>(nullptr);
+        value = std::strtod(token, &tokenEnd);
+
+        return tokenEnd == token + length;
+    }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+private:
+    const char * m_pos;
+    const char * m_end;
+};
+
+VertexLayout vertexLayout(const Element & element)
+{
+    static const char * positionNames[] = { "x", "y", "z" };
+    static const char * normalNames[] = { "nx", "ny", "nz" };
+
+    auto layout = VertexLayout{ { -1, -1, -1 }, { -1, -1, -1 } };
+
+    for (auto i = 0u; i < element.properties.size(); ++i)
+    {
+        const auto & property = element.properties[i];
+
+        if (property.isList)
+            continue;
+
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            if (property.name == positionNames[j])
+                layout.position[j] = static_cast<int>(i);
+            else if (property.name == normalNames[j])
+                layout.normal[j] = static_cast<int>(i);
+        }
+    }
+
+    return layout;
+}
+
+bool hasNormals(const VertexLayout & layout)
+{
+    return layout.normal[0] >= 0 && layout.normal[1] >= 0 && layout.normal[2] >= 0;
+}
+
+int faceIndicesProperty(const Element & element)
+{
+    for (auto i = 0u; i < element.properties.size(); ++i)
+    {
+        const auto & property = element.properties[i];
+
+        if (property.isList && (property.name == "vertex_indices" || property.name == "vertex_index"))
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/** Reads the element count of a list property, negative counts are rejected */
+template <typename Reader>
+bool readCount(Reader & reader, Type type, unsigned int & count)
+{
+    auto value = 0.0;
+
+    if (!reader.read(type, value) || value < 0.0)
+        return false;
+
+    count = static_cast<unsigned int>(value);
+    return true;
+}
+
+/** Appends a polygon as triangle fan */
+void triangulate(const std::vector<unsigned int> & polygon, std::vector<unsigned int> & indices)
+{
+    for (auto i = 2u; i < polygon.size(); ++i)
+    {
+        indices.push_back(polygon[0]);
+        indices.push_back(polygon[i - 1u]);
+        indices.push_back(polygon[i]);
+    }
+}
+
+template <typename Reader>
+bool readVertices(Reader & reader, const Element & element, std::vector<glm::vec3> & vertices, std::vector<glm::vec3> & normals)
+{
+    const auto layout = vertexLayout(element);
+    const auto withNormals = hasNormals(layout);
+
+    // The count is taken from the header, so vertices are appended as they are read instead of allocated up front
+    auto values = std::vector<double>(element.properties.size(), 0.0);
+
+    for (auto i = std::size_t{0u}; i < element.count; ++i)
+    {
+        for (auto j = 0u; j < element.properties.size(); ++j)
+        {
+            const auto & property = element.properties[j];
+
+            if (!property.isList)
+            {
+                if (!reader.read(property.type, values[j]))
+                    return false;
+
+                continue;
+            }
+
+            auto count = 0u;
+            if (!readCount(reader, property.countType, count))
+                return false;
+
+            for (auto k = 0u; k < count; ++k)
+            {
+                auto ignored = 0.0;
+                if (!reader.read(property.type, ignored))
+                    return false;
+            }
+        }
+
+        auto vertex = glm::vec3{};
+        auto normal = glm::vec3{};
+
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            vertex[j] = static_cast<float>(values[layout.position[j]]);
+
+            if (withNormals)
+                normal[j] = static_cast<float>(values[layout.normal[j]]);
+        }
+
+        vertices.push_back(vertex);
+
+        if (withNormals)
+            normals.push_back(normal);
+    }
+
+    return true;
+}
+
+template <typename Reader>
+bool readFaces(Reader & reader, const Element & element, std::vector<unsigned int> & indices)
+{
+    const auto indicesProperty = faceIndicesProperty(element);
+
+    auto polygon = std::vector<unsigned int>{};
+
+    for (auto i = std::size_t{0u}; i < element.count; ++i)
+    {
+        for (auto j = 0u; j < element.properties.size(); ++j)
+        {
+            const auto & property = element.properties[j];
+            auto value = 0.0;
+
+            if (!property.isList)
+            {
+                if (!reader.read(property.type, value))
+                    return false;
+
+                continue;
+            }
+
+            auto count = 0u;
+            if (!readCount(reader, property.countType, count))
+                return false;
+
+            polygon.clear();
+
+            for (auto k = 0u; k < count; ++k)
+            {
+                if (!reader.read(property.type, value))
+                    return false;
+
+                // Negative indices wrap around and are rejected by the range check later on
+                polygon.push_back(static_cast<unsigned int>(static_cast<std::int64_t>(value)));
+            }
+
+            if (static_cast<int>(j) == indicesProperty)
+                triangulate(polygon, indices);
+        }
+    }
+
+    return true;
+}
+
+/** Reads the positions in bulk if the vertex element has a fixed size, which is the common case */
+bool readBinaryVertices(
+    BinaryReader & reader,
+    const Element & element,
+    std::vector<glm::vec3> & vertices,
+    std::vector<glm::vec3> & normals)
+{
+    const auto fixedSize = std::none_of(element.properties.begin(), element.properties.end(),
+        [](const Property & property) { return property.isList; });
+
+    if (!fixedSize)
+        return readVertices(reader, element, vertices, normals);
+
+    auto offsets = std::vector<std::size_t>{};
+    auto stride = std::size_t{0u};
+
+    for (const auto & property : element.properties)
+    {
+        offsets.push_back(stride);
+        stride += sizeOf(property.type);
+    }
+
+    // Checked by division, so neither a huge count nor stride * count overflowing can pass
+    if (element.count > reader.remaining() / stride)
+        return false;
+
+    const auto begin = reader.position();
+    reader.skip(stride * element.count);
+
+    const auto layout = vertexLayout(element);
+    const auto withNormals = hasNormals(layout);
+
+    vertices.resize(element.count);
+
+    if (withNormals)
+        normals.resize(element.count);
+
+    for (auto i = std::size_t{0u}; i < element.count; ++i)
+    {
+        const auto vertex = begin + i * stride;
+
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            const auto & position = element.properties[layout.position[j]];
+            vertices[i][j] = static_cast<float>(reader.convert(vertex + offsets[layout.position[j]], position.type));
+
+            if (!withNormals)
+                continue;
+
+            const auto & normal = element.properties[layout.normal[j]];
+            normals[i][j] = static_cast<float>(reader.convert(vertex + offsets[layout.normal[j]], normal.type));
+        }
+    }
+
+    return true;
+}
+
+template <typename Reader>
+bool skipElement(Reader & reader, const Element & element)
+{
+    auto ignored = std::vector<unsigned int>{};
+    return readFaces(reader, element, ignored);
+}
+
+/** Area weighted vertex normals */
+std::vector<glm::vec3> computeNormals(const std::vector<unsigned int> & indices, const std::vector<glm::vec3> & vertices)
+{
+    auto normals = std::vector<glm::vec3>(vertices.size(), glm::vec3{0.0f});
+
+    for (auto i = std::size_t{0u}; i + 2u < indices.size(); i += 3u)
+    {
+        const auto & a = vertices[indices[i]];
+        const auto & b = vertices[indices[i + 1u]];
+        const auto & c = vertices[indices[i + 2u]];
+
+        const auto normal = glm::cross(b - a, c - a);
+
+        normals[indices[i]] += normal;
+        normals[indices[i + 1u]] += normal;
+        normals[indices[i + 2u]] += normal;
+    }
+
+    for (auto & normal : normals)
+    {
+        const auto length = glm::length(normal);
+
+        if (length > 0.0f)
+            normal /= length;
+    }
+
+    return normals;
+}
+
+}
+
+bool PlyLoader::canLoad(const std::string & ext) const
+{
+    auto lower = ext;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    return lower == "ply" || lower == ".ply";
+}
+
+std::vector<std::string> PlyLoader::loadingTypes() const
+{
+    return { "Stanford Polygon Library (*.ply)" };
+}
+
+std::string PlyLoader::allLoadingTypes() const
+{
+    return "*.ply";
+}
+
+PolygonalGeometry * PlyLoader::load(const std::string & filename, std::function<void(int, int)> progress) const
+{
+    const MappedFile file{filename};
+
+    if (!file.isValid())
+    {
+        std::cout << "Could not open file " << filename << std::endl;
+        return nullptr;
+    }
+
+    auto geometry = new PolygonalGeometry{};
+
+    if (!parse(file.data(), file.size(), *geometry, progress))
+    {
+        std::cout << "Could not parse PLY file " << filename << std::endl;
+        delete geometry;
+        return nullptr;
+    }
+
+    return geometry;
+}
+
+bool PlyLoader::parse(
+    const char * data,
+    std::size_t size,
+    PolygonalGeometry & geometry,
+    const std::function<void(int, int)> & progress)
+{
+    auto format = Format::Ascii;
+    auto elements = std::vector<Element>{};
+
+    const auto bodyOffset = parseHeader(data, size, format, elements);
+
+    if (bodyOffset == 0u)
+        return false;
+
+    const auto vertexElement = std::find_if(elements.begin(), elements.end(),
+        [](const Element & element) { return element.name == "vertex"; });
+
+    const auto faceElement = std::find_if(elements.begin(), elements.end(),
+        [](const Element & element) { return element.name == "face"; });
+
+    if (vertexElement == elements.end() || faceElement == elements.end() || faceIndicesProperty(*faceElement) < 0)
+        return false;
+
+    const auto layout = vertexLayout(*vertexElement);
+
+    if (layout.position[0] < 0 || layout.position[1] < 0 || layout.position[2] < 0)
+        return false;
+
+    auto indices = std::vector<unsigned int>{};
+    auto vertices = std::vector<glm::vec3>{};
+    auto normals = std::vector<glm::vec3>{};
+
+    const auto reportProgress = [data, size, &progress](const char * position)
+    {
+        if (progress)
+            progress(static_cast<int>(static_cast<std::size_t>(position - data) * 100u / size), 100);
+    };
+
+    auto binary = BinaryReader{data + bodyOffset, data + size, (format == Format::BinaryBigEndian) != isBigEndianHost()};
+    auto ascii = AsciiReader{data + bodyOffset, data + size};
+
+    for (const auto & element : elements)
+    {
+        auto success = true;
+
+        if (format == Format::Ascii)
+        {
+            if (&element == &*vertexElement)
+                success = readVertices(ascii, element, vertices, normals);
+            else if (&element == &*faceElement)
+                success = readFaces(ascii, element, indices);
+            else
+                success = skipElement(ascii, element);
+
+            reportProgress(ascii.position());
+        }
+        else
+        {
+            if (&element == &*vertexElement)
+                success = readBinaryVertices(binary, element, vertices, normals);
+            else if (&element == &*faceElement)
+                success = readFaces(binary, element, indices);
+            else
+                success = skipElement(binary, element);
+
+            reportProgress(binary.position());
+        }
+
+        if (!success)
+            return false;
+    }
+
+    const auto numVertices = vertices.size();
+    if (std::any_of(indices.begin(), indices.end(), [numVertices](unsigned int index) { return index >= numVertices; }))
+        return false;
+
+    if (normals.empty())
+        normals = computeNormals(indices, vertices);
+
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(vertices));
+    geometry.setNormals(std::move(normals));
+
+    return true;
+}
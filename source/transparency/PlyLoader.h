@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+#include <gloperate/resources/Loader.h>
+
+
+class PolygonalGeometry;
+
+/**
+ *  @brief
+ *    Reads Stanford PLY files directly into a PolygonalGeometry, bypassing Assimp
+ *
+ *  @remarks
+ *    Supports ASCII and little and big endian binary files. Only vertex positions, vertex normals and
+ *    face index lists are read, all other elements and properties are skipped. Polygons are triangulated
+ *    as fans and normals are only computed if the file does not contain any.
+ */
+class PlyLoader : public gloperate::Loader<PolygonalGeometry>
+{
+public:
+    bool canLoad(const std::string & ext) const override;
+
+    std::vector<std::string> loadingTypes() const override;
+
+    std::string allLoadingTypes() const override;
+
+    /**
+     *  @param progress
+     *    Called with the parsed portion of the file in percent (current, 100), may be empty
+     *
+     *  @remarks
+     *    Geometry is owned by the caller and must be deleted with `delete geometry`
+     */
+    PolygonalGeometry * load(const std::string & filename, std::function<void(int, int)> progress) const override;
+
+    /** Parses a whole PLY file from memory, returns false on malformed or unsupported files */
+    static bool parse(
+        const char * data,
+        std::size_t size,
+        PolygonalGeometry & geometry,
+        const std::function<void(int, int)> & progress = nullptr);
+};
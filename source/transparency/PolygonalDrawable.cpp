@@ -1,8 +1,10 @@
 #include "PolygonalDrawable.h"
 
-#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
 
 #include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/boolean.h>
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/functions.h>
 
@@ -10,26 +12,68 @@
 #include <globjects/VertexArray.h>
 #include <globjects/VertexAttributeBinding.h>
 
+#include "BinaryMesh.h"
 #include "PolygonalGeometry.h"
 
 
 using namespace gl;
 
-PolygonalDrawable::PolygonalDrawable(const PolygonalGeometry & geometry)
+PolygonalDrawable::PolygonalDrawable(const PolygonalGeometry & geometry, PositionFormat positionFormat)
 {
-    m_indices = new globjects::Buffer{};
-    m_indices->setData(geometry.indices(), GL_STATIC_DRAW);
+    setup(
+        geometry.indices().data(),
+        static_cast<GLsizei>(geometry.indices().size()),
+        geometry.vertices().data(),
+        geometry.hasNormals() ? geometry.normals().data() : nullptr,
+        static_cast<GLsizei>(geometry.vertices().size()),
+        positionFormat);
+}
 
-    m_size = static_cast<gl::GLsizei>(geometry.indices().size());
+PolygonalDrawable::PolygonalDrawable(const BinaryMesh & mesh, unsigned int index, PositionFormat positionFormat)
+{
+    setup(
+        mesh.indices(index),
+        static_cast<GLsizei>(mesh.lods(index)[0].numIndices),
+        mesh.vertices(index),
+        mesh.normals(index),
+        static_cast<GLsizei>(mesh.numVertices(index)),
+        positionFormat);
+}
 
-    m_vertices = new globjects::Buffer{};
-    m_vertices->setData(geometry.vertices(), GL_STATIC_DRAW);
+const glm::mat4 & PolygonalDrawable::dequantization() const
+{
+    return m_dequantization;
+}
 
-    if (geometry.hasNormals())
+void PolygonalDrawable::setup(
+    const unsigned int * indices,
+    GLsizei numIndices,
+    const glm::vec3 * vertices,
+    const glm::vec3 * normals,
+    GLsizei numVertices,
+    PositionFormat positionFormat)
+{
+    m_indices = new globjects::Buffer{};
+    m_size = numIndices;
+
+    if (numVertices <= 65536)
     {
-        m_normals = new globjects::Buffer{};
-        m_normals->setData(geometry.normals(), GL_STATIC_DRAW);
+        const auto shortIndices = std::vector<uint16_t>(indices, indices + numIndices);
+
+        m_indices->setData(shortIndices, GL_STATIC_DRAW);
+        m_indexType = GL_UNSIGNED_SHORT;
     }
+    else
+    {
+        m_indices->setData(numIndices * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        m_indexType = GL_UNSIGNED_INT;
+    }
+
+    const auto layout = VertexPacking::layout(positionFormat, normals != nullptr);
+    const auto data = VertexPacking::interleave(vertices, normals, numVertices, positionFormat, m_dequantization);
+
+    m_vertices = new globjects::Buffer{};
+    m_vertices->setData(data, GL_STATIC_DRAW);
 
     m_vao = new globjects::VertexArray{};
     m_vao->bind();
@@ -38,25 +82,51 @@ PolygonalDrawable::PolygonalDrawable(const PolygonalGeometry & geometry)
 
     auto vertexBinding = m_vao->binding(0);
     vertexBinding->setAttribute(0);
-    vertexBinding->setBuffer(m_vertices, 0, sizeof(glm::vec3));
-    vertexBinding->setFormat(3, gl::GL_FLOAT);
+    vertexBinding->setBuffer(m_vertices, 0, layout.stride);
+
+    switch (positionFormat)
+    {
+    case PositionFormat::Float:
+        vertexBinding->setFormat(3, GL_FLOAT);
+        break;
+    case PositionFormat::HalfFloat:
+        vertexBinding->setFormat(3, GL_HALF_FLOAT);
+        break;
+    case PositionFormat::Quantized:
+        vertexBinding->setFormat(3, GL_UNSIGNED_SHORT, GL_TRUE);
+        break;
+    }
+
     m_vao->enable(0);
 
-    if (geometry.hasNormals())
+    if (normals)
     {
         auto vertexBinding = m_vao->binding(1);
         vertexBinding->setAttribute(1);
-        vertexBinding->setBuffer(m_normals, 0, sizeof(glm::vec3));
-        vertexBinding->setFormat(3, gl::GL_FLOAT, GL_TRUE);
+        vertexBinding->setBuffer(m_vertices, 0, layout.stride);
+        vertexBinding->setFormat(4, GL_INT_2_10_10_10_REV, GL_TRUE, layout.normalOffset);
         m_vao->enable(1);
     }
 
     m_vao->unbind();
 }
 
+void PolygonalDrawable::updateIndices(const std::vector<unsigned int> & indices)
+{
+    if (m_indexType == GL_UNSIGNED_SHORT)
+    {
+        const auto shortIndices = std::vector<uint16_t>(indices.begin(), indices.end());
+        m_indices->setSubData(0, shortIndices.size() * sizeof(uint16_t), shortIndices.data());
+    }
+    else
+    {
+        m_indices->setSubData(0, indices.size() * sizeof(unsigned int), indices.data());
+    }
+}
+
 void PolygonalDrawable::draw()
 {
     m_vao->bind();
-    m_vao->drawElements(GL_TRIANGLES, m_size, GL_UNSIGNED_INT, nullptr);
+    m_vao->drawElements(GL_TRIANGLES, m_size, m_indexType, nullptr);
     m_vao->unbind();
 }
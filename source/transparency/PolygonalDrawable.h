@@ -1,9 +1,15 @@
 #pragma once
 
+#include <vector>
+
+#include <glm/glm.hpp>
+
 #include <glbinding/gl/types.h>
 
 #include <globjects/base/ref_ptr.h>
 
+#include "VertexPacking.h"
+
 
 namespace globjects
 {
@@ -11,19 +17,50 @@ namespace globjects
     class VertexArray;
 }
 
+class BinaryMesh;
 class PolygonalGeometry;
 
+/**
+ *  @brief
+ *    Draws a mesh from one interleaved vertex buffer with packed normals
+ *
+ *  @remarks
+ *    Indices are stored with 16 bit if possible. Shaders have to apply dequantization()
+ *    to positions, as compressed position formats are stored relative to the mesh bounds.
+ */
 class PolygonalDrawable
 {
 public:
-    PolygonalDrawable(const PolygonalGeometry & geometry);
+    PolygonalDrawable(const PolygonalGeometry & geometry, PositionFormat positionFormat = PositionFormat::Float);
+
+    /** Uploads the mesh directly from the (memory-mapped) binary representation */
+    PolygonalDrawable(
+        const BinaryMesh & mesh,
+        unsigned int index,
+        PositionFormat positionFormat = PositionFormat::Float);
+
+    /** Transforms stored positions into model space */
+    const glm::mat4 & dequantization() const;
+
+    /** Replaces the indices by a permutation of the same size, e.g., after sorting triangles */
+    void updateIndices(const std::vector<unsigned int> & indices);
 
     void draw();
 
+protected:
+    void setup(
+        const unsigned int * indices,
+        gl::GLsizei numIndices,
+        const glm::vec3 * vertices,
+        const glm::vec3 * normals,
+        gl::GLsizei numVertices,
+        PositionFormat positionFormat);
+
 private:
     globjects::ref_ptr<globjects::VertexArray> m_vao;
     globjects::ref_ptr<globjects::Buffer> m_indices;
     globjects::ref_ptr<globjects::Buffer> m_vertices;
-    globjects::ref_ptr<globjects::Buffer> m_normals;
     gl::GLsizei m_size;
+    gl::GLenum m_indexType;
+    glm::mat4 m_dequantization;
 };
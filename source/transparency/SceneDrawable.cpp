@@ -0,0 +1,611 @@
+#include "SceneDrawable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <glbinding/Version.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+#include <gloperate/painter/AbstractCameraCapability.h>
+#include <gloperate/painter/AbstractPerspectiveProjectionCapability.h>
+#include <gloperate/painter/AbstractViewportCapability.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "AsyncMeshLoader.h"
+#include "CounterReadback.h"
+#include "DepthPyramid.h"
+#include "Frustum.h"
+#include "MeshCache.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "SceneOptions.h"
+
+
+using namespace gl;
+
+namespace
+{
+
+struct DrawData
+{
+    glm::mat4 dequantization;
+    uint32_t index;
+    uint32_t padding[3];
+};
+
+struct ClusterData
+{
+    glm::vec4 sphere;
+    glm::vec4 cone;
+    GLuint count;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint lod;         ///< mesh index << 8 | level
+};
+
+static_assert(sizeof(DrawData) == 80u, "DrawData has to match its std430 layout");
+static_assert(sizeof(ClusterData) == 48u, "ClusterData has to match its std430 layout");
+
+// Binding points of cull_clusters.comp
+const auto kClusterDataBinding = 0u;
+const auto kCommandsBinding = 1u;
+const auto kDrawCountBinding = 2u;
+const auto kSelectedLodsBinding = 3u;
+
+const auto kCullLocalSize = 64u;
+
+// Bounds the time spent on buffer uploads per frame
+const auto kUploadBudget = std::size_t{16u * 1024u * 1024u};
+
+// Tolerated screen space error of levels of detail in pixels, scaled by the bias of SceneOptions
+const auto kMaxPixelError = 1.0f;
+
+}
+
+bool SceneDrawable::multiDrawSupported()
+{
+    return globjects::version() >= glbinding::Version(4, 3)
+        && globjects::hasExtension(GLextension::GL_ARB_shader_draw_parameters);
+}
+
+SceneDrawable::SceneDrawable(PositionFormat positionFormat)
+:   m_positionFormat{positionFormat}
+,   m_multiDraw{multiDrawSupported()}
+,   m_layout(VertexPacking::layout(positionFormat, false))
+,   m_indexType{GL_UNSIGNED_INT}
+,   m_hierarchyChanged{false}
+,   m_frustumCulling{true}
+,   m_coneCulling{false}
+,   m_culledOnGpu{false}
+,   m_numVisible{0u}
+{
+}
+
+SceneDrawable::~SceneDrawable() = default;
+
+void SceneDrawable::load(const std::string & filename, const MeshCache & cache)
+{
+    m_loader = widgetzeug::make_unique<AsyncMeshLoader>(filename, cache);
+}
+
+void SceneDrawable::update(
+    const gloperate::AbstractCameraCapability & camera,
+    const gloperate::AbstractPerspectiveProjectionCapability & projection,
+    const gloperate::AbstractViewportCapability & viewport,
+    SceneOptions & options)
+{
+    prepare(camera, projection, viewport, options);
+    cull(projection.projection() * camera.view(), camera.eye());
+    updateStatistics(options);
+}
+
+void SceneDrawable::updateOnGpu(
+    const gloperate::AbstractCameraCapability & camera,
+    const gloperate::AbstractPerspectiveProjectionCapability & projection,
+    const gloperate::AbstractViewportCapability & viewport,
+    SceneOptions & options,
+    const DepthPyramid * depthPyramid)
+{
+    prepare(camera, projection, viewport, options);
+    cullOnGpu(projection.projection() * camera.view(), camera.eye(), depthPyramid);
+    updateStatistics(options);
+}
+
+void SceneDrawable::prepare(
+    const gloperate::AbstractCameraCapability & camera,
+    const gloperate::AbstractPerspectiveProjectionCapability & projection,
+    const gloperate::AbstractViewportCapability & viewport,
+    const SceneOptions & options)
+{
+    if (m_loader && m_loader->upload(*this, kUploadBudget))
+    {
+        if (m_loader->hasFailed())
+            std::cout << "Could not load file" << std::endl;
+
+        m_loader.reset();
+    }
+
+    if (!options.lodFreeze())
+    {
+        const auto projectionScale = viewport.height() / (2.0f * std::tan(projection.fovy() * 0.5f));
+        selectLods(camera.eye(), projectionScale, kMaxPixelError * std::exp2(options.lodBias()));
+    }
+
+    setFrustumCulling(options.frustumCulling());
+    setConeCulling(options.backFaceCulling());
+}
+
+void SceneDrawable::updateStatistics(SceneOptions & options) const
+{
+    // The visible count of GPU culling lags a frame behind, so it may exceed the current selection
+    const auto numSelected = numSelectedDraws();
+
+    options.setVisibleDraws(m_numVisible);
+    options.setCulledDraws(numSelected > m_numVisible ? numSelected - m_numVisible : 0u);
+    options.setLoadingProgress(m_loader ? m_loader->progress() : 100);
+}
+
+void SceneDrawable::allocate(const BinaryMesh & mesh)
+{
+    const auto numMeshes = mesh.numMeshes();
+
+    auto numIndices = 0u;
+    auto numVertices = 0u;
+    auto maxMeshVertices = 0u;
+    auto numClusters = 0u;
+    auto hasNormals = false;
+
+    m_ranges.resize(numMeshes);
+
+    for (auto i = 0u; i < numMeshes; ++i)
+    {
+        m_ranges[i].firstIndex = numIndices;
+        m_ranges[i].baseVertex = static_cast<GLint>(numVertices);
+
+        numIndices += mesh.numIndices(i);
+        numVertices += mesh.numVertices(i);
+        numClusters += mesh.numClusters(i);
+        maxMeshVertices = std::max(maxMeshVertices, mesh.numVertices(i));
+        hasNormals = hasNormals || mesh.normals(i) != nullptr;
+    }
+
+    // Indices are relative to each mesh's base vertex, so 16 bit suffice unless a single mesh is too large
+    m_indexType = maxMeshVertices <= 65536u ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    m_layout = VertexPacking::layout(m_positionFormat, hasNormals);
+
+    m_meshLods.clear();
+    m_meshLods.reserve(numMeshes);
+
+    m_drawCommands.clear();
+    m_drawCommands.reserve(numClusters);
+    m_clusters.clear();
+    m_clusters.reserve(numClusters);
+    m_dequantizations.clear();
+    m_meshIndices.clear();
+    m_hierarchyChanged = true;
+    m_culledOnGpu = false;
+    m_numVisible = 0u;
+
+    if (m_drawCountReadback)
+        m_drawCountReadback->discard();
+
+    const auto indexSize = m_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    m_indices = new globjects::Buffer{};
+    m_indices->setData(static_cast<GLsizeiptr>(numIndices * indexSize), nullptr, GL_STATIC_DRAW);
+
+    m_vertices = new globjects::Buffer{};
+    m_vertices->setData(static_cast<GLsizeiptr>(numVertices * m_layout.stride), nullptr, GL_STATIC_DRAW);
+
+    m_commands = new globjects::Buffer{};
+    m_commands->setData(static_cast<GLsizeiptr>(numClusters * sizeof(DrawElementsIndirectCommand)), nullptr, GL_DYNAMIC_DRAW);
+
+    m_drawData = new globjects::Buffer{};
+    m_drawData->setData(static_cast<GLsizeiptr>(numClusters * sizeof(DrawData)), nullptr, GL_STATIC_DRAW);
+
+    m_clusterData = new globjects::Buffer{};
+    m_clusterData->setData(static_cast<GLsizeiptr>(numClusters * sizeof(ClusterData)), nullptr, GL_STATIC_DRAW);
+
+    static const auto zero = GLuint{0u};
+
+    m_drawCount = new globjects::Buffer{};
+    m_drawCount->setData(sizeof(zero), &zero, GL_DYNAMIC_COPY);
+
+    m_selectedLods = new globjects::Buffer{};
+    m_selectedLods->setData(static_cast<GLsizeiptr>(numMeshes * sizeof(GLuint)), nullptr, GL_DYNAMIC_DRAW);
+
+    m_vao = new globjects::VertexArray{};
+    m_vao->bind();
+
+    m_indices->bind(GL_ELEMENT_ARRAY_BUFFER);
+
+    auto vertexBinding = m_vao->binding(0);
+    vertexBinding->setAttribute(0);
+    vertexBinding->setBuffer(m_vertices, 0, m_layout.stride);
+
+    switch (m_positionFormat)
+    {
+    case PositionFormat::Float:
+        vertexBinding->setFormat(3, GL_FLOAT);
+        break;
+    case PositionFormat::HalfFloat:
+        vertexBinding->setFormat(3, GL_HALF_FLOAT);
+        break;
+    case PositionFormat::Quantized:
+        vertexBinding->setFormat(3, GL_UNSIGNED_SHORT, GL_TRUE);
+        break;
+    }
+
+    m_vao->enable(0);
+
+    if (hasNormals)
+    {
+        auto normalBinding = m_vao->binding(1);
+        normalBinding->setAttribute(1);
+        normalBinding->setBuffer(m_vertices, 0, m_layout.stride);
+        normalBinding->setFormat(4, GL_INT_2_10_10_10_REV, GL_TRUE, m_layout.normalOffset);
+        m_vao->enable(1);
+    }
+
+    m_vao->unbind();
+}
+
+std::size_t SceneDrawable::add(const BinaryMesh & mesh, unsigned int index)
+{
+    const auto & range = m_ranges[index];
+    const auto numIndices = mesh.numIndices(index);
+    const auto numVertices = mesh.numVertices(index);
+    const auto indices = mesh.indices(index);
+
+    auto numBytes = std::size_t{0u};
+
+    if (m_indexType == GL_UNSIGNED_SHORT)
+    {
+        const auto shortIndices = std::vector<uint16_t>(indices, indices + numIndices);
+
+        numBytes += shortIndices.size() * sizeof(uint16_t);
+        m_indices->setSubData(range.firstIndex * sizeof(uint16_t), numBytes, shortIndices.data());
+    }
+    else
+    {
+        numBytes += numIndices * sizeof(uint32_t);
+        m_indices->setSubData(range.firstIndex * sizeof(uint32_t), numBytes, indices);
+    }
+
+    // All meshes share one layout, so meshes without normals get zero normals if others have some
+    auto normals = mesh.normals(index);
+    auto zeroNormals = std::vector<glm::vec3>{};
+
+    if (!normals && m_layout.normalOffset != 0u)
+    {
+        zeroNormals.resize(numVertices, glm::vec3{0.0f});
+        normals = zeroNormals.data();
+    }
+
+    auto drawData = DrawData{};
+    drawData.index = index;
+
+    const auto vertices = VertexPacking::interleave(
+        mesh.vertices(index), normals, numVertices, m_positionFormat, drawData.dequantization);
+
+    m_vertices->setSubData(range.baseVertex * m_layout.stride, vertices.size(), vertices.data());
+    numBytes += vertices.size();
+
+    // Meshes are appended, the draw index always matches the position of the draw data
+    const auto firstDraw = static_cast<unsigned int>(m_drawCommands.size());
+    const auto clusters = mesh.clusters(index);
+    const auto numClusters = mesh.numClusters(index);
+    const auto lods = mesh.lods(index);
+
+    auto meshLods = MeshLods{};
+    meshLods.bounds = mesh.bounds(index);
+    meshLods.selected = 0u;
+
+    auto clusterData = std::vector<ClusterData>(numClusters);
+
+    for (auto level = 0u; level < mesh.numLods(index); ++level)
+    {
+        meshLods.errors.push_back(lods[level].error);
+        meshLods.firstDraws.push_back(firstDraw + lods[level].firstCluster);
+
+        for (auto i = lods[level].firstCluster; i < lods[level].firstCluster + lods[level].numClusters; ++i)
+        {
+            auto command = DrawElementsIndirectCommand{};
+            command.count = clusters[i].numIndices;
+            command.instanceCount = 1u;
+            command.firstIndex = range.firstIndex + clusters[i].firstIndex;
+            command.baseVertex = range.baseVertex;
+            command.baseInstance = firstDraw + i;
+
+            clusterData[i].sphere = glm::vec4{clusters[i].center, clusters[i].radius};
+            clusterData[i].cone = glm::vec4{clusters[i].coneAxis, clusters[i].coneCutoff};
+            clusterData[i].count = command.count;
+            clusterData[i].firstIndex = command.firstIndex;
+            clusterData[i].baseVertex = command.baseVertex;
+            clusterData[i].lod = static_cast<GLuint>(m_meshLods.size()) << 8u | level;
+
+            m_drawCommands.push_back(command);
+            m_clusters.push_back(clusters[i]);
+        }
+    }
+
+    meshLods.firstDraws.push_back(firstDraw + numClusters);
+    m_meshLods.push_back(meshLods);
+
+    if (!m_multiDraw)
+    {
+        m_dequantizations.insert(m_dequantizations.end(), numClusters, drawData.dequantization);
+        m_meshIndices.insert(m_meshIndices.end(), numClusters, drawData.index);
+    }
+
+    const auto clusterDrawData = std::vector<DrawData>(numClusters, drawData);
+
+    m_drawData->setSubData(firstDraw * sizeof(DrawData), numClusters * sizeof(DrawData), clusterDrawData.data());
+    m_clusterData->setSubData(firstDraw * sizeof(ClusterData), numClusters * sizeof(ClusterData), clusterData.data());
+
+    m_hierarchyChanged = true;
+
+    return numBytes;
+}
+
+unsigned int SceneDrawable::numDraws() const
+{
+    return static_cast<unsigned int>(m_drawCommands.size());
+}
+
+void SceneDrawable::selectLods(const glm::vec3 & eye, float projectionScale, float maxPixelError)
+{
+    for (auto & meshLods : m_meshLods)
+    {
+        const auto & bounds = meshLods.bounds;
+        const auto distance = glm::length(glm::max(glm::max(bounds.min() - eye, eye - bounds.max()), glm::vec3{0.0f}));
+
+        meshLods.selected = MeshSimplifier::selectLevel(meshLods.errors, distance, projectionScale, maxPixelError);
+    }
+}
+
+unsigned int SceneDrawable::numSelectedDraws() const
+{
+    auto count = 0u;
+
+    for (const auto & meshLods : m_meshLods)
+        count += meshLods.firstDraws[meshLods.selected + 1u] - meshLods.firstDraws[meshLods.selected];
+
+    return count;
+}
+
+void SceneDrawable::setFrustumCulling(bool enabled)
+{
+    m_frustumCulling = enabled;
+}
+
+void SceneDrawable::setConeCulling(bool enabled)
+{
+    m_coneCulling = enabled;
+}
+
+void SceneDrawable::updateHierarchy()
+{
+    if (!m_hierarchyChanged)
+        return;
+
+    auto bounds = std::vector<BoundingBox>{};
+    bounds.reserve(m_clusters.size());
+
+    for (const auto & cluster : m_clusters)
+        bounds.push_back(cluster.bounds);
+
+    m_hierarchy.build(bounds);
+    m_hierarchyChanged = false;
+}
+
+void SceneDrawable::cull(const glm::mat4 & viewProjection, const glm::vec3 & eye)
+{
+    m_culledOnGpu = false;
+
+    if (m_drawCommands.empty())
+        return;
+
+    if (m_frustumCulling)
+    {
+        updateHierarchy();
+        m_hierarchy.cull(Frustum{viewProjection}, m_visible);
+    }
+    else
+    {
+        m_visible.assign(m_drawCommands.size(), true);
+    }
+
+    m_visibleCommands.clear();
+
+    for (const auto & meshLods : m_meshLods)
+    {
+        const auto last = meshLods.firstDraws[meshLods.selected + 1u];
+
+        for (auto i = meshLods.firstDraws[meshLods.selected]; i < last; ++i)
+        {
+            if (!m_visible[i] || (m_coneCulling && MeshletBuilder::isBackFacing(m_clusters[i], eye)))
+                continue;
+
+            m_visibleCommands.push_back(m_drawCommands[i]);
+        }
+    }
+
+    m_numVisible = static_cast<unsigned int>(m_visibleCommands.size());
+
+    if (m_multiDraw && m_numVisible > 0u)
+        m_commands->setSubData(0, m_numVisible * sizeof(DrawElementsIndirectCommand), m_visibleCommands.data());
+}
+
+void SceneDrawable::cullOnGpu(const glm::mat4 & viewProjection, const glm::vec3 & eye, const DepthPyramid * depthPyramid)
+{
+    if (!m_multiDraw)
+    {
+        cull(viewProjection, eye);
+        return;
+    }
+
+    if (m_drawCommands.empty())
+        return;
+
+    if (!m_cullProgram)
+    {
+        m_cullProgram = new globjects::Program{};
+        m_cullProgram->attach(globjects::Shader::fromFile(GL_COMPUTE_SHADER, "data/transparency/cull_clusters.comp"));
+        m_cullProgram->setUniform("depthPyramid", 0);
+
+        m_drawCountReadback = widgetzeug::make_unique<CounterReadback>();
+    }
+
+    // Count of an earlier frame, if one has arrived, the current one is read back after the dispatch
+    m_drawCountReadback->read(m_numVisible);
+
+    static const auto zero = GLuint{0u};
+    m_drawCount->setSubData(0, sizeof(zero), &zero);
+
+    auto selectedLods = std::vector<GLuint>{};
+    selectedLods.reserve(m_meshLods.size());
+
+    for (const auto & meshLods : m_meshLods)
+        selectedLods.push_back(meshLods.selected);
+
+    m_selectedLods->setSubData(0, selectedLods.size() * sizeof(GLuint), selectedLods.data());
+
+    const auto frustum = Frustum{viewProjection};
+    const auto & planes = frustum.planes();
+    const auto numClusters = numDraws();
+
+    m_cullProgram->setUniform("numClusters", numClusters);
+    m_cullProgram->setUniform("viewProjection", viewProjection);
+    m_cullProgram->setUniform("planes", std::vector<glm::vec4>(planes.begin(), planes.end()));
+    m_cullProgram->setUniform("eye", eye);
+    m_cullProgram->setUniform("frustumCulling", m_frustumCulling);
+    m_cullProgram->setUniform("coneCulling", m_coneCulling);
+    m_cullProgram->setUniform("occlusionCulling", depthPyramid != nullptr);
+
+    if (depthPyramid)
+    {
+        depthPyramid->texture()->bindActive(GL_TEXTURE0);
+        m_cullProgram->setUniform("depthPyramidSize", glm::vec2{depthPyramid->size()});
+    }
+
+    m_clusterData->bindBase(GL_SHADER_STORAGE_BUFFER, kClusterDataBinding);
+    m_commands->bindBase(GL_SHADER_STORAGE_BUFFER, kCommandsBinding);
+    m_drawCount->bindBase(GL_SHADER_STORAGE_BUFFER, kDrawCountBinding);
+    m_selectedLods->bindBase(GL_SHADER_STORAGE_BUFFER, kSelectedLodsBinding);
+
+    m_cullProgram->use();
+    m_cullProgram->dispatchCompute((numClusters + kCullLocalSize - 1u) / kCullLocalSize, 1u, 1u);
+    m_cullProgram->release();
+
+    globjects::Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kClusterDataBinding);
+    globjects::Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kCommandsBinding);
+    globjects::Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kDrawCountBinding);
+    globjects::Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kSelectedLodsBinding);
+
+    // The commands and the count are read by the draw, the count also by the copy and the next reset
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    m_drawCountReadback->copy(m_drawCount);
+
+    m_culledOnGpu = true;
+}
+
+unsigned int SceneDrawable::numVisible() const
+{
+    return m_numVisible;
+}
+
+void SceneDrawable::draw(globjects::Program * program)
+{
+    if (m_drawCommands.empty() || (!m_culledOnGpu && m_numVisible == 0u))
+        return;
+
+    if (!m_multiDraw)
+    {
+        drawSeparately(program);
+        return;
+    }
+
+    m_vao->bind();
+    m_commands->bind(GL_DRAW_INDIRECT_BUFFER);
+    m_drawData->bindBase(GL_SHADER_STORAGE_BUFFER, s_drawDataBinding);
+
+    if (m_culledOnGpu)
+    {
+        m_drawCount->bind(GL_PARAMETER_BUFFER_ARB);
+        glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, m_indexType, nullptr, 0, static_cast<GLsizei>(numDraws()), 0);
+        globjects::Buffer::unbind(GL_PARAMETER_BUFFER_ARB);
+    }
+    else
+    {
+        glMultiDrawElementsIndirect(GL_TRIANGLES, m_indexType, nullptr, static_cast<GLsizei>(m_numVisible), 0);
+    }
+
+    globjects::Buffer::unbind(GL_SHADER_STORAGE_BUFFER, s_drawDataBinding);
+    globjects::Buffer::unbind(GL_DRAW_INDIRECT_BUFFER);
+    m_vao->unbind();
+}
+
+void SceneDrawable::drawSeparately(globjects::Program * program)
+{
+    auto uniforms = std::find_if(m_separateDrawUniforms.begin(), m_separateDrawUniforms.end(),
+        [program] (const SeparateDrawUniforms & candidate) { return candidate.program.get() == program; });
+
+    // Locations are looked up once, the programs are kept alive so that they remain valid
+    if (uniforms == m_separateDrawUniforms.end())
+    {
+        auto entry = SeparateDrawUniforms{};
+        entry.program = program;
+        entry.dequantization = program->getUniformLocation("dequantization");
+        entry.index = program->getUniformLocation("index");
+
+        m_separateDrawUniforms.push_back(entry);
+        uniforms = m_separateDrawUniforms.end() - 1;
+    }
+
+    const auto indexSize = m_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    m_vao->bind();
+
+    // Meshlets of a mesh are adjacent and share its draw data
+    auto first = true;
+    auto currentMesh = GLuint{0u};
+
+    for (const auto & command : m_visibleCommands)
+    {
+        const auto meshIndex = m_meshIndices[command.baseInstance];
+
+        if (first || meshIndex != currentMesh)
+        {
+            glUniformMatrix4fv(uniforms->dequantization, 1, GL_FALSE, glm::value_ptr(m_dequantizations[command.baseInstance]));
+            glUniform1ui(uniforms->index, meshIndex);
+
+            first = false;
+            currentMesh = meshIndex;
+        }
+
+        const auto offset = reinterpret_cast<const void *>(command.firstIndex * indexSize);
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), m_indexType, offset, command.baseVertex);
+    }
+
+    m_vao->unbind();
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/ref_ptr.h>
+
+#include "BinaryMesh.h"
+#include "BoundingVolumeHierarchy.h"
+#include "VertexPacking.h"
+
+
+namespace globjects
+{
+    class Buffer;
+    class Program;
+    class VertexArray;
+}
+
+namespace gloperate
+{
+    class AbstractCameraCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractViewportCapability;
+}
+
+class AsyncMeshLoader;
+class CounterReadback;
+class DepthPyramid;
+class MeshCache;
+class SceneOptions;
+
+/**
+ *  @brief
+ *    Draws all meshes of a scene from shared buffers with a single glMultiDrawElementsIndirect
+ *
+ *  @remarks
+ *    Per draw data is bound as shader storage buffer to binding point 0 and has to be
+ *    indexed by gl_BaseInstanceARB. Its std430 layout is
+ *
+ *        struct DrawData
+ *        {
+ *            mat4 dequantization; // see PolygonalDrawable
+ *            uint index;          // index of the mesh within the scene
+ *        };
+ *
+ *    Each meshlet of a mesh is a separate draw, its data duplicates that of the mesh.
+ *    Only the meshlets of the selected level of detail of each mesh are drawn.
+ *    Culling compacts the list of draw commands, either on the CPU or with a compute shader.
+ *    The latter requires GL_ARB_indirect_parameters to read the number of draws from a buffer.
+ *
+ *    Without OpenGL 4.3 and GL_ARB_shader_draw_parameters, see multiDrawSupported(), each visible
+ *    meshlet is drawn with glDrawElementsBaseVertex instead. Its draw data is then set as the
+ *    uniforms mat4 dequantization and uint index of the program passed to draw().
+ *
+ *    Storage for all meshes is allocated up front, meshes can then be added incrementally.
+ *    Painters usually leave this to load() and update(), which also apply their SceneOptions.
+ */
+class SceneDrawable
+{
+public:
+    static const gl::GLuint s_drawDataBinding = 0u;
+
+public:
+    /** Whether the current context supports the multi draw path, requires a current context */
+    static bool multiDrawSupported();
+
+public:
+    SceneDrawable(PositionFormat positionFormat = PositionFormat::Float);
+    ~SceneDrawable();
+
+    /**
+     *  @brief
+     *    Starts loading a scene in the background, see AsyncMeshLoader
+     *
+     *  @remarks
+     *    Meshes are added by update() as they become available, nothing is drawn until then.
+     *    update() reports the import progress as SceneOptions::loadingProgress().
+     */
+    void load(const std::string & filename, const MeshCache & cache);
+
+    /**
+     *  @brief
+     *    Adds pending meshes of load(), selects levels of detail for the current view and culls on the CPU
+     *
+     *  @remarks
+     *    Culling and level of detail follow options, its statistics are updated afterwards
+     */
+    void update(
+        const gloperate::AbstractCameraCapability & camera,
+        const gloperate::AbstractPerspectiveProjectionCapability & projection,
+        const gloperate::AbstractViewportCapability & viewport,
+        SceneOptions & options);
+
+    /** As update(), but culls with cullOnGpu(), depthPyramid may be nullptr */
+    void updateOnGpu(
+        const gloperate::AbstractCameraCapability & camera,
+        const gloperate::AbstractPerspectiveProjectionCapability & projection,
+        const gloperate::AbstractViewportCapability & viewport,
+        SceneOptions & options,
+        const DepthPyramid * depthPyramid);
+
+    /** Allocates storage for all meshes of mesh, discards meshes added before */
+    void allocate(const BinaryMesh & mesh);
+
+    /**
+     *  @brief
+     *    Uploads a mesh of the allocated scene and appends its meshlets
+     *
+     *  @remarks
+     *    Meshlets are drawn after the next call to cull() or cullOnGpu()
+     *
+     *  @return
+     *    Number of uploaded bytes
+     */
+    std::size_t add(const BinaryMesh & mesh, unsigned int index);
+
+    unsigned int numDraws() const;
+
+    /**
+     *  @brief
+     *    Selects the coarsest level of detail of each mesh whose error stays below maxPixelError on screen
+     *
+     *  @param projectionScale
+     *    Pixels per unit at distance one, see MeshSimplifier::selectLevel()
+     */
+    void selectLods(const glm::vec3 & eye, float projectionScale, float maxPixelError);
+
+    /** Number of draws of the selected levels of detail, i.e., before culling */
+    unsigned int numSelectedDraws() const;
+
+    void setFrustumCulling(bool enabled);
+
+    /** Drops meshlets facing away from the eye, only valid if back faces are culled */
+    void setConeCulling(bool enabled);
+
+    /** Compacts the draw list on the CPU */
+    void cull(const glm::mat4 & viewProjection, const glm::vec3 & eye);
+
+    /**
+     *  @brief
+     *    Compacts the draw list with a compute shader
+     *
+     *  @param depthPyramid
+     *    Occluders for the current view, disables occlusion culling if nullptr
+     *
+     *  @remarks
+     *    numVisible() lags one or two frames behind, so that reading it back does not stall.
+     *    Falls back to cull() without multi draw support.
+     */
+    void cullOnGpu(const glm::mat4 & viewProjection, const glm::vec3 & eye, const DepthPyramid * depthPyramid);
+
+    unsigned int numVisible() const;
+
+    /** Draws the visible meshlets, program has to be in use */
+    void draw(globjects::Program * program);
+
+protected:
+    struct DrawElementsIndirectCommand
+    {
+        gl::GLuint count;
+        gl::GLuint instanceCount;
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+        gl::GLuint baseInstance;
+    };
+
+protected:
+    void updateHierarchy();
+    void drawSeparately(globjects::Program * program);
+
+    /** Uploads pending meshes of load() and configures culling for the current view */
+    void prepare(
+        const gloperate::AbstractCameraCapability & camera,
+        const gloperate::AbstractPerspectiveProjectionCapability & projection,
+        const gloperate::AbstractViewportCapability & viewport,
+        const SceneOptions & options);
+
+    void updateStatistics(SceneOptions & options) const;
+
+    struct Range
+    {
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+    };
+
+    struct MeshLods
+    {
+        BoundingBox bounds;
+        std::vector<float> errors;
+        std::vector<unsigned int> firstDraws; ///< per level and one past the last draw
+        unsigned int selected;
+    };
+
+    /** Uniform locations of a program used with separate draws */
+    struct SeparateDrawUniforms
+    {
+        globjects::ref_ptr<globjects::Program> program;
+        gl::GLint dequantization;
+        gl::GLint index;
+    };
+
+private:
+    const PositionFormat m_positionFormat;
+    const bool m_multiDraw;
+
+    std::unique_ptr<AsyncMeshLoader> m_loader;
+
+    globjects::ref_ptr<globjects::VertexArray> m_vao;
+    globjects::ref_ptr<globjects::Buffer> m_indices;
+    globjects::ref_ptr<globjects::Buffer> m_vertices;
+    globjects::ref_ptr<globjects::Buffer> m_commands;
+    globjects::ref_ptr<globjects::Buffer> m_drawData;
+    globjects::ref_ptr<globjects::Buffer> m_clusterData;
+    globjects::ref_ptr<globjects::Buffer> m_drawCount;
+    globjects::ref_ptr<globjects::Buffer> m_selectedLods;
+    globjects::ref_ptr<globjects::Program> m_cullProgram;
+    std::unique_ptr<CounterReadback> m_drawCountReadback;
+
+    std::vector<Range> m_ranges;
+    std::vector<MeshLods> m_meshLods; ///< of meshes added so far
+    VertexPacking::Layout m_layout;
+    gl::GLenum m_indexType;
+
+    std::vector<DrawElementsIndirectCommand> m_drawCommands;
+    std::vector<DrawElementsIndirectCommand> m_visibleCommands;
+    std::vector<BinaryMesh::Cluster> m_clusters;
+    std::vector<glm::mat4> m_dequantizations; ///< per draw, only without multi draw support
+    std::vector<gl::GLuint> m_meshIndices;    ///< per draw, only without multi draw support
+    std::vector<SeparateDrawUniforms> m_separateDrawUniforms;
+    std::vector<bool> m_visible;
+    BoundingVolumeHierarchy m_hierarchy;
+    bool m_hierarchyChanged;
+    bool m_frustumCulling;
+    bool m_coneCulling;
+    bool m_culledOnGpu;
+    unsigned int m_numVisible;
+};
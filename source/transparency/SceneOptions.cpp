@@ -0,0 +1,115 @@
+#include "SceneOptions.h"
+
+#include <gloperate/painter/Painter.h>
+
+
+SceneOptions::SceneOptions(gloperate::Painter & painter)
+:   m_backFaceCulling(false)
+,   m_frustumCulling(true)
+,   m_lodBias(0.0f)
+,   m_lodFreeze(false)
+,   m_visibleDraws(0u)
+,   m_culledDraws(0u)
+,   m_loadingProgress(100)
+{
+    painter.addProperty<bool>("back_face_culling", this,
+        &SceneOptions::backFaceCulling,
+        &SceneOptions::setBackFaceCulling);
+
+    painter.addProperty<bool>("frustum_culling", this,
+        &SceneOptions::frustumCulling,
+        &SceneOptions::setFrustumCulling);
+
+    painter.addProperty<float>("lod_bias", this,
+        &SceneOptions::lodBias,
+        &SceneOptions::setLodBias)->setOptions({
+        { "minimum", -4.0f },
+        { "maximum", 4.0f },
+        { "step", 0.5f },
+        { "precision", 1u }});
+
+    painter.addProperty<bool>("lod_freeze", this,
+        &SceneOptions::lodFreeze,
+        &SceneOptions::setLodFreeze);
+
+    painter.addProperty<unsigned int>("visible_draws", this,
+        &SceneOptions::visibleDraws);
+
+    painter.addProperty<unsigned int>("culled_draws", this,
+        &SceneOptions::culledDraws);
+
+    painter.addProperty<int>("loading_progress", this,
+        &SceneOptions::loadingProgress);
+}
+
+SceneOptions::~SceneOptions() = default;
+
+bool SceneOptions::backFaceCulling() const
+{
+    return m_backFaceCulling;
+}
+
+void SceneOptions::setBackFaceCulling(bool b)
+{
+    m_backFaceCulling = b;
+}
+
+bool SceneOptions::frustumCulling() const
+{
+    return m_frustumCulling;
+}
+
+void SceneOptions::setFrustumCulling(bool b)
+{
+    m_frustumCulling = b;
+}
+
+float SceneOptions::lodBias() const
+{
+    return m_lodBias;
+}
+
+void SceneOptions::setLodBias(float bias)
+{
+    m_lodBias = bias;
+}
+
+bool SceneOptions::lodFreeze() const
+{
+    return m_lodFreeze;
+}
+
+void SceneOptions::setLodFreeze(bool b)
+{
+    m_lodFreeze = b;
+}
+
+unsigned int SceneOptions::visibleDraws() const
+{
+    return m_visibleDraws;
+}
+
+void SceneOptions::setVisibleDraws(unsigned int count)
+{
+    m_visibleDraws = count;
+}
+
+unsigned int SceneOptions::culledDraws() const
+{
+    return m_culledDraws;
+}
+
+void SceneOptions::setCulledDraws(unsigned int count)
+{
+    m_culledDraws = count;
+}
+
+int SceneOptions::loadingProgress() const
+{
+    return m_loadingProgress;
+}
+
+void SceneOptions::setLoadingProgress(int percent)
+{
+    m_loadingProgress = percent;
+}
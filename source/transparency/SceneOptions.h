@@ -0,0 +1,57 @@
+#pragma once
+
+#include <reflectionzeug/PropertyGroup.h>
+
+
+namespace gloperate
+{
+    class Painter;
+}
+
+/**
+ *  @brief
+ *    Culling and level of detail properties of painters drawing a SceneDrawable
+ *
+ *  @remarks
+ *    The properties are registered on the painter, in the order they are declared here.
+ *    SceneDrawable::update() applies them and reports its statistics back.
+ */
+class SceneOptions
+{
+public:
+    SceneOptions(gloperate::Painter & painter);
+    ~SceneOptions();
+
+    bool backFaceCulling() const;
+    void setBackFaceCulling(bool b);
+
+    bool frustumCulling() const;
+    void setFrustumCulling(bool b);
+
+    /** Scales the tolerated screen space error of levels of detail by 2^bias */
+    float lodBias() const;
+    void setLodBias(float bias);
+
+    bool lodFreeze() const;
+    void setLodFreeze(bool b);
+
+    /** Statistics of the last frame, read-only properties */
+    unsigned int visibleDraws() const;
+    void setVisibleDraws(unsigned int count);
+
+    unsigned int culledDraws() const;
+    void setCulledDraws(unsigned int count);
+
+    /** Import progress of the scene in percent, 100 once no load is pending */
+    int loadingProgress() const;
+    void setLoadingProgress(int percent);
+
+private:
+    bool m_backFaceCulling;
+    bool m_frustumCulling;
+    float m_lodBias;
+    bool m_lodFreeze;
+    unsigned int m_visibleDraws;
+    unsigned int m_culledDraws;
+    int m_loadingProgress;
+};
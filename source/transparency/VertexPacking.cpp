@@ -0,0 +1,178 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+
+namespace
+{
+
+unsigned int positionSize(PositionFormat format)
+{
+    return format == PositionFormat::Float ? 3u * sizeof(float) : 4u * sizeof(uint16_t);
+}
+
+int32_t signExtend10(uint32_t value)
+{
+    return static_cast<int32_t>(value << 22u) >> 22;
+}
+
+}
+
+VertexPacking::Layout VertexPacking::layout(PositionFormat format, bool hasNormals)
+{
+    const auto size = positionSize(format);
+
+    auto layout = Layout{};
+    layout.stride = size + (hasNormals ? sizeof(uint32_t) : 0u);
+    layout.normalOffset = hasNormals ? size : 0u;
+
+    return layout;
+}
+
+std::vector<char> VertexPacking::interleave(
+    const glm::vec3 * vertices,
+    const glm::vec3 * normals,
+    unsigned int numVertices,
+    PositionFormat format,
+    glm::mat4 & dequantization)
+{
+    const auto vertexLayout = layout(format, normals != nullptr);
+    auto data = std::vector<char>(numVertices * vertexLayout.stride);
+
+    auto minimum = numVertices > 0u ? vertices[0] : glm::vec3{0.0f};
+    auto maximum = minimum;
+
+    for (auto i = 0u; i < numVertices; ++i)
+    {
+        minimum = glm::min(minimum, vertices[i]);
+        maximum = glm::max(maximum, vertices[i]);
+    }
+
+    const auto extent = glm::max(maximum - minimum, glm::vec3{std::numeric_limits<float>::min()});
+
+    switch (format)
+    {
+    case PositionFormat::Float:
+        dequantization = glm::mat4{1.0f};
+        break;
+    case PositionFormat::HalfFloat:
+        dequantization = glm::scale(glm::translate(glm::mat4{1.0f}, (minimum + maximum) * 0.5f), extent * 0.5f);
+        break;
+    case PositionFormat::Quantized:
+        dequantization = glm::scale(glm::translate(glm::mat4{1.0f}, minimum), extent);
+        break;
+    }
+
+    const auto center = (minimum + maximum) * 0.5f;
+
+    for (auto i = 0u; i < numVertices; ++i)
+    {
+        const auto vertex = data.data() + i * vertexLayout.stride;
+
+        if (format == PositionFormat::Float)
+        {
+            std::memcpy(vertex, &vertices[i], sizeof(glm::vec3));
+        }
+        else
+        {
+            uint16_t packed[4] = { 0u, 0u, 0u, 0u };
+
+            for (auto c = 0u; c < 3u; ++c)
+            {
+                if (format == PositionFormat::HalfFloat)
+                {
+                    packed[c] = packHalf((vertices[i][c] - center[c]) / (extent[c] * 0.5f));
+                }
+                else
+                {
+                    const auto normalized = glm::clamp((vertices[i][c] - minimum[c]) / extent[c], 0.0f, 1.0f);
+                    packed[c] = static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+                }
+            }
+
+            std::memcpy(vertex, packed, sizeof(packed));
+        }
+
+        if (normals)
+        {
+            const auto packed = packNormal(normals[i]);
+            std::memcpy(vertex + vertexLayout.normalOffset, &packed, sizeof(packed));
+        }
+    }
+
+    return data;
+}
+
+uint32_t VertexPacking::packNormal(const glm::vec3 & normal)
+{
+    auto packed = uint32_t{0u};
+
+    for (auto c = 0u; c < 3u; ++c)
+    {
+        const auto value = static_cast<int32_t>(std::lround(glm::clamp(normal[c], -1.0f, 1.0f) * 511.0f));
+        packed |= (static_cast<uint32_t>(value) & 0x3ffu) << (10u * c);
+    }
+
+    return packed;
+}
+
+glm::vec3 VertexPacking::unpackNormal(uint32_t packed)
+{
+    auto normal = glm::vec3{};
+
+    // Signed normalized conversion as in GL 4.2+: max(c / 511, -1)
+    for (auto c = 0u; c < 3u; ++c)
+        normal[c] = std::max(signExtend10(packed >> (10u * c)) / 511.0f, -1.0f);
+
+    return normal;
+}
+
+uint16_t VertexPacking::packHalf(float value)
+{
+    auto bits = uint32_t{0u};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const auto sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+    const auto exponent = static_cast<int32_t>((bits >> 23u) & 0xffu) - 127 + 15;
+    auto mantissa = bits & 0x7fffffu;
+
+    if (exponent >= 31)
+        return sign | 0x7c00u;
+
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return sign;
+
+        // Subnormal, make the implicit leading one explicit
+        mantissa |= 0x800000u;
+        const auto shift = static_cast<uint32_t>(14 - exponent);
+
+        return sign | static_cast<uint16_t>((mantissa + (1u << (shift - 1u))) >> shift);
+    }
+
+    // Round to nearest, a carry correctly propagates into the exponent
+    const auto half = (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+    return sign | static_cast<uint16_t>(half + ((mantissa >> 12u) & 1u));
+}
+
+float VertexPacking::unpackHalf(uint16_t packed)
+{
+    const auto sign = (packed & 0x8000u) ? -1.0f : 1.0f;
+    const auto exponent = static_cast<int>((packed >> 10u) & 0x1fu);
+    const auto mantissa = static_cast<float>(packed & 0x3ffu);
+
+    if (exponent == 0)
+        return sign * std::ldexp(mantissa, -24);
+
+    if (exponent == 31)
+        return sign * std::numeric_limits<float>::infinity();
+
+    return sign * std::ldexp(mantissa + 1024.0f, exponent - 25);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/fwd.hpp>
+
+
+enum class PositionFormat : unsigned int
+{
+    Float,      ///< 3 x 32 bit float
+    HalfFloat,  ///< 4 x 16 bit float, normalized to [-1, 1] around the bounding box center
+    Quantized   ///< 4 x 16 bit unsigned normalized, relative to the bounding box
+};
+
+/**
+ *  @brief
+ *    Converts positions and normals into a single interleaved vertex buffer
+ *
+ *  @remarks
+ *    Normals are stored as GL_INT_2_10_10_10_REV. Positions other than PositionFormat::Float
+ *    are compressed relative to the mesh bounds and restored in the vertex shader by the
+ *    dequantization transform.
+ */
+class VertexPacking
+{
+public:
+    struct Layout
+    {
+        unsigned int stride;
+        unsigned int normalOffset;  ///< 0 if there are no normals
+    };
+
+public:
+    static Layout layout(PositionFormat format, bool hasNormals);
+
+    /**
+     *  @param normals
+     *    May be nullptr
+     *
+     *  @param dequantization
+     *    Receives the transform from stored to original positions
+     */
+    static std::vector<char> interleave(
+        const glm::vec3 * vertices,
+        const glm::vec3 * normals,
+        unsigned int numVertices,
+        PositionFormat format,
+        glm::mat4 & dequantization);
+
+    static uint32_t packNormal(const glm::vec3 & normal);
+    static glm::vec3 unpackNormal(uint32_t packed);
+
+    static uint16_t packHalf(float value);
+    static float unpackHalf(uint16_t packed);
+};
@@ -0,0 +1,86 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+
+WorkerPool::WorkerPool(unsigned int numThreads)
+:   m_task{nullptr}
+,   m_generation{0u}
+,   m_numRunning{0u}
+,   m_quit{false}
+{
+    if (numThreads == 0u)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    m_threads.reserve(numThreads - 1u);
+
+    for (auto thread = 1u; thread < numThreads; ++thread)
+        m_threads.emplace_back(&WorkerPool::work, this, thread);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_quit = true;
+    }
+
+    m_started.notify_all();
+
+    for (auto & thread : m_threads)
+        thread.join();
+}
+
+unsigned int WorkerPool::numThreads() const
+{
+    return static_cast<unsigned int>(m_threads.size()) + 1u;
+}
+
+void WorkerPool::run(const std::function<void(unsigned int)> & task)
+{
+    if (m_threads.empty())
+    {
+        task(0u);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_task = &task;
+        m_numRunning = static_cast<unsigned int>(m_threads.size());
+        ++m_generation;
+    }
+
+    m_started.notify_all();
+
+    task(0u);
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_finished.wait(lock, [this] { return m_numRunning == 0u; });
+    m_task = nullptr;
+}
+
+void WorkerPool::work(unsigned int thread)
+{
+    auto generation = 0u;
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (true)
+    {
+        m_started.wait(lock, [this, generation] { return m_quit || m_generation != generation; });
+
+        if (m_quit)
+            return;
+
+        generation = m_generation;
+        const auto & task = *m_task;
+
+        lock.unlock();
+        task(thread);
+        lock.lock();
+
+        if (--m_numRunning == 0u)
+            m_finished.notify_one();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ *  @brief
+ *    Keeps threads alive between runs, for work split into many short parallel steps
+ *
+ *  @remarks
+ *    Unlike parallelFor(), no threads are created or joined per call.
+ */
+class WorkerPool
+{
+public:
+    /**
+     *  @param numThreads
+     *    Number of threads including the calling thread, 0 uses std::thread::hardware_concurrency()
+     */
+    explicit WorkerPool(unsigned int numThreads = 0u);
+
+    /** Blocks until the threads have finished */
+    ~WorkerPool();
+
+    unsigned int numThreads() const;
+
+    /**
+     *  @brief
+     *    Calls task(thread) once on each thread and blocks until all calls have returned
+     *
+     *  @remarks
+     *    The calling thread runs task(0u), run() must not be called concurrently.
+     */
+    void run(const std::function<void(unsigned int)> & task);
+
+protected:
+    void work(unsigned int thread);
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    std::condition_variable m_finished;
+
+    const std::function<void(unsigned int)> * m_task;
+    unsigned int m_generation;
+    unsigned int m_numRunning;
+    bool m_quit;
+};
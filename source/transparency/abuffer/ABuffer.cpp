@@ -0,0 +1,385 @@
+#include "ABuffer.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/DebugMessage.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/base/RenderTargetType.h>
+#include <gloperate/resources/ResourceManager.h>
+#include <gloperate/painter/TargetFramebufferCapability.h>
+#include <gloperate/painter/ViewportCapability.h>
+#include <gloperate/painter/PerspectiveProjectionCapability.h>
+#include <gloperate/painter/CameraCapability.h>
+#include <gloperate/primitives/AdaptiveGrid.h>
+#include <gloperate/primitives/ScreenAlignedQuad.h>
+
+#include <reflectionzeug/PropertyGroup.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../CounterReadback.h"
+#include "../MeshCache.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+using widgetzeug::make_unique;
+
+namespace
+{
+
+// Binding 0 is taken by the draw data of SceneDrawable
+const auto kFragmentPoolBinding = 1u;
+const auto kHeadPointersBinding = 2u;
+const auto kFragmentCounterBinding = 3u;
+
+const auto kEndOfList = 0xffffffffu;
+
+}
+
+const unsigned int ABuffer::s_maxFragmentsPerPixel;
+const unsigned int ABuffer::s_fragmentSize;
+
+ABuffer::ABuffer(gloperate::ResourceManager & resourceManager)
+:   Painter(resourceManager)
+,   m_targetFramebufferCapability(addCapability(new gloperate::TargetFramebufferCapability()))
+,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
+,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
+,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_supported(false)
+,   m_transparency(160u)
+,   m_poolSize(8u * 1024u * 1024u)
+,   m_poolSizeChanged(false)
+,   m_peakFragments(0u)
+,   m_droppedFragments(0u)
+{
+    setupPropertyGroup();
+}
+
+ABuffer::~ABuffer() = default;
+
+void ABuffer::setupPropertyGroup()
+{
+    addProperty<unsigned char>("transparency", this,
+        &ABuffer::transparency, &ABuffer::setTransparency)->setOptions({
+        { "minimum", 0 },
+        { "maximum", 255 },
+        { "step", 1 }});
+    
+    addProperty<unsigned int>("pool_size", this,
+        &ABuffer::poolSize, &ABuffer::setPoolSize)->setOptions({
+        { "minimum", 1024u * 1024u },
+        { "maximum", 64u * 1024u * 1024u },
+        { "step", 1024u * 1024u }});
+    
+    addProperty<unsigned int>("peak_fragments", this, &ABuffer::peakFragments);
+    
+    addProperty<unsigned int>("dropped_fragments", this, &ABuffer::droppedFragments);
+    
+    m_sceneOptions = make_unique<SceneOptions>(*this);
+}
+
+unsigned char ABuffer::transparency() const
+{
+    return m_transparency;
+}
+
+void ABuffer::setTransparency(unsigned char transparency)
+{
+    m_transparency = transparency;
+}
+
+unsigned int ABuffer::poolSize() const
+{
+    return m_poolSize;
+}
+
+void ABuffer::setPoolSize(unsigned int size)
+{
+    m_poolSizeChanged = m_poolSize != size;
+    m_poolSize = size;
+}
+
+unsigned int ABuffer::peakFragments() const
+{
+    return m_peakFragments;
+}
+
+unsigned int ABuffer::droppedFragments() const
+{
+    return m_droppedFragments;
+}
+
+void ABuffer::onInitialize()
+{
+    globjects::init();
+    globjects::DebugMessage::enable();
+
+#ifdef __APPLE__
+    Shader::clearGlobalReplacements();
+    Shader::globalReplace("#version 140", "#version 150");
+
+    debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
+#endif
+
+    m_supported = SceneDrawable::multiDrawSupported();
+
+    if (!m_supported)
+    {
+        std::cout << "ABuffer requires OpenGL 4.3 and GL_ARB_shader_draw_parameters" << std::endl;
+        return;
+    }
+
+    m_grid = make_ref<gloperate::AdaptiveGrid>();
+    m_grid->setColor({0.6f, 0.6f, 0.6f});
+
+    m_headPointers = make_ref<Buffer>();
+    m_fragmentCounter = make_ref<Buffer>();
+    
+    static const auto zero = GLuint{0u};
+    m_fragmentCounter->setData(sizeof(zero), &zero, GL_DYNAMIC_COPY);
+    m_counterReadback = make_unique<CounterReadback>();
+
+    setupPrograms();
+    setupProjection();
+    setupFramebuffer();
+    setupPool();
+    setupDrawable();
+}
+
+void ABuffer::onPaint()
+{
+    if (!m_supported)
+        return;
+    
+    if (m_viewportCapability->hasChanged())
+    {
+        glViewport(
+            m_viewportCapability->x(),
+            m_viewportCapability->y(),
+            m_viewportCapability->width(),
+            m_viewportCapability->height());
+
+        m_viewportCapability->setChanged(false);
+        
+        updateFramebuffer();
+    }
+    
+    if (m_poolSizeChanged)
+    {
+        m_poolSizeChanged = false;
+        setupPool();
+    }
+
+    updateStatistics();
+    
+    clearBuffers();
+    renderOpaqueGeometry();
+    m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
+    renderTransparentGeometry();
+    resolve();
+    
+    Framebuffer::unbind(GL_FRAMEBUFFER);
+}
+
+void ABuffer::setupFramebuffer()
+{
+    m_colorAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_depthAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    
+    updateFramebuffer();
+    
+    m_fbo = make_ref<Framebuffer>();
+    
+    m_fbo->attachTexture(GL_COLOR_ATTACHMENT0, m_colorAttachment);
+    m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
+    
+    m_fbo->printStatus(true);
+}
+
+void ABuffer::setupProjection()
+{
+    static const auto zNear = 0.3f, zFar = 30.f, fovy = 50.f;
+
+    m_projectionCapability->setZNear(zNear);
+    m_projectionCapability->setZFar(zFar);
+    m_projectionCapability->setFovy(radians(fovy));
+
+    m_grid->setNearFar(zNear, zFar);
+}
+
+void ABuffer::setupPrograms()
+{
+    static const auto shaderPath = std::string{"data/transparency/"};
+    
+    m_appendProgram = make_ref<Program>();
+    m_appendProgram->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, shaderPath + "abuffer.vert"),
+        Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + "abuffer.frag"));
+    
+    m_resolveProgram = make_ref<Program>();
+    m_resolveProgram->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, shaderPath + "compositing.vert"),
+        Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + "abuffer_resolve.frag"));
+    
+    m_resolveProgram->setUniform("opaqueColorTexture", 0);
+    
+    m_resolveQuad = make_ref<gloperate::ScreenAlignedQuad>(m_resolveProgram);
+}
+
+void ABuffer::setupDrawable()
+{
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
+}
+
+void ABuffer::setupPool()
+{
+    m_fragmentPool = make_ref<Buffer>();
+    m_fragmentPool->setData(static_cast<GLsizeiptr>(m_poolSize) * s_fragmentSize, nullptr, GL_DYNAMIC_COPY);
+    
+    m_appendProgram->setUniform("poolSize", m_poolSize);
+    
+    // Demand measured against a different pool is meaningless
+    m_peakFragments = 0u;
+    m_droppedFragments = 0u;
+    m_counterReadback->discard();
+}
+
+void ABuffer::updateFramebuffer()
+{
+    const auto width = m_viewportCapability->width(), height = m_viewportCapability->height();
+    
+    m_colorAttachment->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_depthAttachment->image2D(0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr);
+    
+    const auto numPixels = static_cast<GLsizeiptr>(width) * height;
+    m_headPointers->setData(numPixels * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    
+    m_appendProgram->setUniform("width", width);
+    m_resolveProgram->setUniform("width", width);
+}
+
+void ABuffer::updateStatistics()
+{
+    // Counter of an earlier frame, it keeps counting past the end of the pool
+    auto numFragments = GLuint{0u};
+    
+    if (m_counterReadback->read(numFragments))
+    {
+        m_peakFragments = std::max(m_peakFragments, numFragments);
+        m_droppedFragments = numFragments > m_poolSize ? numFragments - m_poolSize : 0u;
+    }
+    
+    static const auto zero = GLuint{0u};
+    m_fragmentCounter->setSubData(0, sizeof(zero), &zero);
+}
+
+void ABuffer::clearBuffers()
+{
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->setDrawBuffer(GL_COLOR_ATTACHMENT0);
+    
+    m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4(0.85f, 0.87f, 0.91f, 1.0f));
+    m_fbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
+    
+    m_headPointers->clearData(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &kEndOfList);
+}
+
+void ABuffer::renderOpaqueGeometry()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    m_fbo->bind(GL_FRAMEBUFFER);
+
+    m_grid->update(m_cameraCapability->eye(), m_projectionCapability->projection() * m_cameraCapability->view());
+    m_grid->draw();
+}
+
+void ABuffer::renderTransparentGeometry()
+{
+    // Fragments only end up in the lists, the depth test against opaque geometry happens early
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    
+    if (m_sceneOptions->backFaceCulling())
+        glEnable(GL_CULL_FACE);
+    
+    m_fbo->bind(GL_FRAMEBUFFER);
+    
+    m_fragmentPool->bindBase(GL_SHADER_STORAGE_BUFFER, kFragmentPoolBinding);
+    m_headPointers->bindBase(GL_SHADER_STORAGE_BUFFER, kHeadPointersBinding);
+    m_fragmentCounter->bindBase(GL_SHADER_STORAGE_BUFFER, kFragmentCounterBinding);
+    
+    m_appendProgram->use();
+    m_appendProgram->setUniform("transform", m_projectionCapability->projection() * m_cameraCapability->view());
+    m_appendProgram->setUniform("transparency", static_cast<unsigned int>(m_transparency));
+    
+    m_scene->draw(m_appendProgram);
+    
+    m_appendProgram->release();
+    
+    Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kFragmentCounterBinding);
+    
+    // The resolve reads the lists, the copy and the reset of the next frame access the counter
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    
+    m_counterReadback->copy(m_fragmentCounter);
+    
+    glDisable(GL_CULL_FACE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+}
+
+void ABuffer::resolve()
+{
+    glDisable(GL_DEPTH_TEST);
+    
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    targetfbo->bind(GL_FRAMEBUFFER);
+    
+    m_colorAttachment->bindActive(GL_TEXTURE0);
+    
+    m_resolveQuad->draw();
+    
+    Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kFragmentPoolBinding);
+    Buffer::unbind(GL_SHADER_STORAGE_BUFFER, kHeadPointersBinding);
+    
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+
+    m_fbo->blit(GL_COLOR_ATTACHMENT0, rect, targetfbo, drawBuffer, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
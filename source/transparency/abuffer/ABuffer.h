@@ -0,0 +1,124 @@
+#pragma once
+
+#include <memory>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <gloperate/painter/Painter.h>
+
+
+namespace globjects
+{
+    class Buffer;
+    class Framebuffer;
+    class Program;
+    class Texture;
+}
+
+namespace gloperate
+{
+    class AdaptiveGrid;
+    class ResourceManager;
+    class AbstractTargetFramebufferCapability;
+    class AbstractViewportCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractCameraCapability;
+    class ScreenAlignedQuad;
+}
+
+class CounterReadback;
+class SceneDrawable;
+class SceneOptions;
+
+/**
+ *  @brief
+ *    Exact order-independent transparency with per-pixel linked lists of fragments
+ *
+ *  @remarks
+ *    Transparent fragments are appended to a preallocated pool in a single geometry pass and
+ *    sorted per pixel during the resolve. Fragments that do not fit into the pool are dropped,
+ *    pixels with more than s_maxFragmentsPerPixel fragments keep the nearest ones.
+ */
+class ABuffer : public gloperate::Painter
+{
+public:
+    /** Has to match MAX_FRAGMENTS in abuffer_resolve.frag */
+    static const unsigned int s_maxFragmentsPerPixel = 32u;
+
+    /** Size of a pooled fragment in bytes, packed color, depth and next pointer */
+    static const unsigned int s_fragmentSize = 12u;
+
+public:
+    ABuffer(gloperate::ResourceManager & resourceManager);
+    virtual ~ABuffer();
+    
+public:
+    void setupPropertyGroup();
+    
+    unsigned char transparency() const;
+    void setTransparency(unsigned char transparency);
+    
+    /** Number of fragments the pool can hold */
+    unsigned int poolSize() const;
+    void setPoolSize(unsigned int size);
+    
+    /** Most fragments requested by a single frame since the pool has been resized */
+    unsigned int peakFragments() const;
+    
+    /** Fragments of the last frame that did not fit into the pool */
+    unsigned int droppedFragments() const;
+    
+protected:
+    virtual void onInitialize() override;
+    virtual void onPaint() override;
+
+protected:
+    void setupFramebuffer();
+    void setupProjection();
+    void setupPrograms();
+    void setupDrawable();
+    void setupPool();
+    void updateFramebuffer();
+    void updateStatistics();
+    
+protected:
+    void clearBuffers();
+    void renderOpaqueGeometry();
+    void renderTransparentGeometry();
+    void resolve();
+
+protected:
+    /* capabilities */
+    gloperate::AbstractTargetFramebufferCapability * m_targetFramebufferCapability;
+    gloperate::AbstractViewportCapability * m_viewportCapability;
+    gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
+    gloperate::AbstractCameraCapability * m_cameraCapability;
+    bool m_supported; ///< see SceneDrawable::multiDrawSupported()
+
+    /* framebuffers and textures */
+    globjects::ref_ptr<globjects::Framebuffer> m_fbo;
+    globjects::ref_ptr<globjects::Texture> m_colorAttachment;
+    globjects::ref_ptr<globjects::Texture> m_depthAttachment;
+    
+    /* fragment lists */
+    globjects::ref_ptr<globjects::Buffer> m_fragmentPool;
+    globjects::ref_ptr<globjects::Buffer> m_headPointers;
+    globjects::ref_ptr<globjects::Buffer> m_fragmentCounter;
+    std::unique_ptr<CounterReadback> m_counterReadback;
+    
+    /* programs and geometry */
+    globjects::ref_ptr<globjects::Program> m_appendProgram;
+    globjects::ref_ptr<globjects::Program> m_resolveProgram;
+    
+    globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_resolveQuad;
+    std::unique_ptr<SceneDrawable> m_scene;
+
+    /* properties */
+    unsigned char m_transparency;
+    unsigned int m_poolSize;
+    bool m_poolSizeChanged;
+    unsigned int m_peakFragments;
+    unsigned int m_droppedFragments;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
+};
@@ -0,0 +1,441 @@
+#include "MomentTransparency.h"
+
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/DebugMessage.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/base/RenderTargetType.h>
+#include <gloperate/resources/ResourceManager.h>
+#include <gloperate/painter/TargetFramebufferCapability.h>
+#include <gloperate/painter/ViewportCapability.h>
+#include <gloperate/painter/PerspectiveProjectionCapability.h>
+#include <gloperate/painter/CameraCapability.h>
+#include <gloperate/primitives/AdaptiveGrid.h>
+#include <gloperate/primitives/ScreenAlignedQuad.h>
+
+#include <reflectionzeug/PropertyGroup.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../MeshCache.h"
+#include "../PassTimer.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+using widgetzeug::make_unique;
+
+namespace
+{
+
+enum Pass { MomentsPass, ResolvePass, CompositingPass, NumPasses };
+
+// Moment biases for single precision targets as recommended in the paper, larger counts need more bias
+const auto kMomentBiasFour = 5e-7f;
+const auto kMomentBiasEight = 5e-5f;
+
+// Weight of the fragment itself in the reconstructed transmittance
+const auto kOverestimation = 0.25f;
+
+}
+
+MomentTransparency::MomentTransparency(gloperate::ResourceManager & resourceManager)
+:   Painter(resourceManager)
+,   m_targetFramebufferCapability(addCapability(new gloperate::TargetFramebufferCapability()))
+,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
+,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
+,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_multiDraw(false)
+,   m_transparency(160u)
+,   m_momentCount(MomentCount::Four)
+,   m_momentCountChanged(false)
+,   m_momentsTime(0.0f)
+,   m_resolveTime(0.0f)
+,   m_compositingTime(0.0f)
+,   m_bytesPerPixel(0u)
+{
+    setupPropertyGroup();
+}
+
+MomentTransparency::~MomentTransparency() = default;
+
+void MomentTransparency::setupPropertyGroup()
+{
+    addProperty<unsigned char>("transparency", this,
+        &MomentTransparency::transparency, &MomentTransparency::setTransparency)->setOptions({
+        { "minimum", 0 },
+        { "maximum", 255 },
+        { "step", 1 }});
+    
+    addProperty<MomentCount>("num_moments", this,
+        &MomentTransparency::momentCount, &MomentTransparency::setMomentCount)->setStrings({
+        { MomentCount::Four, "Four" },
+        { MomentCount::Eight, "Eight" }});
+    
+    addProperty<float>("moments_ms", this, &MomentTransparency::momentsTime);
+    
+    addProperty<float>("resolve_ms", this, &MomentTransparency::resolveTime);
+    
+    addProperty<float>("compositing_ms", this, &MomentTransparency::compositingTime);
+    
+    addProperty<unsigned int>("bytes_per_pixel", this, &MomentTransparency::bytesPerPixel);
+    
+    m_sceneOptions = make_unique<SceneOptions>(*this);
+}
+
+unsigned char MomentTransparency::transparency() const
+{
+    return m_transparency;
+}
+
+void MomentTransparency::setTransparency(unsigned char transparency)
+{
+    m_transparency = transparency;
+}
+
+MomentCount MomentTransparency::momentCount() const
+{
+    return m_momentCount;
+}
+
+void MomentTransparency::setMomentCount(MomentCount count)
+{
+    m_momentCountChanged = m_momentCount != count;
+    m_momentCount = count;
+}
+
+float MomentTransparency::momentsTime() const
+{
+    return m_momentsTime;
+}
+
+float MomentTransparency::resolveTime() const
+{
+    return m_resolveTime;
+}
+
+float MomentTransparency::compositingTime() const
+{
+    return m_compositingTime;
+}
+
+unsigned int MomentTransparency::bytesPerPixel() const
+{
+    return m_bytesPerPixel;
+}
+
+void MomentTransparency::onInitialize()
+{
+    globjects::init();
+    globjects::DebugMessage::enable();
+
+#ifdef __APPLE__
+    Shader::clearGlobalReplacements();
+    Shader::globalReplace("#version 140", "#version 150");
+
+    debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
+#endif
+
+    m_multiDraw = SceneDrawable::multiDrawSupported();
+
+    m_grid = make_ref<gloperate::AdaptiveGrid>();
+    m_grid->setColor({0.6f, 0.6f, 0.6f});
+    
+    m_timer = make_unique<PassTimer>(NumPasses);
+
+    setupPrograms();
+    setupProjection();
+    setupFramebuffer();
+    setupDrawable();
+}
+
+void MomentTransparency::onPaint()
+{
+    if (m_viewportCapability->hasChanged())
+    {
+        glViewport(
+            m_viewportCapability->x(),
+            m_viewportCapability->y(),
+            m_viewportCapability->width(),
+            m_viewportCapability->height());
+
+        m_viewportCapability->setChanged(false);
+        
+        updateFramebuffer();
+    }
+    
+    if (m_momentCountChanged)
+    {
+        m_momentCountChanged = false;
+        updateFramebuffer();
+    }
+
+    updateTimes();
+    
+    clearBuffers();
+    renderOpaqueGeometry();
+    m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
+    renderMoments();
+    renderResolve();
+    composite();
+    
+    Framebuffer::unbind(GL_FRAMEBUFFER);
+}
+
+void MomentTransparency::setupFramebuffer()
+{
+    m_opaqueColorAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_zerothMomentAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_momentsAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_higherMomentsAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_accumulationAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_depthAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    
+    m_fbo = make_ref<Framebuffer>();
+    
+    m_fbo->attachTexture(kOpaqueColorAttachment, m_opaqueColorAttachment);
+    m_fbo->attachTexture(kZerothMomentAttachment, m_zerothMomentAttachment);
+    m_fbo->attachTexture(kMomentsAttachment, m_momentsAttachment);
+    m_fbo->attachTexture(kAccumulationAttachment, m_accumulationAttachment);
+    m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
+    
+    updateFramebuffer();
+    
+    m_fbo->printStatus(true);
+}
+
+void MomentTransparency::setupProjection()
+{
+    static const auto zNear = 0.3f, zFar = 30.f, fovy = 50.f;
+
+    m_projectionCapability->setZNear(zNear);
+    m_projectionCapability->setZFar(zFar);
+    m_projectionCapability->setFovy(radians(fovy));
+
+    m_grid->setNearFar(zNear, zFar);
+}
+
+void MomentTransparency::setupPrograms()
+{
+    static const auto shaderPath = std::string{"data/transparency/"};
+    
+    const auto initProgram = [] (globjects::ref_ptr<globjects::Program> & program, const char * vertexShader, const char * fragmentShader)
+    {
+        program = make_ref<Program>();
+        program->attach(
+            Shader::fromFile(GL_VERTEX_SHADER, shaderPath + vertexShader),
+            Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + fragmentShader));
+    };
+    
+    // The legacy shader takes the draw data of each separate draw as uniforms
+    const auto momentsShader = m_multiDraw ? "moments.vert" : "moments_legacy.vert";
+    
+    initProgram(m_momentsProgram, momentsShader, "moments_generate.frag");
+    initProgram(m_resolveProgram, momentsShader, "moments_resolve.frag");
+    initProgram(m_compositingProgram, "compositing.vert", "moments_compositing.frag");
+    
+    m_resolveProgram->setUniform("zerothMomentTexture", 0);
+    m_resolveProgram->setUniform("momentsTexture", 1);
+    m_resolveProgram->setUniform("higherMomentsTexture", 2);
+    m_resolveProgram->setUniform("overestimation", kOverestimation);
+    
+    m_compositingProgram->setUniform("opaqueColorTexture", 0);
+    m_compositingProgram->setUniform("zerothMomentTexture", 1);
+    m_compositingProgram->setUniform("accumulationTexture", 2);
+    
+    m_compositingQuad = make_ref<gloperate::ScreenAlignedQuad>(m_compositingProgram);
+}
+
+void MomentTransparency::setupDrawable()
+{
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
+}
+
+void MomentTransparency::updateFramebuffer()
+{
+    const auto width = m_viewportCapability->width(), height = m_viewportCapability->height();
+    const auto eightMoments = m_momentCount == MomentCount::Eight;
+    
+    m_opaqueColorAttachment->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_zerothMomentAttachment->image2D(0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+    m_momentsAttachment->image2D(0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    m_accumulationAttachment->image2D(0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    m_depthAttachment->image2D(0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr);
+    
+    // Moments five to eight only take memory if used
+    if (eightMoments)
+    {
+        m_higherMomentsAttachment->image2D(0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        m_fbo->attachTexture(kHigherMomentsAttachment, m_higherMomentsAttachment);
+    }
+    else
+    {
+        m_fbo->detach(kHigherMomentsAttachment);
+        m_higherMomentsAttachment->image2D(0, GL_RGBA32F, 1, 1, 0, GL_RGBA, GL_FLOAT, nullptr);
+    }
+    
+    const auto numMoments = eightMoments ? 8 : 4;
+    
+    m_momentsProgram->setUniform("numMoments", numMoments);
+    m_resolveProgram->setUniform("numMoments", numMoments);
+    m_resolveProgram->setUniform("momentBias", eightMoments ? kMomentBiasEight : kMomentBiasFour);
+    
+    // opaque color, zeroth moment, moments, accumulation, depth
+    m_bytesPerPixel = 4u + 4u + 16u + 8u + 4u + (eightMoments ? 16u : 0u);
+}
+
+void MomentTransparency::updateTimes()
+{
+    m_timer->nextFrame();
+    
+    m_momentsTime = m_timer->milliseconds(MomentsPass);
+    m_resolveTime = m_timer->milliseconds(ResolvePass);
+    m_compositingTime = m_timer->milliseconds(CompositingPass);
+}
+
+void MomentTransparency::clearBuffers()
+{
+    m_fbo->setDrawBuffers({ kOpaqueColorAttachment, kZerothMomentAttachment, kMomentsAttachment, kAccumulationAttachment });
+    
+    m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4(0.85f, 0.87f, 0.91f, 1.0f));
+    m_fbo->clearBuffer(GL_COLOR, 1, glm::vec4(0.0f));
+    m_fbo->clearBuffer(GL_COLOR, 2, glm::vec4(0.0f));
+    m_fbo->clearBuffer(GL_COLOR, 3, glm::vec4(0.0f));
+    m_fbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
+    
+    if (m_momentCount == MomentCount::Eight)
+    {
+        m_fbo->setDrawBuffer(kHigherMomentsAttachment);
+        m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4(0.0f));
+    }
+}
+
+void MomentTransparency::renderOpaqueGeometry()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->setDrawBuffer(kOpaqueColorAttachment);
+
+    m_grid->update(m_cameraCapability->eye(), m_projectionCapability->projection() * m_cameraCapability->view());
+    m_grid->draw();
+}
+
+void MomentTransparency::renderMoments()
+{
+    const auto transform = m_projectionCapability->projection() * m_cameraCapability->view();
+    
+    m_timer->begin(MomentsPass);
+    
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    
+    if (m_sceneOptions->backFaceCulling())
+        glEnable(GL_CULL_FACE);
+    
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    
+    m_fbo->bind(GL_FRAMEBUFFER);
+    
+    if (m_momentCount == MomentCount::Eight)
+        m_fbo->setDrawBuffers({ kZerothMomentAttachment, kMomentsAttachment, kHigherMomentsAttachment });
+    else
+        m_fbo->setDrawBuffers({ kZerothMomentAttachment, kMomentsAttachment });
+    
+    m_momentsProgram->use();
+    m_momentsProgram->setUniform("transform", transform);
+    m_momentsProgram->setUniform("transparency", static_cast<unsigned int>(m_transparency));
+    m_momentsProgram->setUniform("zNear", m_projectionCapability->zNear());
+    m_momentsProgram->setUniform("zFar", m_projectionCapability->zFar());
+    
+    m_scene->draw(m_momentsProgram);
+    
+    m_momentsProgram->release();
+    
+    m_timer->end();
+}
+
+void MomentTransparency::renderResolve()
+{
+    const auto transform = m_projectionCapability->projection() * m_cameraCapability->view();
+    
+    m_timer->begin(ResolvePass);
+    
+    // Blending and culling state of renderMoments() still applies
+    m_fbo->setDrawBuffer(kAccumulationAttachment);
+    
+    m_zerothMomentAttachment->bindActive(GL_TEXTURE0);
+    m_momentsAttachment->bindActive(GL_TEXTURE1);
+    m_higherMomentsAttachment->bindActive(GL_TEXTURE2);
+    
+    m_resolveProgram->use();
+    m_resolveProgram->setUniform("transform", transform);
+    m_resolveProgram->setUniform("transparency", static_cast<unsigned int>(m_transparency));
+    m_resolveProgram->setUniform("zNear", m_projectionCapability->zNear());
+    m_resolveProgram->setUniform("zFar", m_projectionCapability->zFar());
+    
+    m_scene->draw(m_resolveProgram);
+    
+    m_resolveProgram->release();
+    
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    
+    m_timer->end();
+}
+
+void MomentTransparency::composite()
+{
+    m_timer->begin(CompositingPass);
+    
+    glDisable(GL_DEPTH_TEST);
+    
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    targetfbo->bind(GL_FRAMEBUFFER);
+    
+    m_opaqueColorAttachment->bindActive(GL_TEXTURE0);
+    m_zerothMomentAttachment->bindActive(GL_TEXTURE1);
+    m_accumulationAttachment->bindActive(GL_TEXTURE2);
+    
+    m_compositingQuad->draw();
+    
+    m_timer->end();
+    
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+
+    m_fbo->blit(kOpaqueColorAttachment, rect, targetfbo, drawBuffer, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <memory>
+
+#include <glbinding/gl/types.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <gloperate/painter/Painter.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+    class Program;
+    class Texture;
+}
+
+namespace gloperate
+{
+    class AdaptiveGrid;
+    class ResourceManager;
+    class AbstractTargetFramebufferCapability;
+    class AbstractViewportCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractCameraCapability;
+    class ScreenAlignedQuad;
+}
+
+class PassTimer;
+class SceneDrawable;
+class SceneOptions;
+
+enum class MomentCount { Four, Eight };
+
+/**
+ *  @brief
+ *    Moment-based order-independent transparency (Münstermann et al., 2018)
+ *
+ *  @remarks
+ *    The first geometry pass accumulates power moments of the logarithmically warped depth,
+ *    weighted by absorbance. The second pass reconstructs the transmittance in front of each
+ *    fragment from these moments and accumulates its color, which is composited in a full-screen
+ *    pass. Memory does not depend on a sample count, only on the number of moments.
+ */
+class MomentTransparency : public gloperate::Painter
+{
+public:
+    MomentTransparency(gloperate::ResourceManager & resourceManager);
+    virtual ~MomentTransparency();
+    
+public:
+    void setupPropertyGroup();
+    
+    unsigned char transparency() const;
+    void setTransparency(unsigned char transparency);
+    
+    MomentCount momentCount() const;
+    void setMomentCount(MomentCount count);
+    
+    /** GPU times of the passes in milliseconds, a few frames behind */
+    float momentsTime() const;
+    float resolveTime() const;
+    float compositingTime() const;
+    
+    /** Size of all render targets per pixel, including opaque color and depth */
+    unsigned int bytesPerPixel() const;
+    
+protected:
+    virtual void onInitialize() override;
+    virtual void onPaint() override;
+
+protected:
+    void setupFramebuffer();
+    void setupProjection();
+    void setupPrograms();
+    void setupDrawable();
+    void updateFramebuffer();
+    void updateTimes();
+    
+protected:
+    void clearBuffers();
+    void renderOpaqueGeometry();
+    void renderMoments();
+    void renderResolve();
+    void composite();
+
+protected:
+    /* capabilities */
+    gloperate::AbstractTargetFramebufferCapability * m_targetFramebufferCapability;
+    gloperate::AbstractViewportCapability * m_viewportCapability;
+    gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
+    gloperate::AbstractCameraCapability * m_cameraCapability;
+    bool m_multiDraw; ///< see SceneDrawable::multiDrawSupported(), selects the vertex shader
+
+    /* framebuffers and textures */
+    static const auto kOpaqueColorAttachment = gl::GL_COLOR_ATTACHMENT0;
+    static const auto kZerothMomentAttachment = gl::GL_COLOR_ATTACHMENT1;
+    static const auto kMomentsAttachment = gl::GL_COLOR_ATTACHMENT2;
+    static const auto kHigherMomentsAttachment = gl::GL_COLOR_ATTACHMENT3;
+    static const auto kAccumulationAttachment = gl::GL_COLOR_ATTACHMENT4;
+    
+    globjects::ref_ptr<globjects::Framebuffer> m_fbo;
+    globjects::ref_ptr<globjects::Texture> m_opaqueColorAttachment;
+    globjects::ref_ptr<globjects::Texture> m_zerothMomentAttachment;
+    globjects::ref_ptr<globjects::Texture> m_momentsAttachment;
+    globjects::ref_ptr<globjects::Texture> m_higherMomentsAttachment;
+    globjects::ref_ptr<globjects::Texture> m_accumulationAttachment;
+    globjects::ref_ptr<globjects::Texture> m_depthAttachment;
+    
+    /* programs and geometry */
+    globjects::ref_ptr<globjects::Program> m_momentsProgram;
+    globjects::ref_ptr<globjects::Program> m_resolveProgram;
+    globjects::ref_ptr<globjects::Program> m_compositingProgram;
+    std::unique_ptr<PassTimer> m_timer;
+    
+    globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_compositingQuad;
+    std::unique_ptr<SceneDrawable> m_scene;
+
+    /* properties */
+    unsigned char m_transparency;
+    MomentCount m_momentCount;
+    bool m_momentCountChanged;
+    float m_momentsTime;
+    float m_resolveTime;
+    float m_compositingTime;
+    unsigned int m_bytesPerPixel;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
+};
@@ -0,0 +1,407 @@
+#include "DualDepthPeeling.h"
+
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/DebugMessage.h>
+#include <globjects/Program.h>
+#include <globjects/Query.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/base/RenderTargetType.h>
+#include <gloperate/resources/ResourceManager.h>
+#include <gloperate/painter/TargetFramebufferCapability.h>
+#include <gloperate/painter/ViewportCapability.h>
+#include <gloperate/painter/PerspectiveProjectionCapability.h>
+#include <gloperate/painter/CameraCapability.h>
+#include <gloperate/primitives/AdaptiveGrid.h>
+#include <gloperate/primitives/ScreenAlignedQuad.h>
+
+#include <reflectionzeug/PropertyGroup.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../MeshCache.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+using widgetzeug::make_unique;
+
+namespace
+{
+
+const GLenum kDepthAttachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+const GLenum kFrontColorAttachments[] = { GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+const GLenum kBackLayerAttachments[] = { GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5 };
+
+// Depths are stored as (-near, far), so that max blending yields both at once
+const auto kEmptyDepth = glm::vec4(-1.0f);
+
+}
+
+DualDepthPeeling::DualDepthPeeling(gloperate::ResourceManager & resourceManager)
+:   Painter(resourceManager)
+,   m_targetFramebufferCapability(addCapability(new gloperate::TargetFramebufferCapability()))
+,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
+,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
+,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_transparency(160u)
+,   m_maxPeels(16u)
+,   m_occlusionQueries(true)
+,   m_peels(0u)
+{
+    setupPropertyGroup();
+}
+
+DualDepthPeeling::~DualDepthPeeling() = default;
+
+void DualDepthPeeling::setupPropertyGroup()
+{
+    addProperty<unsigned char>("transparency", this,
+        &DualDepthPeeling::transparency, &DualDepthPeeling::setTransparency)->setOptions({
+        { "minimum", 0 },
+        { "maximum", 255 },
+        { "step", 1 }});
+    
+    addProperty<unsigned int>("max_peels", this,
+        &DualDepthPeeling::maxPeels, &DualDepthPeeling::setMaxPeels)->setOptions({
+        { "minimum", 1u },
+        { "maximum", 64u }});
+    
+    addProperty<bool>("occlusion_queries", this,
+        &DualDepthPeeling::occlusionQueries, &DualDepthPeeling::setOcclusionQueries);
+    
+    addProperty<unsigned int>("peels", this, &DualDepthPeeling::peels);
+    
+    m_sceneOptions = make_unique<SceneOptions>(*this);
+}
+
+unsigned char DualDepthPeeling::transparency() const
+{
+    return m_transparency;
+}
+
+void DualDepthPeeling::setTransparency(unsigned char transparency)
+{
+    m_transparency = transparency;
+}
+
+unsigned int DualDepthPeeling::maxPeels() const
+{
+    return m_maxPeels;
+}
+
+void DualDepthPeeling::setMaxPeels(unsigned int count)
+{
+    m_maxPeels = count;
+}
+
+bool DualDepthPeeling::occlusionQueries() const
+{
+    return m_occlusionQueries;
+}
+
+void DualDepthPeeling::setOcclusionQueries(bool b)
+{
+    m_occlusionQueries = b;
+}
+
+unsigned int DualDepthPeeling::peels() const
+{
+    return m_peels;
+}
+
+void DualDepthPeeling::onInitialize()
+{
+    globjects::init();
+    globjects::DebugMessage::enable();
+
+#ifdef __APPLE__
+    Shader::clearGlobalReplacements();
+    Shader::globalReplace("#version 140", "#version 150");
+
+    debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
+#endif
+
+    m_grid = make_ref<gloperate::AdaptiveGrid>();
+    m_grid->setColor({0.6f, 0.6f, 0.6f});
+    
+    m_query = make_ref<Query>();
+
+    setupPrograms();
+    setupProjection();
+    setupFramebuffers();
+    setupDrawable();
+}
+
+void DualDepthPeeling::onPaint()
+{
+    if (m_viewportCapability->hasChanged())
+    {
+        glViewport(
+            m_viewportCapability->x(),
+            m_viewportCapability->y(),
+            m_viewportCapability->width(),
+            m_viewportCapability->height());
+
+        m_viewportCapability->setChanged(false);
+        
+        updateFramebuffers();
+    }
+
+    renderOpaqueGeometry();
+    m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
+    peel();
+    composite();
+    
+    Framebuffer::unbind(GL_FRAMEBUFFER);
+}
+
+void DualDepthPeeling::setupFramebuffers()
+{
+    const auto createTexture = [] ()
+    {
+        auto texture = Texture::createDefault(GL_TEXTURE_2D);
+        texture->setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        texture->setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        return texture;
+    };
+    
+    m_backColorAttachment = createTexture();
+    m_depthAttachment = createTexture();
+    
+    for (auto i = 0u; i < 2u; ++i)
+    {
+        m_depthTextures[i] = createTexture();
+        m_frontColorTextures[i] = createTexture();
+        m_backLayerTextures[i] = createTexture();
+    }
+    
+    updateFramebuffers();
+    
+    m_opaqueFbo = make_ref<Framebuffer>();
+    m_opaqueFbo->attachTexture(GL_COLOR_ATTACHMENT0, m_backColorAttachment);
+    m_opaqueFbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
+    m_opaqueFbo->printStatus(true);
+    
+    // No depth attachment, the opaque depth is sampled instead, since depth testing is replaced by blending
+    m_peelingFbo = make_ref<Framebuffer>();
+    
+    for (auto i = 0u; i < 2u; ++i)
+    {
+        m_peelingFbo->attachTexture(kDepthAttachments[i], m_depthTextures[i]);
+        m_peelingFbo->attachTexture(kFrontColorAttachments[i], m_frontColorTextures[i]);
+        m_peelingFbo->attachTexture(kBackLayerAttachments[i], m_backLayerTextures[i]);
+    }
+    
+    m_peelingFbo->printStatus(true);
+}
+
+void DualDepthPeeling::setupProjection()
+{
+    static const auto zNear = 0.3f, zFar = 30.f, fovy = 50.f;
+
+    m_projectionCapability->setZNear(zNear);
+    m_projectionCapability->setZFar(zFar);
+    m_projectionCapability->setFovy(radians(fovy));
+
+    m_grid->setNearFar(zNear, zFar);
+}
+
+void DualDepthPeeling::setupPrograms()
+{
+    static const auto shaderPath = std::string{"data/transparency/"};
+    
+    const auto initProgram = [] (globjects::ref_ptr<globjects::Program> & program, const char * vertexShader, const char * fragmentShader)
+    {
+        program = make_ref<Program>();
+        program->attach(
+            Shader::fromFile(GL_VERTEX_SHADER, shaderPath + vertexShader),
+            Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + fragmentShader));
+    };
+    
+    // The legacy shader takes the dequantization of each separate draw as uniform
+    const auto peelingShader = SceneDrawable::multiDrawSupported() ? "dual_peeling.vert" : "dual_peeling_legacy.vert";
+    
+    initProgram(m_initProgram, peelingShader, "dual_peeling_init.frag");
+    initProgram(m_peelProgram, peelingShader, "dual_peeling_peel.frag");
+    initProgram(m_blendProgram, "compositing.vert", "dual_peeling_blend.frag");
+    initProgram(m_compositingProgram, "compositing.vert", "dual_peeling_compositing.frag");
+    
+    m_initProgram->setUniform("opaqueDepthTexture", 3);
+    
+    m_peelProgram->setUniform("depthTexture", 1);
+    m_peelProgram->setUniform("frontColorTexture", 2);
+    m_peelProgram->setUniform("opaqueDepthTexture", 3);
+    
+    m_blendProgram->setUniform("backLayerTexture", 0);
+    
+    m_compositingProgram->setUniform("frontColorTexture", 0);
+    m_compositingProgram->setUniform("backColorTexture", 1);
+    
+    m_blendQuad = make_ref<gloperate::ScreenAlignedQuad>(m_blendProgram);
+    m_compositingQuad = make_ref<gloperate::ScreenAlignedQuad>(m_compositingProgram);
+}
+
+void DualDepthPeeling::setupDrawable()
+{
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
+}
+
+void DualDepthPeeling::updateFramebuffers()
+{
+    const auto width = m_viewportCapability->width(), height = m_viewportCapability->height();
+    
+    m_backColorAttachment->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_depthAttachment->image2D(0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr);
+    
+    for (auto i = 0u; i < 2u; ++i)
+    {
+        m_depthTextures[i]->image2D(0, GL_RG32F, width, height, 0, GL_RG, GL_FLOAT, nullptr);
+        m_frontColorTextures[i]->image2D(0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        m_backLayerTextures[i]->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+}
+
+void DualDepthPeeling::renderOpaqueGeometry()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    m_opaqueFbo->bind(GL_FRAMEBUFFER);
+    m_opaqueFbo->setDrawBuffer(GL_COLOR_ATTACHMENT0);
+    
+    m_opaqueFbo->clearBuffer(GL_COLOR, 0, glm::vec4(0.85f, 0.87f, 0.91f, 1.0f));
+    m_opaqueFbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
+
+    m_grid->update(m_cameraCapability->eye(), m_projectionCapability->projection() * m_cameraCapability->view());
+    m_grid->draw();
+}
+
+void DualDepthPeeling::peel()
+{
+    const auto transform = m_projectionCapability->projection() * m_cameraCapability->view();
+    
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    
+    if (m_sceneOptions->backFaceCulling())
+        glEnable(GL_CULL_FACE);
+    
+    m_depthAttachment->bindActive(GL_TEXTURE3);
+    
+    // Initial min-max depth of all transparent fragments in front of opaque geometry
+    m_peelingFbo->bind(GL_FRAMEBUFFER);
+    m_peelingFbo->setDrawBuffers({ kDepthAttachments[0], kFrontColorAttachments[0] });
+    m_peelingFbo->clearBuffer(GL_COLOR, 0, kEmptyDepth);
+    m_peelingFbo->clearBuffer(GL_COLOR, 1, glm::vec4(0.0f));
+    m_peelingFbo->setDrawBuffer(kDepthAttachments[0]);
+    
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_MAX);
+    
+    m_initProgram->use();
+    m_initProgram->setUniform("transform", transform);
+    
+    m_scene->draw(m_initProgram);
+    
+    m_initProgram->release();
+    
+    m_peelProgram->setUniform("transform", transform);
+    m_peelProgram->setUniform("transparency", static_cast<unsigned int>(m_transparency));
+    
+    auto current = 0u;
+    m_peels = 0u;
+    
+    while (m_peels < m_maxPeels)
+    {
+        const auto previous = current;
+        current = 1u - current;
+        ++m_peels;
+        
+        // Peel nearest and farthest layer, the front layer is composited right away
+        m_peelingFbo->bind(GL_FRAMEBUFFER);
+        m_peelingFbo->setDrawBuffers({ kDepthAttachments[current], kFrontColorAttachments[current], kBackLayerAttachments[current] });
+        m_peelingFbo->clearBuffer(GL_COLOR, 0, kEmptyDepth);
+        m_peelingFbo->clearBuffer(GL_COLOR, 1, glm::vec4(0.0f));
+        m_peelingFbo->clearBuffer(GL_COLOR, 2, glm::vec4(0.0f));
+        
+        glBlendEquation(GL_MAX);
+        
+        m_depthTextures[previous]->bindActive(GL_TEXTURE1);
+        m_frontColorTextures[previous]->bindActive(GL_TEXTURE2);
+        
+        m_peelProgram->use();
+        m_scene->draw(m_peelProgram);
+        m_peelProgram->release();
+        
+        // Blend the back layer under the ones peeled before, empty pixels are discarded
+        m_opaqueFbo->bind(GL_FRAMEBUFFER);
+        
+        glBlendEquation(GL_FUNC_ADD);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        
+        m_backLayerTextures[current]->bindActive(GL_TEXTURE0);
+        
+        if (m_occlusionQueries)
+            m_query->begin(GL_SAMPLES_PASSED);
+        
+        m_blendQuad->draw();
+        
+        if (m_occlusionQueries)
+            m_query->end(GL_SAMPLES_PASSED);
+        
+        // A single remaining layer ends up in front, so an empty back layer means nothing is left
+        if (m_occlusionQueries && m_query->get(GL_QUERY_RESULT) == 0u)
+            break;
+    }
+    
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+}
+
+void DualDepthPeeling::composite()
+{
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    targetfbo->bind(GL_FRAMEBUFFER);
+    
+    // Every peel swaps the ping-pong targets, starting from the ones of the initial pass
+    m_frontColorTextures[m_peels % 2u]->bindActive(GL_TEXTURE0);
+    m_backColorAttachment->bindActive(GL_TEXTURE1);
+    
+    m_compositingQuad->draw();
+    
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+
+    m_opaqueFbo->blit(GL_COLOR_ATTACHMENT0, rect, targetfbo, drawBuffer, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <gloperate/painter/Painter.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+    class Program;
+    class Query;
+    class Texture;
+}
+
+namespace gloperate
+{
+    class AdaptiveGrid;
+    class ResourceManager;
+    class AbstractTargetFramebufferCapability;
+    class AbstractViewportCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractCameraCapability;
+    class ScreenAlignedQuad;
+}
+
+class SceneDrawable;
+class SceneOptions;
+
+/**
+ *  @brief
+ *    Exact order-independent transparency by dual depth peeling (Bavoil and Myers, 2008)
+ *
+ *  @remarks
+ *    Each peel extracts the nearest and the farthest remaining layer at once, using min-max
+ *    blending instead of a depth test. An occlusion query on the blending of the back layer
+ *    ends peeling as soon as no fragments remain, max_peels bounds the number of peels.
+ *    Contexts without multi draw support are served by the separate draws of SceneDrawable.
+ */
+class DualDepthPeeling : public gloperate::Painter
+{
+public:
+    DualDepthPeeling(gloperate::ResourceManager & resourceManager);
+    virtual ~DualDepthPeeling();
+    
+public:
+    void setupPropertyGroup();
+    
+    unsigned char transparency() const;
+    void setTransparency(unsigned char transparency);
+    
+    unsigned int maxPeels() const;
+    void setMaxPeels(unsigned int count);
+    
+    /** Without occlusion queries, max_peels peels are always rendered */
+    bool occlusionQueries() const;
+    void setOcclusionQueries(bool b);
+    
+    /** Statistics of the last frame */
+    unsigned int peels() const;
+    
+protected:
+    virtual void onInitialize() override;
+    virtual void onPaint() override;
+
+protected:
+    void setupFramebuffers();
+    void setupProjection();
+    void setupPrograms();
+    void setupDrawable();
+    void updateFramebuffers();
+    
+protected:
+    void renderOpaqueGeometry();
+    void peel();
+    void composite();
+
+protected:
+    /* capabilities */
+    gloperate::AbstractTargetFramebufferCapability * m_targetFramebufferCapability;
+    gloperate::AbstractViewportCapability * m_viewportCapability;
+    gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
+    gloperate::AbstractCameraCapability * m_cameraCapability;
+
+    /* framebuffers and textures */
+    
+    /** Opaque color, back layers are blended into it */
+    globjects::ref_ptr<globjects::Framebuffer> m_opaqueFbo;
+    globjects::ref_ptr<globjects::Texture> m_backColorAttachment;
+    globjects::ref_ptr<globjects::Texture> m_depthAttachment;
+    
+    /** Ping-pong targets of the peels, min-max depth, accumulated front color and current back layer */
+    globjects::ref_ptr<globjects::Framebuffer> m_peelingFbo;
+    std::array<globjects::ref_ptr<globjects::Texture>, 2u> m_depthTextures;
+    std::array<globjects::ref_ptr<globjects::Texture>, 2u> m_frontColorTextures;
+    std::array<globjects::ref_ptr<globjects::Texture>, 2u> m_backLayerTextures;
+    
+    /* programs and geometry */
+    globjects::ref_ptr<globjects::Program> m_initProgram;
+    globjects::ref_ptr<globjects::Program> m_peelProgram;
+    globjects::ref_ptr<globjects::Program> m_blendProgram;
+    globjects::ref_ptr<globjects::Program> m_compositingProgram;
+    globjects::ref_ptr<globjects::Query> m_query;
+    
+    globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_blendQuad;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_compositingQuad;
+    std::unique_ptr<SceneDrawable> m_scene;
+
+    /* properties */
+    unsigned char m_transparency;
+    unsigned int m_maxPeels;
+    bool m_occlusionQueries;
+    unsigned int m_peels;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
+};
@@ -1,7 +1,12 @@
 #include <gloperate/plugin/plugin_api.h>
 
+#include "abuffer/ABuffer.h"
+#include "moments/MomentTransparency.h"
+#include "peeling/DualDepthPeeling.h"
 #include "screendoor/ScreenDoor.h"
+#include "sorted/SortedBlending.h"
 #include "stochastic/StochasticTransparency.h"
+#include "weighted/WeightedBlended.h"
 
 #include <glexamples-version.h>
 
@@ -19,4 +24,34 @@ GLOPERATE_PLUGIN_LIBRARY
     , GLEXAMPLES_AUTHOR_ORGANIZATION
     , "v1.0.0" )
 
+    GLOPERATE_PLUGIN(SortedBlending
+    , "SortedBlending"
+    , "Sorted Blending Transparency"
+    , GLEXAMPLES_AUTHOR_ORGANIZATION
+    , "v1.0.0" )
+
+    GLOPERATE_PLUGIN(WeightedBlended
+    , "WeightedBlended"
+    , "Weighted Blended Order-Independent Transparency"
+    , GLEXAMPLES_AUTHOR_ORGANIZATION
+    , "v1.0.0" )
+
+    GLOPERATE_PLUGIN(ABuffer
+    , "ABuffer"
+    , "A-Buffer Transparency"
+    , GLEXAMPLES_AUTHOR_ORGANIZATION
+    , "v1.0.0" )
+
+    GLOPERATE_PLUGIN(DualDepthPeeling
+    , "DualDepthPeeling"
+    , "Dual Depth Peeling Transparency"
+    , GLEXAMPLES_AUTHOR_ORGANIZATION
+    , "v1.0.0" )
+
+    GLOPERATE_PLUGIN(MomentTransparency
+    , "MomentTransparency"
+    , "Moment-Based Order-Independent Transparency"
+    , GLEXAMPLES_AUTHOR_ORGANIZATION
+    , "v1.0.0" )
+
 GLOPERATE_PLUGIN_LIBRARY_END
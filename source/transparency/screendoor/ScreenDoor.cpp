@@ -25,14 +25,15 @@
 #include <gloperate/painter/PerspectiveProjectionCapability.h>
 #include <gloperate/painter/CameraCapability.h>
 #include <gloperate/primitives/AdaptiveGrid.h>
-#include <gloperate/primitives/Scene.h>
-#include <gloperate/primitives/PolygonalDrawable.h>
-#include <gloperate/primitives/PolygonalGeometry.h>
 
 #include <reflectionzeug/PropertyGroup.h>
 
 #include <widgetzeug/make_unique.hpp>
 
+#include "../MeshCache.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
 
 using namespace gl;
 using namespace glm;
@@ -46,6 +47,7 @@ ScreenDoor::ScreenDoor(gloperate::ResourceManager & resourceManager)
 ,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
 ,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
 ,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_multiDraw(false)
 ,   m_multisampling(false)
 ,   m_multisamplingChanged(false)
 ,   m_transparency(0.5)
@@ -66,6 +68,8 @@ void ScreenDoor::setupPropertyGroup()
         { "maximum", 1.0f },
         { "step", 0.1f },
         { "precision", 1u }});
+    
+    m_sceneOptions = make_unique<SceneOptions>(*this);
 }
 
 bool ScreenDoor::multisampling() const
@@ -101,6 +105,8 @@ void ScreenDoor::onInitialize()
     debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
 #endif
 
+    m_multiDraw = SceneDrawable::multiDrawSupported();
+
     m_grid = make_ref<gloperate::AdaptiveGrid>();
     m_grid->setColor({0.6f, 0.6f, 0.6f});
 
@@ -132,6 +138,8 @@ void ScreenDoor::onPaint()
         updateFramebuffer();
     }
 
+    m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
+
     m_fbo->bind(GL_FRAMEBUFFER);
     m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4{0.85f, 0.87f, 0.91f, 1.0f});
     m_fbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
@@ -147,17 +155,18 @@ void ScreenDoor::onPaint()
     glEnable(GL_SAMPLE_SHADING);
     glMinSampleShading(1.0);
     
+    if (m_sceneOptions->backFaceCulling())
+        glEnable(GL_CULL_FACE);
+    
     m_program->use();
     m_program->setUniform(m_transformLocation, transform);
+    m_program->setUniform(m_transparencyLocation, m_transparency);
     
-    for (auto i = 0u; i < m_drawables.size(); ++i)
-    {
-        m_program->setUniform(m_transparencyLocation, i % 2 == 0 ? m_transparency : 1.0f);
-        m_drawables[i]->draw();
-    }
+    m_scene->draw(m_program);
     
     m_program->release();
     
+    glDisable(GL_CULL_FACE);
     glDisable(GL_SAMPLE_SHADING);
     glMinSampleShading(0.0);
 
@@ -220,21 +229,8 @@ void ScreenDoor::setupProjection()
 
 void ScreenDoor::setupDrawable()
 {
-    // Load scene
-    const auto scene = m_resourceManager.load<gloperate::Scene>("data/transparency/transparency_scene.obj");
-    if (!scene)
-    {
-        std::cout << "Could not load file" << std::endl;
-        return;
-    }
-
-    // Create a renderable for each mesh
-    for (const auto * geometry : scene->meshes()) {
-        m_drawables.push_back(gloperate::make_unique<gloperate::PolygonalDrawable>(*geometry));
-    }
-
-    // Release scene
-    delete scene;
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
 }
 
 void ScreenDoor::setupProgram()
@@ -242,7 +238,7 @@ void ScreenDoor::setupProgram()
     static const auto shaderPath = std::string{"data/transparency/"};
     const auto shaderName = m_multisampling ? "screendoor_multisample" : "screendoor";
     
-    const auto vertexShader = shaderPath + shaderName + ".vert";
+    const auto vertexShader = shaderPath + shaderName + (m_multiDraw ? ".vert" : "_legacy.vert");
     const auto fragmentShader = shaderPath + shaderName + ".frag";
     
     m_program = make_ref<Program>();
@@ -26,9 +26,11 @@ namespace gloperate
     class AbstractViewportCapability;
     class AbstractPerspectiveProjectionCapability;
     class AbstractCameraCapability;
-    class PolygonalDrawable;
 }
 
+class SceneDrawable;
+class SceneOptions;
+
 
 class ScreenDoor : public gloperate::Painter
 {
@@ -62,6 +64,7 @@ protected:
     gloperate::AbstractViewportCapability * m_viewportCapability;
     gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
     gloperate::AbstractCameraCapability * m_cameraCapability;
+    bool m_multiDraw; ///< see SceneDrawable::multiDrawSupported(), selects the vertex shaders
 
     /* members */
     globjects::ref_ptr<globjects::Framebuffer> m_fbo;
@@ -72,9 +75,10 @@ protected:
     globjects::ref_ptr<globjects::Program> m_program;
     gl::GLint m_transformLocation;
     gl::GLint m_transparencyLocation;
-    std::vector<std::unique_ptr<gloperate::PolygonalDrawable>> m_drawables;
+    std::unique_ptr<SceneDrawable> m_scene;
 
     bool m_multisampling;
     bool m_multisamplingChanged;
     float m_transparency;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
 };
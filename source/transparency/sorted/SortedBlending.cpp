@@ -0,0 +1,310 @@
+#include "SortedBlending.h"
+
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/DebugMessage.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/base/RenderTargetType.h>
+#include <gloperate/resources/ResourceManager.h>
+#include <gloperate/painter/TargetFramebufferCapability.h>
+#include <gloperate/painter/ViewportCapability.h>
+#include <gloperate/painter/PerspectiveProjectionCapability.h>
+#include <gloperate/painter/CameraCapability.h>
+#include <gloperate/primitives/AdaptiveGrid.h>
+
+#include <reflectionzeug/PropertyGroup.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../AsyncMeshLoader.h"
+#include "../BinaryMesh.h"
+#include "../MeshCache.h"
+#include "../PolygonalDrawable.h"
+#include "../PolygonalGeometry.h"
+
+#include "TriangleSorter.h"
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+using widgetzeug::make_unique;
+
+namespace
+{
+
+/** Merges the finest level of detail of all meshes, meshes without normals get zero normals */
+PolygonalGeometry merge(const BinaryMesh & mesh)
+{
+    auto indices = std::vector<unsigned int>{};
+    auto vertices = std::vector<glm::vec3>{};
+    auto normals = std::vector<glm::vec3>{};
+
+    for (auto i = 0u; i < mesh.numMeshes(); ++i)
+    {
+        const auto baseVertex = static_cast<unsigned int>(vertices.size());
+        const auto meshIndices = mesh.indices(i);
+        const auto numIndices = mesh.lods(i)[0].numIndices;
+
+        for (auto j = 0u; j < numIndices; ++j)
+            indices.push_back(baseVertex + meshIndices[j]);
+
+        vertices.insert(vertices.end(), mesh.vertices(i), mesh.vertices(i) + mesh.numVertices(i));
+
+        if (mesh.normals(i))
+            normals.insert(normals.end(), mesh.normals(i), mesh.normals(i) + mesh.numVertices(i));
+        else
+            normals.resize(vertices.size(), glm::vec3{0.0f});
+    }
+
+    auto geometry = PolygonalGeometry{};
+    geometry.setIndices(std::move(indices));
+    geometry.setVertices(std::move(vertices));
+    geometry.setNormals(std::move(normals));
+
+    return geometry;
+}
+
+}
+
+SortedBlending::SortedBlending(gloperate::ResourceManager & resourceManager)
+:   Painter(resourceManager)
+,   m_targetFramebufferCapability(addCapability(new gloperate::TargetFramebufferCapability()))
+,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
+,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
+,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_sortingRequired(true)
+,   m_transparency(0.5f)
+,   m_sortThreads(0u)
+{
+    setupPropertyGroup();
+}
+
+SortedBlending::~SortedBlending() = default;
+
+void SortedBlending::setupPropertyGroup()
+{
+    addProperty<float>("transparency", this,
+        &SortedBlending::transparency, &SortedBlending::setTransparency)->setOptions({
+        { "minimum", 0.0f },
+        { "maximum", 1.0f },
+        { "step", 0.1f },
+        { "precision", 1u }});
+    
+    addProperty<unsigned int>("sort_threads", this,
+        &SortedBlending::sortThreads, &SortedBlending::setSortThreads);
+}
+
+float SortedBlending::transparency() const
+{
+    return m_transparency;
+}
+
+void SortedBlending::setTransparency(float transparency)
+{
+    m_transparency = transparency;
+}
+
+unsigned int SortedBlending::sortThreads() const
+{
+    return m_sortThreads;
+}
+
+void SortedBlending::setSortThreads(unsigned int numThreads)
+{
+    m_sortThreads = numThreads;
+
+    if (m_sorter)
+        m_sorter->setNumThreads(numThreads);
+}
+
+void SortedBlending::onInitialize()
+{
+    globjects::init();
+    globjects::DebugMessage::enable();
+
+#ifdef __APPLE__
+    Shader::clearGlobalReplacements();
+    Shader::globalReplace("#version 140", "#version 150");
+
+    debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
+#endif
+
+    m_grid = make_ref<gloperate::AdaptiveGrid>();
+    m_grid->setColor({0.6f, 0.6f, 0.6f});
+
+    setupDrawable();
+    setupProgram();
+    setupProjection();
+    setupFramebuffer();
+}
+
+void SortedBlending::onPaint()
+{
+    if (m_viewportCapability->hasChanged())
+    {
+        glViewport(
+            m_viewportCapability->x(),
+            m_viewportCapability->y(),
+            m_viewportCapability->width(),
+            m_viewportCapability->height());
+
+        m_viewportCapability->setChanged(false);
+        
+        updateFramebuffer();
+    }
+
+    updateDrawable();
+
+    const auto view = m_cameraCapability->view();
+    const auto transform = m_projectionCapability->projection() * view;
+    const auto eye = m_cameraCapability->eye();
+
+    sortTriangles(view);
+
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4{0.85f, 0.87f, 0.91f, 1.0f});
+    m_fbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
+    
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    m_grid->update(eye, transform);
+    m_grid->draw();
+    
+    if (m_drawable)
+    {
+        // Transparent geometry is depth tested against the opaque grid, but does not occlude itself
+        glDepthMask(GL_FALSE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        
+        m_program->use();
+        m_program->setUniform("transform", transform);
+        m_program->setUniform("transparency", m_transparency);
+        
+        m_drawable->draw();
+        
+        m_program->release();
+        
+        glDisable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+    }
+
+    Framebuffer::unbind(GL_FRAMEBUFFER);
+    
+    const auto rect = std::array<gl::GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()}};
+    
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = globjects::Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    m_fbo->blit(GL_COLOR_ATTACHMENT0, rect, targetfbo, drawBuffer, rect,
+        GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+void SortedBlending::setupFramebuffer()
+{
+    m_colorAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_depthAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    
+    m_fbo = make_ref<Framebuffer>();
+
+    m_fbo->attachTexture(GL_COLOR_ATTACHMENT0, m_colorAttachment);
+    m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
+    
+    updateFramebuffer();
+    
+    m_fbo->printStatus(true);
+}
+
+void SortedBlending::setupProjection()
+{
+    static const auto zNear = 0.3f, zFar = 30.f, fovy = 50.f;
+
+    m_projectionCapability->setZNear(zNear);
+    m_projectionCapability->setZFar(zFar);
+    m_projectionCapability->setFovy(radians(fovy));
+
+    m_grid->setNearFar(zNear, zFar);
+}
+
+void SortedBlending::setupDrawable()
+{
+    // Load scene in the background, the grid is rendered in the meantime
+    m_meshLoader = make_unique<AsyncMeshLoader>("data/transparency/transparency_scene.obj",
+        MeshCache{"data/transparency/cache", true});
+}
+
+void SortedBlending::updateDrawable()
+{
+    if (!m_meshLoader || !m_meshLoader->isFinished())
+        return;
+
+    const auto mesh = m_meshLoader->takeMesh();
+    m_meshLoader.reset();
+
+    if (!mesh)
+    {
+        std::cout << "Could not load file" << std::endl;
+        return;
+    }
+
+    // Vertices are never transformed on the CPU, sorting only needs the positions for triangle centroids
+    const auto geometry = merge(*mesh);
+
+    m_sorter = make_unique<TriangleSorter>(geometry.indices(), geometry.vertices(), m_sortThreads);
+    m_drawable = make_unique<PolygonalDrawable>(geometry);
+    m_sortingRequired = true;
+}
+
+void SortedBlending::sortTriangles(const glm::mat4 & view)
+{
+    if (!m_sorter || (!m_sortingRequired && view == m_sortedView))
+        return;
+
+    m_drawable->updateIndices(m_sorter->sort(view));
+
+    m_sortedView = view;
+    m_sortingRequired = false;
+}
+
+void SortedBlending::setupProgram()
+{
+    static const auto shaderPath = std::string{"data/transparency/"};
+    
+    m_program = make_ref<Program>();
+    m_program->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, shaderPath + "sorted_blending.vert"),
+        Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + "sorted_blending.frag"));
+}
+
+void SortedBlending::updateFramebuffer()
+{
+    const auto width = m_viewportCapability->width(), height = m_viewportCapability->height();
+    
+    m_colorAttachment->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_depthAttachment->image2D(0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <memory>
+
+#include <glm/glm.hpp>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <gloperate/painter/Painter.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+    class Program;
+    class Texture;
+}
+
+namespace gloperate
+{
+    class AdaptiveGrid;
+    class ResourceManager;
+    class AbstractTargetFramebufferCapability;
+    class AbstractViewportCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractCameraCapability;
+}
+
+class AsyncMeshLoader;
+class PolygonalDrawable;
+class TriangleSorter;
+
+/**
+ *  @brief
+ *    Alpha blending of back to front sorted triangles into a single-sample target
+ *
+ *  @remarks
+ *    Triangles are sorted on the CPU whenever the camera moved. Needs little memory
+ *    compared to StochasticTransparency, but sorting cost grows with the triangle count.
+ */
+class SortedBlending : public gloperate::Painter
+{
+public:
+    SortedBlending(gloperate::ResourceManager & resourceManager);
+    virtual ~SortedBlending();
+    
+public:
+    void setupPropertyGroup();
+    
+    float transparency() const;
+    void setTransparency(float transparency);
+    
+    unsigned int sortThreads() const;
+    void setSortThreads(unsigned int numThreads);
+    
+protected:
+    virtual void onInitialize() override;
+    virtual void onPaint() override;
+
+protected:
+    void setupFramebuffer();
+    void setupProjection();
+    void setupDrawable();
+    void updateDrawable();
+    void sortTriangles(const glm::mat4 & view);
+    void setupProgram();
+    void updateFramebuffer();
+
+protected:
+    /* capabilities */
+    gloperate::AbstractTargetFramebufferCapability * m_targetFramebufferCapability;
+    gloperate::AbstractViewportCapability * m_viewportCapability;
+    gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
+    gloperate::AbstractCameraCapability * m_cameraCapability;
+
+    /* members */
+    globjects::ref_ptr<globjects::Framebuffer> m_fbo;
+    globjects::ref_ptr<globjects::Texture> m_colorAttachment;
+    globjects::ref_ptr<globjects::Texture> m_depthAttachment;
+    
+    globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
+    globjects::ref_ptr<globjects::Program> m_program;
+    std::unique_ptr<AsyncMeshLoader> m_meshLoader;
+    std::unique_ptr<PolygonalDrawable> m_drawable;
+    std::unique_ptr<TriangleSorter> m_sorter;
+    
+    glm::mat4 m_sortedView;
+    bool m_sortingRequired;
+    
+    float m_transparency;
+    unsigned int m_sortThreads;
+};
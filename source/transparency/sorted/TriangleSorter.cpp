@@ -0,0 +1,227 @@
+#include "TriangleSorter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "../WorkerPool.h"
+
+
+namespace
+{
+
+/** Maps floats to unsigned integers of the same order */
+uint32_t orderedBits(float value)
+{
+    auto bits = uint32_t{0u};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+unsigned int digitOf(uint32_t key, unsigned int digit)
+{
+    return (key >> (digit * TriangleSorter::s_radixBits)) & (TriangleSorter::s_numBuckets - 1u);
+}
+
+}
+
+const unsigned int TriangleSorter::s_numBuckets;
+const unsigned int TriangleSorter::s_numDigits;
+
+TriangleSorter::TriangleSorter(
+    const std::vector<unsigned int> & indices,
+    const std::vector<glm::vec3> & vertices,
+    unsigned int numThreads)
+:   m_indices(indices)
+{
+    setNumThreads(numThreads);
+
+    const auto count = numTriangles();
+
+    m_centroids.resize(count);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto & a = vertices[indices[3u * i]];
+        const auto & b = vertices[indices[3u * i + 1u]];
+        const auto & c = vertices[indices[3u * i + 2u]];
+
+        m_centroids[i] = (a + b + c) / 3.0f;
+    }
+
+    m_keys.resize(count);
+    m_sortedKeys.resize(count);
+    m_order.resize(count);
+    m_sortedOrder.resize(count);
+    m_sortedIndices.resize(m_indices.size());
+}
+
+TriangleSorter::TriangleSorter(TriangleSorter && other) = default;
+
+TriangleSorter::~TriangleSorter() = default;
+
+unsigned int TriangleSorter::numTriangles() const
+{
+    return static_cast<unsigned int>(m_indices.size() / 3u);
+}
+
+void TriangleSorter::setNumThreads(unsigned int numThreads)
+{
+    if (numThreads == 0u)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Each thread owns one chunk of triangles, so that every pass scatters each chunk to the same range
+    const auto numChunks = std::max(std::min(numThreads, numTriangles()), 1u);
+
+    m_pool.reset(new WorkerPool{numChunks});
+
+    m_keyHistograms.assign(numChunks, std::vector<uint32_t>(s_numDigits * s_numBuckets));
+    m_scatterHistograms.assign(numChunks, std::vector<uint32_t>(numChunks * s_numBuckets));
+    m_offsets.assign(numChunks, std::vector<uint32_t>(s_numBuckets));
+}
+
+const std::vector<unsigned int> & TriangleSorter::sort(const glm::mat4 & view)
+{
+    const auto count = numTriangles();
+
+    computeKeys(view);
+
+    // Digits shared by all keys would not change the order
+    unsigned int digits[s_numDigits];
+    auto numPasses = 0u;
+
+    for (auto digit = 0u; digit < s_numDigits; ++digit)
+    {
+        for (auto bucket = 0u; bucket < s_numBuckets; ++bucket)
+        {
+            auto total = 0u;
+
+            for (const auto & histograms : m_keyHistograms)
+                total += histograms[digit * s_numBuckets + bucket];
+
+            if (total == count)
+                break;
+
+            if (total != 0u)
+            {
+                digits[numPasses++] = digit;
+                break;
+            }
+        }
+    }
+
+    for (auto pass = 0u; pass < numPasses; ++pass)
+    {
+        computeOffsets(digits[pass], pass == 0u);
+        scatter(digits[pass], pass + 1u < numPasses ? digits[pass + 1u] : s_numDigits);
+    }
+
+    const auto chunkSize = (count + m_pool->numThreads() - 1u) / m_pool->numThreads();
+
+    m_pool->run([this, count, chunkSize] (unsigned int chunk)
+    {
+        const auto end = std::min((chunk + 1u) * chunkSize, count);
+
+        for (auto i = chunk * chunkSize; i < end; ++i)
+        {
+            const auto triangle = m_order[i];
+
+            m_sortedIndices[3u * i] = m_indices[3u * triangle];
+            m_sortedIndices[3u * i + 1u] = m_indices[3u * triangle + 1u];
+            m_sortedIndices[3u * i + 2u] = m_indices[3u * triangle + 2u];
+        }
+    });
+
+    return m_sortedIndices;
+}
+
+void TriangleSorter::computeKeys(const glm::mat4 & view)
+{
+    const auto count = numTriangles();
+    const auto chunkSize = (count + m_pool->numThreads() - 1u) / m_pool->numThreads();
+    const auto depthRow = glm::vec4{view[0][2], view[1][2], view[2][2], view[3][2]};
+
+    // View space z is negative in front of the camera, ascending z is back to front
+    m_pool->run([this, count, chunkSize, &depthRow] (unsigned int chunk)
+    {
+        auto & histograms = m_keyHistograms[chunk];
+        std::fill(histograms.begin(), histograms.end(), 0u);
+
+        const auto end = std::min((chunk + 1u) * chunkSize, count);
+
+        for (auto i = chunk * chunkSize; i < end; ++i)
+        {
+            const auto & centroid = m_centroids[i];
+            const auto z = depthRow.x * centroid.x + depthRow.y * centroid.y + depthRow.z * centroid.z + depthRow.w;
+            const auto key = orderedBits(z);
+
+            m_keys[i] = key;
+            m_order[i] = i;
+
+            for (auto digit = 0u; digit < s_numDigits; ++digit)
+                ++histograms[digit * s_numBuckets + digitOf(key, digit)];
+        }
+    });
+}
+
+void TriangleSorter::computeOffsets(unsigned int digit, bool fromKeys)
+{
+    const auto numChunks = m_pool->numThreads();
+
+    // Ordered by bucket first and chunk second to stay stable
+    auto offset = 0u;
+
+    for (auto bucket = 0u; bucket < s_numBuckets; ++bucket)
+    {
+        for (auto chunk = 0u; chunk < numChunks; ++chunk)
+        {
+            auto size = 0u;
+
+            if (fromKeys)
+            {
+                size = m_keyHistograms[chunk][digit * s_numBuckets + bucket];
+            }
+            else
+            {
+                for (const auto & histograms : m_scatterHistograms)
+                    size += histograms[chunk * s_numBuckets + bucket];
+            }
+
+            m_offsets[chunk][bucket] = offset;
+            offset += size;
+        }
+    }
+}
+
+void TriangleSorter::scatter(unsigned int digit, unsigned int nextDigit)
+{
+    const auto count = numTriangles();
+    const auto chunkSize = (count + m_pool->numThreads() - 1u) / m_pool->numThreads();
+
+    m_pool->run([this, digit, nextDigit, count, chunkSize] (unsigned int chunk)
+    {
+        auto & offsets = m_offsets[chunk];
+
+        // Counts the next digit per chunk the keys land in, by the thread scattering them
+        auto & histograms = m_scatterHistograms[chunk];
+        std::fill(histograms.begin(), histograms.end(), 0u);
+
+        const auto end = std::min((chunk + 1u) * chunkSize, count);
+
+        for (auto i = chunk * chunkSize; i < end; ++i)
+        {
+            const auto key = m_keys[i];
+            const auto target = offsets[digitOf(key, digit)]++;
+
+            m_sortedKeys[target] = key;
+            m_sortedOrder[target] = m_order[i];
+
+            if (nextDigit < s_numDigits)
+                ++histograms[target / chunkSize * s_numBuckets + digitOf(key, nextDigit)];
+        }
+    });
+
+    std::swap(m_keys, m_sortedKeys);
+    std::swap(m_order, m_sortedOrder);
+}
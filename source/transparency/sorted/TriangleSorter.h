@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+
+class WorkerPool;
+
+/**
+ *  @brief
+ *    Orders the triangles of a mesh back to front with a parallel radix sort on view depth
+ *
+ *  @remarks
+ *    Triangles are sorted by the depth of their centroids, intersecting or cyclically
+ *    overlapping triangles are therefore not resolved.
+ *
+ *    The sorting threads persist between calls to sort(). The histograms of all digits are
+ *    counted while computing the keys, each radix pass then only scatters and counts the
+ *    next digit per destination chunk.
+ */
+class TriangleSorter
+{
+public:
+    static const unsigned int s_radixBits = 8u;
+    static const unsigned int s_numBuckets = 1u << s_radixBits;
+    static const unsigned int s_numDigits = 32u / s_radixBits;
+
+public:
+    /**
+     *  @param numThreads
+     *    Number of sorting threads, 0 uses std::thread::hardware_concurrency()
+     */
+    TriangleSorter(
+        const std::vector<unsigned int> & indices,
+        const std::vector<glm::vec3> & vertices,
+        unsigned int numThreads = 0u);
+
+    TriangleSorter(TriangleSorter && other);
+    ~TriangleSorter();
+
+    unsigned int numTriangles() const;
+
+    /** 0 uses std::thread::hardware_concurrency() */
+    void setNumThreads(unsigned int numThreads);
+
+    /**
+     *  @param view
+     *    World to view space transform, the camera looks along negative z
+     *
+     *  @return
+     *    Indices of all triangles, farthest first
+     */
+    const std::vector<unsigned int> & sort(const glm::mat4 & view);
+
+protected:
+    void computeKeys(const glm::mat4 & view);
+
+    /** Scatter offsets of digit per chunk, from the key histograms or those counted by the last scatter() */
+    void computeOffsets(unsigned int digit, bool fromKeys);
+
+    /** nextDigit == s_numDigits skips counting the next histograms */
+    void scatter(unsigned int digit, unsigned int nextDigit);
+
+private:
+    std::vector<unsigned int> m_indices;
+    std::vector<glm::vec3> m_centroids;
+    std::unique_ptr<WorkerPool> m_pool;
+
+    std::vector<uint32_t> m_keys;
+    std::vector<uint32_t> m_sortedKeys;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_sortedOrder;
+    std::vector<unsigned int> m_sortedIndices;
+    std::vector<std::vector<uint32_t>> m_keyHistograms;
+    std::vector<std::vector<uint32_t>> m_scatterHistograms;
+    std::vector<std::vector<uint32_t>> m_offsets;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+
+/**
+ *  @brief
+ *    Counter-based random number stream
+ *
+ *  @remarks
+ *    The n-th number of a stream only depends on seed, stream id and n, so independent
+ *    streams (e.g., one per alpha row) can be consumed on any thread in any order.
+ */
+class CounterRandom
+{
+public:
+    CounterRandom(unsigned int seed, unsigned int stream)
+    :   m_key{mix((static_cast<uint64_t>(seed) << 32) | stream)}
+    ,   m_counter{0u}
+    {
+    }
+
+    /** Uniformly distributed in [0, bound) */
+    uint32_t operator()(uint32_t bound)
+    {
+        const auto value = static_cast<uint32_t>(mix(m_key + 0x9e3779b97f4a7c15ull * ++m_counter) >> 32);
+        return static_cast<uint32_t>((static_cast<uint64_t>(value) * bound) >> 32);
+    }
+
+    /** Fisher-Yates; std::shuffle's use of the engine is implementation-defined */
+    template <typename Iterator>
+    void shuffle(Iterator begin, Iterator end)
+    {
+        for (auto i = static_cast<uint32_t>(end - begin); i > 1u; --i)
+            std::swap(begin[i - 1u], begin[(*this)(i)]);
+    }
+
+protected:
+    static uint64_t mix(uint64_t x)
+    {
+        // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+private:
+    const uint64_t m_key;
+    uint64_t m_counter;
+};
@@ -0,0 +1,231 @@
+#include "DitherMatrices.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "CounterRandom.h"
+
+
+namespace
+{
+
+/**
+ *  @brief
+ *    Binary pattern on a torus with gaussian-filtered energy per pixel
+ */
+class EnergyPattern
+{
+public:
+    EnergyPattern(unsigned int size, float sigma)
+    :   m_size{size}
+    ,   m_kernel(size * size)
+    ,   m_energy(size * size, 0.0f)
+    ,   m_pattern(size * size, false)
+    ,   m_count{0u}
+    {
+        for (auto y = 0u; y < size; ++y)
+        {
+            for (auto x = 0u; x < size; ++x)
+            {
+                const auto dx = static_cast<float>(std::min(x, size - x));
+                const auto dy = static_cast<float>(std::min(y, size - y));
+                m_kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+            }
+        }
+    }
+
+    bool isSet(unsigned int index) const
+    {
+        return m_pattern[index];
+    }
+
+    unsigned int count() const
+    {
+        return m_count;
+    }
+
+    void set(unsigned int index, bool value)
+    {
+        assert(m_pattern[index] != value);
+
+        m_pattern[index] = value;
+        m_count += value ? 1u : -1u;
+
+        const auto sign = value ? 1.0f : -1.0f;
+        const auto px = index % m_size, py = index / m_size;
+
+        for (auto y = 0u; y < m_size; ++y)
+        {
+            const auto ky = (y + m_size - py) % m_size;
+
+            for (auto x = 0u; x < m_size; ++x)
+            {
+                const auto kx = (x + m_size - px) % m_size;
+                m_energy[y * m_size + x] += sign * m_kernel[ky * m_size + kx];
+            }
+        }
+    }
+
+    /** Set pixel with the highest energy */
+    unsigned int tightestCluster() const
+    {
+        auto result = 0u;
+        auto maxEnergy = -std::numeric_limits<float>::max();
+
+        for (auto i = 0u; i < m_energy.size(); ++i)
+        {
+            if (m_pattern[i] && m_energy[i] > maxEnergy)
+            {
+                maxEnergy = m_energy[i];
+                result = i;
+            }
+        }
+
+        return result;
+    }
+
+    /** Unset pixel with the lowest energy */
+    unsigned int largestVoid() const
+    {
+        auto result = 0u;
+        auto minEnergy = std::numeric_limits<float>::max();
+
+        for (auto i = 0u; i < m_energy.size(); ++i)
+        {
+            if (!m_pattern[i] && m_energy[i] < minEnergy)
+            {
+                minEnergy = m_energy[i];
+                result = i;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    unsigned int m_size;
+    std::vector<float> m_kernel;
+    std::vector<float> m_energy;
+    std::vector<bool> m_pattern;
+    unsigned int m_count;
+};
+
+}
+
+std::vector<unsigned int> DitherMatrices::stratified(unsigned int size, unsigned int seed)
+{
+    static const auto stratumSize = 4u;
+
+    assert(size % stratumSize == 0u);
+
+    const auto numStrataPerRow = size / stratumSize;
+    const auto numStrata = numStrataPerRow * numStrataPerRow;
+    const auto stratumArea = stratumSize * stratumSize;
+
+    auto random = CounterRandom{seed, 0u};
+
+    auto strataOrder = std::vector<unsigned int>(numStrata);
+    std::iota(strataOrder.begin(), strataOrder.end(), 0u);
+    random.shuffle(strataOrder.begin(), strataOrder.end());
+
+    auto ranks = std::vector<unsigned int>(size * size);
+    auto localOrder = std::vector<unsigned int>(stratumArea);
+
+    // The n-th pixel of every stratum is ranked before the (n + 1)-th pixel of any stratum
+    for (auto stratum = 0u; stratum < numStrata; ++stratum)
+    {
+        std::iota(localOrder.begin(), localOrder.end(), 0u);
+        random.shuffle(localOrder.begin(), localOrder.end());
+
+        const auto sx = (stratum % numStrataPerRow) * stratumSize;
+        const auto sy = (stratum / numStrataPerRow) * stratumSize;
+
+        for (auto i = 0u; i < stratumArea; ++i)
+        {
+            const auto x = sx + i % stratumSize;
+            const auto y = sy + i / stratumSize;
+            ranks[y * size + x] = localOrder[i] * numStrata + strataOrder[stratum];
+        }
+    }
+
+    return ranks;
+}
+
+std::vector<unsigned int> DitherMatrices::bayer(unsigned int size)
+{
+    assert(size > 0u && (size & (size - 1u)) == 0u);
+
+    auto ranks = std::vector<unsigned int>(size * size);
+
+    for (auto y = 0u; y < size; ++y)
+    {
+        for (auto x = 0u; x < size; ++x)
+        {
+            auto rank = 0u;
+
+            // Least significant coordinate bits select the most significant rank bits
+            for (auto bit = 1u; bit < size; bit <<= 1)
+                rank = (rank << 2) | (((x ^ y) & bit) ? 2u : 0u) | ((y & bit) ? 1u : 0u);
+
+            ranks[y * size + x] = rank;
+        }
+    }
+
+    return ranks;
+}
+
+std::vector<unsigned int> DitherMatrices::blueNoise(unsigned int size, unsigned int seed)
+{
+    static const auto sigma = 1.5f;
+
+    const auto numPixels = size * size;
+    auto ranks = std::vector<unsigned int>(numPixels);
+
+    // Initial binary pattern: random minority pixels, relaxed until the tightest
+    // cluster and the largest void coincide
+    auto prototype = EnergyPattern{size, sigma};
+    auto random = CounterRandom{seed, 0u};
+
+    while (prototype.count() < numPixels / 10u)
+    {
+        const auto index = random(numPixels);
+
+        if (!prototype.isSet(index))
+            prototype.set(index, true);
+    }
+
+    for (auto i = 0u; i < numPixels; ++i)
+    {
+        const auto cluster = prototype.tightestCluster();
+        prototype.set(cluster, false);
+
+        const auto largestVoid = prototype.largestVoid();
+        prototype.set(largestVoid, true);
+
+        if (largestVoid == cluster)
+            break;
+    }
+
+    // Phase 1: rank the prototype's pixels by removing tightest clusters
+    auto pattern = prototype;
+
+    while (pattern.count() > 0u)
+    {
+        const auto cluster = pattern.tightestCluster();
+        pattern.set(cluster, false);
+        ranks[cluster] = pattern.count();
+    }
+
+    // Phase 2 and 3: fill the largest voids
+    while (prototype.count() < numPixels)
+    {
+        const auto largestVoid = prototype.largestVoid();
+        ranks[largestVoid] = prototype.count();
+        prototype.set(largestVoid, true);
+    }
+
+    return ranks;
+}
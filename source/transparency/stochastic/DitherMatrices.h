@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+
+/**
+ *  @brief
+ *    Rank matrices for ordering the entries of a square, toroidally tiled mask table row
+ *
+ *  @remarks
+ *    Each function returns size * size distinct ranks in [0, size * size), stored row-major.
+ *    Thresholding the matrix at any rank yields the spatial pattern of the respective strategy.
+ */
+class DitherMatrices
+{
+public:
+    /** Random order that fills the size/4 x size/4 strata of 4x4 pixels evenly */
+    static std::vector<unsigned int> stratified(unsigned int size, unsigned int seed);
+
+    /** Recursive Bayer (ordered dither) matrix, size must be a power of two */
+    static std::vector<unsigned int> bayer(unsigned int size);
+
+    /** Void-and-cluster blue noise (Ulichney 1993) */
+    static std::vector<unsigned int> blueNoise(unsigned int size, unsigned int seed);
+};
@@ -0,0 +1,90 @@
+#include "MaskSourceBenchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "StochasticTransparencyOptions.h"
+
+
+MaskSourceBenchmark::MaskSourceBenchmark(uint16_t maxNumSamples)
+:   m_configuration(0u)
+,   m_frame(0u)
+,   m_timeSum(0.0f)
+{
+    for (auto numSamples = 1u; numSamples < maxNumSamples; numSamples *= 2u)
+        m_sampleCounts.push_back(static_cast<uint16_t>(numSamples));
+
+    m_sampleCounts.push_back(std::max(maxNumSamples, uint16_t{1u}));
+
+    m_averageTimes.resize(m_sampleCounts.size() * s_numSources, 0.0f);
+}
+
+bool MaskSourceBenchmark::finished() const
+{
+    return m_configuration == m_averageTimes.size();
+}
+
+MaskSource MaskSourceBenchmark::maskSource() const
+{
+    return static_cast<MaskSource>(m_configuration % s_numSources);
+}
+
+uint16_t MaskSourceBenchmark::numSamples() const
+{
+    return m_sampleCounts[m_configuration / s_numSources];
+}
+
+void MaskSourceBenchmark::addFrame(float milliseconds)
+{
+    if (finished())
+        return;
+
+    ++m_frame;
+
+    if (m_frame <= s_warmupFrames)
+        return;
+
+    m_timeSum += milliseconds;
+
+    if (m_frame < s_warmupFrames + s_measuredFrames)
+        return;
+
+    m_averageTimes[m_configuration] = m_timeSum / static_cast<float>(s_measuredFrames);
+
+    ++m_configuration;
+    m_frame = 0u;
+    m_timeSum = 0.0f;
+}
+
+const std::vector<uint16_t> & MaskSourceBenchmark::sampleCounts() const
+{
+    return m_sampleCounts;
+}
+
+float MaskSourceBenchmark::averageTime(MaskSource source, uint16_t numSamples) const
+{
+    const auto it = std::find(m_sampleCounts.begin(), m_sampleCounts.end(), numSamples);
+
+    if (it == m_sampleCounts.end())
+        return 0.0f;
+
+    const auto index = static_cast<std::size_t>(it - m_sampleCounts.begin());
+    return m_averageTimes[index * s_numSources + static_cast<std::size_t>(source)];
+}
+
+void MaskSourceBenchmark::print(std::ostream & stream) const
+{
+    stream << "Coverage pass in ms" << std::endl;
+    stream << std::setw(8) << "samples" << std::setw(12) << "Table" << std::setw(12) << "Native" << std::setw(12) << "Hash" << std::endl;
+
+    for (auto i = 0u; i < m_sampleCounts.size(); ++i)
+    {
+        stream << std::setw(8) << m_sampleCounts[i];
+
+        for (auto source = 0u; source < s_numSources; ++source)
+            stream << std::setw(12) << std::fixed << std::setprecision(3) << m_averageTimes[i * s_numSources + source];
+
+        stream << std::endl;
+    }
+}
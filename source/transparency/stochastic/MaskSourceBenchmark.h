@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+
+enum class MaskSource;
+
+/**
+ *  @brief
+ *    Steps through all mask sources at power of two sample counts and averages the coverage pass time of each
+ *
+ *  @remarks
+ *    The painter renders with maskSource() and numSamples() and reports the time of every frame through
+ *    addFrame(). The first frames of each configuration are skipped, since timer queries lag behind and the
+ *    framebuffer might just have been reallocated. Sources change faster than sample counts.
+ */
+class MaskSourceBenchmark
+{
+public:
+    static const unsigned int s_numSources = 3u;
+    static const unsigned int s_warmupFrames = 4u;
+    static const unsigned int s_measuredFrames = 32u;
+
+public:
+    MaskSourceBenchmark(uint16_t maxNumSamples);
+
+    bool finished() const;
+
+    /** Configuration to render the next frame with, undefined once finished */
+    MaskSource maskSource() const;
+    uint16_t numSamples() const;
+
+    void addFrame(float milliseconds);
+
+    const std::vector<uint16_t> & sampleCounts() const;
+
+    /** Average time in milliseconds, 0 if the configuration has not been measured yet */
+    float averageTime(MaskSource source, uint16_t numSamples) const;
+
+    void print(std::ostream & stream) const;
+
+private:
+    std::vector<uint16_t> m_sampleCounts;
+    std::vector<float> m_averageTimes;
+
+    std::size_t m_configuration;
+    unsigned int m_frame;
+    float m_timeSum;
+};
@@ -0,0 +1,149 @@
+#include "MasksTableCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../CacheFile.h"
+#include "../MappedFile.h"
+#include "MasksTableGenerator.h"
+
+
+using widgetzeug::make_unique;
+
+namespace
+{
+
+struct MasksTableHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numSamples;
+    uint32_t alphaRes;
+    uint32_t numMasks;
+    uint32_t maskSize;
+    uint32_t distribution;
+    uint32_t seed;
+    uint64_t checksum;
+};
+
+const char s_magic[4] = { 'M', 'T', 'B', 'L' };
+
+std::size_t payloadSize(unsigned int maskSize)
+{
+    return std::size_t{MasksTableGeneratorBase::s_alphaRes} * MasksTableGeneratorBase::s_numMasks * maskSize;
+}
+
+MasksTableHeader createHeader(unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed)
+{
+    auto header = MasksTableHeader{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = MasksTableCache::s_version;
+    header.numSamples = numSamples;
+    header.alphaRes = MasksTableGeneratorBase::s_alphaRes;
+    header.numMasks = MasksTableGeneratorBase::s_numMasks;
+    header.maskSize = maskSize;
+    header.distribution = static_cast<uint32_t>(distribution);
+    header.seed = seed;
+    header.checksum = 0u;
+
+    return header;
+}
+
+}
+
+MasksTableCache::MasksTableCache(const std::string & directory)
+:   m_directory{directory}
+{
+}
+
+MasksTableCache::~MasksTableCache() = default;
+
+const void * MasksTableCache::table(
+    unsigned int numSamples,
+    unsigned int maskSize,
+    MaskDistribution distribution,
+    unsigned int seed)
+{
+    const auto file = filename(numSamples, maskSize, distribution, seed);
+
+    m_generatedTable.clear();
+
+    if (load(file, numSamples, maskSize, distribution, seed))
+        return m_mappedFile->data() + sizeof(MasksTableHeader);
+
+    m_mappedFile.reset();
+    m_generatedTable = MasksTableGeneratorBase::generateTable(numSamples, maskSize, distribution, seed);
+
+    if (!store(file, numSamples, maskSize, distribution, seed))
+        std::cout << "Could not write masks table cache " << file << std::endl;
+
+    return m_generatedTable.data();
+}
+
+std::string MasksTableCache::filename(unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed) const
+{
+    std::stringstream stream;
+    stream << m_directory << "/masks_"
+        << numSamples << "x"
+        << maskSize * 8u << "_"
+        << "d" << static_cast<unsigned int>(distribution) << "_"
+        << MasksTableGeneratorBase::s_alphaRes << "x" << MasksTableGeneratorBase::s_numMasks << "_"
+        << seed << ".bin";
+
+    return stream.str();
+}
+
+bool MasksTableCache::load(const std::string & filename, unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed)
+{
+    m_mappedFile = make_unique<MappedFile>(filename);
+
+    if (!m_mappedFile->isValid() || m_mappedFile->size() != sizeof(MasksTableHeader) + payloadSize(maskSize))
+        return false;
+
+    auto header = MasksTableHeader{};
+    std::memcpy(&header, m_mappedFile->data(), sizeof(header));
+
+    auto expected = createHeader(numSamples, maskSize, distribution, seed);
+    expected.checksum = header.checksum;
+
+    if (std::memcmp(&header, &expected, sizeof(header)) != 0)
+        return false;
+
+    const auto payload = m_mappedFile->data() + sizeof(MasksTableHeader);
+
+    if (CacheFile::checksum(payload, payloadSize(maskSize)) != header.checksum)
+    {
+        std::cout << "Checksum mismatch in masks table cache " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool MasksTableCache::store(const std::string & filename, unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed) const
+{
+    CacheFile::makeDirectory(m_directory);
+
+    auto header = createHeader(numSamples, maskSize, distribution, seed);
+    header.checksum = CacheFile::checksum(m_generatedTable.data(), m_generatedTable.size());
+
+    const auto temporary = filename + ".tmp";
+
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(m_generatedTable.data()), m_generatedTable.size());
+    stream.close();
+
+    if (!stream)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return CacheFile::replace(temporary, filename);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+enum class MaskDistribution;
+
+class MappedFile;
+
+/**
+ *  @brief
+ *    Persistent on-disk cache for tables created by MasksTableGenerator
+ *
+ *  @remarks
+ *    Each table is stored in its own versioned binary file keyed by sample count,
+ *    mask size, mask distribution, table dimensions and generator seed. Cached files are memory-mapped, so their
+ *    payload can be handed to the GL without an intermediate copy. Missing files and
+ *    files with a mismatching header or checksum are regenerated and rewritten.
+ */
+class MasksTableCache
+{
+public:
+    static const uint32_t s_version = 4u;
+
+public:
+    MasksTableCache(const std::string & directory);
+    ~MasksTableCache();
+
+    /**
+     *  @return
+     *    Pointer to s_alphaRes * s_numMasks masks of maskSize bytes each,
+     *    valid until the next call or destruction
+     */
+    const void * table(
+        unsigned int numSamples,
+        unsigned int maskSize,
+        MaskDistribution distribution,
+        unsigned int seed);
+
+protected:
+    std::string filename(unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed) const;
+
+    bool load(const std::string & filename, unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed);
+    bool store(const std::string & filename, unsigned int numSamples, unsigned int maskSize, MaskDistribution distribution, unsigned int seed) const;
+
+private:
+    const std::string m_directory;
+
+    std::unique_ptr<MappedFile> m_mappedFile;
+    std::vector<unsigned char> m_generatedTable;
+};
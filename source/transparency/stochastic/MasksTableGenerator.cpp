@@ -2,84 +2,244 @@
 
 #include <cassert>
 #include <algorithm>
+#include <unordered_set>
 
 #include <glm/common.hpp>
 
 #include <widgetzeug/make_unique.hpp>
 
+#include "../ParallelFor.h"
+#include "CounterRandom.h"
+#include "DitherMatrices.h"
+
 
 using widgetzeug::make_unique;
 
-auto MasksTableGenerator::generateDistributions(unsigned int numSamples) -> std::unique_ptr<maskDistributions_t>
+namespace
+{
+
+uint64_t binomial(unsigned int n, unsigned int k)
+{
+    auto result = uint64_t{1u};
+
+    for (auto i = 1u; i <= k; ++i)
+        result = result * (n - k + i) / i;
+
+    return result;
+}
+
+}
+
+unsigned int MasksTableGeneratorBase::maskSize(unsigned int numSamples)
 {
-    return MasksTableGenerator(numSamples).generateDistributions();
+    assert(numSamples <= s_maxNumSamples);
+
+    if (numSamples <= 8u)
+        return 1u;
+
+    if (numSamples <= 16u)
+        return 2u;
+
+    return 4u;
 }
 
-MasksTableGenerator::MasksTableGenerator(unsigned int numSamples)
+std::vector<unsigned char> MasksTableGeneratorBase::generateTable(
+    unsigned int numSamples,
+    unsigned int maskSize,
+    MaskDistribution distribution,
+    unsigned int seed,
+    unsigned int numThreads)
+{
+    auto table = std::vector<unsigned char>{};
+
+    const auto copyTable = [&table] (const void * data, std::size_t size)
+    {
+        const auto bytes = static_cast<const unsigned char *>(data);
+        table.assign(bytes, bytes + size);
+    };
+
+    switch (maskSize)
+    {
+    case 1u:
+        copyTable(MasksTableGenerator<uint8_t>::generateDistributions(numSamples, distribution, seed, numThreads)->data(),
+            sizeof(MasksTableGenerator<uint8_t>::maskDistributions_t));
+        break;
+    case 2u:
+        copyTable(MasksTableGenerator<uint16_t>::generateDistributions(numSamples, distribution, seed, numThreads)->data(),
+            sizeof(MasksTableGenerator<uint16_t>::maskDistributions_t));
+        break;
+    case 4u:
+        copyTable(MasksTableGenerator<uint32_t>::generateDistributions(numSamples, distribution, seed, numThreads)->data(),
+            sizeof(MasksTableGenerator<uint32_t>::maskDistributions_t));
+        break;
+    default:
+        assert(false);
+    }
+
+    return table;
+}
+
+template <typename Mask>
+auto MasksTableGenerator<Mask>::generateDistributions(
+    unsigned int numSamples,
+    MaskDistribution distribution,
+    unsigned int seed,
+    unsigned int numThreads) -> std::unique_ptr<maskDistributions_t>
+{
+    return MasksTableGenerator(numSamples, distribution, seed, numThreads).generateDistributions();
+}
+
+template <typename Mask>
+MasksTableGenerator<Mask>::MasksTableGenerator(
+    unsigned int numSamples,
+    MaskDistribution distribution,
+    unsigned int seed,
+    unsigned int numThreads)
 :   m_numSamples{numSamples}
+,   m_distribution{distribution}
+,   m_seed{seed}
+,   m_numThreads{numThreads}
 {
+    assert(numSamples <= s_maskBits);
 }
 
-MasksTableGenerator::~MasksTableGenerator() = default;
+template <typename Mask>
+MasksTableGenerator<Mask>::~MasksTableGenerator() = default;
 
-auto MasksTableGenerator::generateDistributions() -> std::unique_ptr<maskDistributions_t>
+template <typename Mask>
+auto MasksTableGenerator<Mask>::generateDistributions() -> std::unique_ptr<maskDistributions_t>
 {    
     generateCombinations();
+    generateRanking();
     
     auto masks = make_unique<maskDistributions_t>();
+    auto & distributions = *masks;
     
-    for (auto i = 0u; i < masks->size(); ++i)
-        generateDistributionForAlpha(i, masks->at(i));
+    parallelFor(s_alphaRes, [this, &distributions] (unsigned int begin, unsigned int end)
+    {
+        for (auto i = begin; i < end; ++i)
+            generateDistributionForAlpha(i, distributions[i]);
+    }, m_numThreads);
 
-    return std::move(masks);
+    return masks;
 }
 
-void MasksTableGenerator::generateCombinations()
+template <typename Mask>
+void MasksTableGenerator<Mask>::generateCombinations()
 {
     m_combinationMasks = std::vector<std::vector<mask_t>>{};
         
     for (auto k = 0u; k <= m_numSamples; ++k)
     {
         auto kCombinations = std::vector<mask_t>{};
-        generateCombinationsForK(0x00, 0, k, kCombinations);
         
-        std::random_shuffle(kCombinations.begin(), kCombinations.end());
-        m_combinationMasks.push_back(kCombinations);
+        // Only s_numMasks combinations fit into a row, so do not enumerate all
+        // C(32, 16) combinations of wide masks
+        if (binomial(m_numSamples, k) <= s_numMasks)
+            generateCombinationsForK(0u, 0u, k, kCombinations);
+        else
+            sampleCombinationsForK(k, kCombinations);
+        
+        // Streams [0, s_alphaRes) belong to the alpha rows
+        auto random = CounterRandom{m_seed, s_alphaRes + k};
+        random.shuffle(kCombinations.begin(), kCombinations.end());
+        m_combinationMasks.push_back(std::move(kCombinations));
+    }
+}
+
+template <typename Mask>
+void MasksTableGenerator<Mask>::generateRanking()
+{
+    static_assert(s_tileSize * s_tileSize == s_numMasks, "A row has to cover exactly one tile");
+
+    auto ranks = std::vector<unsigned int>{};
+
+    switch (m_distribution)
+    {
+    case MaskDistribution::Random:
+        m_indicesByRank.clear();
+        return;
+    case MaskDistribution::Stratified:
+        ranks = DitherMatrices::stratified(s_tileSize, m_seed);
+        break;
+    case MaskDistribution::LowDiscrepancy:
+        ranks = DitherMatrices::bayer(s_tileSize);
+        break;
+    case MaskDistribution::BlueNoise:
+        ranks = DitherMatrices::blueNoise(s_tileSize, m_seed);
+        break;
     }
+
+    m_indicesByRank.resize(s_numMasks);
+
+    for (auto i = 0u; i < s_numMasks; ++i)
+        m_indicesByRank[ranks[i]] = i;
 }
 
-void MasksTableGenerator::generateCombinationsForK(
-    const std::bitset<8> & combination,
-    unsigned char offset,
-    unsigned char k,
+template <typename Mask>
+void MasksTableGenerator<Mask>::generateCombinationsForK(
+    mask_t combination,
+    unsigned int offset,
+    unsigned int k,
     std::vector<mask_t> & combinationMasks)
 {
     if (k == 0)
     {
-        combinationMasks.push_back(combination.to_ulong());
+        combinationMasks.push_back(combination);
         return;
     }
     
     for (auto i = offset; i < m_numSamples - (k - 1); ++i)
     {
-        auto newCombination = combination;
-        newCombination.set(i, true);
+        const auto newCombination = static_cast<mask_t>(combination | (mask_t{1u} << i));
         generateCombinationsForK(newCombination, i + 1, k - 1, combinationMasks);
     }
 }
 
-void MasksTableGenerator::generateDistributionForAlpha(
+template <typename Mask>
+void MasksTableGenerator<Mask>::sampleCombinationsForK(
+    unsigned int k,
+    std::vector<mask_t> & combinationMasks)
+{
+    // Streams above s_alphaRes + s_maxNumSamples are reserved for sampling
+    auto random = CounterRandom{m_seed, s_alphaRes + s_maxNumSamples + 1u + k};
+    auto sampled = std::unordered_set<mask_t>{};
+
+    while (combinationMasks.size() < s_numMasks)
+    {
+        // Floyd's algorithm for a uniformly distributed k-subset of the samples
+        auto combination = mask_t{0u};
+
+        for (auto j = m_numSamples - k; j < m_numSamples; ++j)
+        {
+            const auto bit = static_cast<mask_t>(mask_t{1u} << random(j + 1u));
+            combination |= (combination & bit) ? static_cast<mask_t>(mask_t{1u} << j) : bit;
+        }
+
+        if (sampled.insert(combination).second)
+            combinationMasks.push_back(combination);
+    }
+}
+
+template <typename Mask>
+void MasksTableGenerator<Mask>::generateDistributionForAlpha(
     unsigned int alphaIndex, 
-    maskDistribution_t & masks)
+    maskDistribution_t & masks) const
 {
     const auto avgNumSamples = m_numSamples * (static_cast<float>(alphaIndex) / (s_alphaRes - 1));
-    const auto lowNumSamples = glm::floor(avgNumSamples);
-    const auto highNumSamples = lowNumSamples + 1.0f;
+    const auto lowNumSamples = static_cast<unsigned int>(glm::floor(avgNumSamples));
+    const auto highNumSamples = glm::min(lowNumSamples + 1u, m_numSamples);
     const auto ratio = 1.0f - glm::fract(avgNumSamples);
     
     const auto lowNumMasks = static_cast<unsigned int>(ratio * s_numMasks);
     const auto highNumMasks = s_numMasks - lowNumMasks;
 
+    if (m_distribution != MaskDistribution::Random)
+    {
+        distributeMasks(lowNumSamples, highNumSamples, highNumMasks, masks);
+        return;
+    }
+
     auto maskIt = masks.begin();
 
     copyMasks(lowNumMasks, m_combinationMasks[lowNumSamples], maskIt);
@@ -87,13 +247,39 @@ void MasksTableGenerator::generateDistributionForAlpha(
     
     assert(maskIt == masks.end());
     
-    std::random_shuffle(masks.begin(), masks.end());
+    auto random = CounterRandom{m_seed, alphaIndex};
+    random.shuffle(masks.begin(), masks.end());
 }
 
-void MasksTableGenerator::copyMasks(
+template <typename Mask>
+void MasksTableGenerator<Mask>::distributeMasks(
+    unsigned int lowNumSamples,
+    unsigned int highNumSamples,
+    unsigned int highNumMasks,
+    maskDistribution_t & masks) const
+{
+    // The highNumMasks lowest ranked entries get the additional sample. Cycling through
+    // the shuffled combinations in rank order keeps the samples evenly used within
+    // every part of the tile.
+    const auto & highMasks = m_combinationMasks[highNumSamples];
+    const auto & lowMasks = m_combinationMasks[lowNumSamples];
+
+    for (auto rank = 0u; rank < s_numMasks; ++rank)
+    {
+        const auto index = m_indicesByRank[rank];
+
+        if (rank < highNumMasks)
+            masks[index] = highMasks[rank % highMasks.size()];
+        else
+            masks[index] = lowMasks[(rank - highNumMasks) % lowMasks.size()];
+    }
+}
+
+template <typename Mask>
+void MasksTableGenerator<Mask>::copyMasks(
     unsigned int numMasks,
     const std::vector<mask_t> & fromMasks,
-    maskDistribution_t::iterator & toMaskIt)
+    typename maskDistribution_t::iterator & toMaskIt) const
 {
     while (numMasks > 0)
     {        
@@ -111,3 +297,7 @@ void MasksTableGenerator::copyMasks(
         
     assert(numMasks == 0);
 }
+
+template class MasksTableGenerator<uint8_t>;
+template class MasksTableGenerator<uint16_t>;
+template class MasksTableGenerator<uint32_t>;
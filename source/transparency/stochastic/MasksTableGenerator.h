@@ -2,50 +2,130 @@
 
 #include <cstdint>
 #include <array>
-#include <bitset>
 #include <memory>
 #include <vector>
 
 
-class MasksTableGenerator
+/**
+ *  @brief
+ *    Arrangement of the masks within a row of the table
+ *
+ *  @remarks
+ *    Except for Random, rows are meant to be indexed as s_tileSize x s_tileSize
+ *    tiles in screen space.
+ */
+enum class MaskDistribution { Random, Stratified, LowDiscrepancy, BlueNoise };
+
+/**
+ *  @brief
+ *    Table dimensions and mask-width independent interface of MasksTableGenerator
+ */
+class MasksTableGeneratorBase
 {
 public:
     static const auto s_alphaRes = 256u;
     static const auto s_numMasks = 1024u;
+    static const auto s_tileSize = 32u;
+
+    static const auto s_maxNumSamples = 32u;
+
+    static const auto s_defaultSeed = 0u;
+
+public:
+    /**
+     *  @return
+     *    Size in bytes of the smallest mask type with at least numSamples bits (1, 2 or 4)
+     */
+    static unsigned int maskSize(unsigned int numSamples);
+
+    /**
+     *  @brief
+     *    Generates a table with masks of maskSize bytes each
+     *
+     *  @return
+     *    s_alphaRes * s_numMasks * maskSize bytes, rows ordered by alpha
+     */
+    static std::vector<unsigned char> generateTable(
+        unsigned int numSamples,
+        unsigned int maskSize,
+        MaskDistribution distribution = MaskDistribution::Random,
+        unsigned int seed = s_defaultSeed,
+        unsigned int numThreads = 0u);
+};
 
-    using mask_t = uint8_t;
+template <typename Mask>
+class MasksTableGenerator : public MasksTableGeneratorBase
+{
+public:
+    using mask_t = Mask;
     using maskDistribution_t = std::array<mask_t, s_numMasks>;
     
     using maskDistributions_t = std::array<maskDistribution_t, s_alphaRes>;
 
+    static const auto s_maskBits = static_cast<unsigned int>(sizeof(mask_t) * 8u);
+
 public:
-    static std::unique_ptr<maskDistributions_t> generateDistributions(unsigned int numSamples);
+    /**
+     *  @param numThreads
+     *    Number of worker threads, 0 uses all hardware threads
+     *
+     *  @remarks
+     *    Output only depends on numSamples and seed, not on the number of threads.
+     */
+    static std::unique_ptr<maskDistributions_t> generateDistributions(
+        unsigned int numSamples,
+        MaskDistribution distribution = MaskDistribution::Random,
+        unsigned int seed = s_defaultSeed,
+        unsigned int numThreads = 0u);
 
 public:
-    MasksTableGenerator(unsigned int numSamples);
+    MasksTableGenerator(
+        unsigned int numSamples,
+        MaskDistribution distribution = MaskDistribution::Random,
+        unsigned int seed = s_defaultSeed,
+        unsigned int numThreads = 0u);
     ~MasksTableGenerator();
 
     std::unique_ptr<maskDistributions_t> generateDistributions();
 
 protected:
     void generateCombinations();
+    void generateRanking();
 
     void generateCombinationsForK(
-        const std::bitset<8> & combination,
-        unsigned char offset,
-        unsigned char k,
+        mask_t combination,
+        unsigned int offset,
+        unsigned int k,
+        std::vector<mask_t> & combinationMasks);
+
+    void sampleCombinationsForK(
+        unsigned int k,
         std::vector<mask_t> & combinationMasks);
 
     void generateDistributionForAlpha(
         unsigned int alphaIndex,
-        maskDistribution_t & masks);
+        maskDistribution_t & masks) const;
+
+    void distributeMasks(
+        unsigned int lowNumSamples,
+        unsigned int highNumSamples,
+        unsigned int highNumMasks,
+        maskDistribution_t & masks) const;
 
     void copyMasks(
         unsigned int numMasks,
         const std::vector<mask_t> & fromMasks,
-        maskDistribution_t::iterator & toMaskIt);
+        typename maskDistribution_t::iterator & toMaskIt) const;
 
 private:
     const unsigned int m_numSamples;
+    const MaskDistribution m_distribution;
+    const unsigned int m_seed;
+    const unsigned int m_numThreads;
     std::vector<std::vector<mask_t>> m_combinationMasks;
+    std::vector<unsigned int> m_indicesByRank;
 };
+
+extern template class MasksTableGenerator<uint8_t>;
+extern template class MasksTableGenerator<uint16_t>;
+extern template class MasksTableGenerator<uint32_t>;
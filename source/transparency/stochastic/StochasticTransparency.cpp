@@ -26,14 +26,18 @@
 #include <gloperate/painter/CameraCapability.h>
 #include <gloperate/primitives/AdaptiveGrid.h>
 #include <gloperate/primitives/ScreenAlignedQuad.h>
-#include <gloperate/primitives/Scene.h>
-
-#include <gloperate/primitives/PolygonalDrawable.h>
-#include <gloperate/primitives/PolygonalGeometry.h>
 
 #include <reflectionzeug/PropertyGroup.h>
 #include <widgetzeug/make_unique.hpp>
 
+#include "../DepthPyramid.h"
+#include "../MeshCache.h"
+#include "../PassTimer.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
+#include "MaskSourceBenchmark.h"
+#include "MasksTableCache.h"
 #include "MasksTableGenerator.h"
 #include "StochasticTransparencyOptions.h"
 
@@ -50,7 +54,16 @@ StochasticTransparency::StochasticTransparency(gloperate::ResourceManager & reso
 ,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
 ,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
 ,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_multiDraw(false)
+,   m_fusedAccumulation(false)
 ,   m_options(new StochasticTransparencyOptions(*this))
+,   m_sceneOptions(new SceneOptions(*this))
+,   m_masksTableCache(new MasksTableCache("data/transparency/cache"))
+,   m_restoredMaskSource(MaskSource::Table)
+,   m_restoredNumSamples(0u)
+,   m_frame(0u)
+,   m_historyIndex(0u)
+,   m_historyValid(false)
 {
 }
 
@@ -68,11 +81,15 @@ void StochasticTransparency::onInitialize()
     debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
 #endif
 
+    m_multiDraw = SceneDrawable::multiDrawSupported();
+
     m_options->initGL();
     
     m_grid = make_ref<gloperate::AdaptiveGrid>();
     m_grid->setColor({0.6f, 0.6f, 0.6f});
     
+    m_timer = make_unique<PassTimer>(1u);
+    
     setupPrograms();
     setupProjection();
     setupFramebuffer();
@@ -82,6 +99,11 @@ void StochasticTransparency::onInitialize()
 
 void StochasticTransparency::onPaint()
 {
+    m_timer->nextFrame();
+    m_options->setCoverageTime(m_timer->milliseconds(0u));
+    
+    updateBenchmark();
+    
     if (m_viewportCapability->hasChanged())
     {
         glViewport(
@@ -93,7 +115,9 @@ void StochasticTransparency::onPaint()
         m_viewportCapability->setChanged(false);
         
         const auto viewport = glm::vec2{m_viewportCapability->width(), m_viewportCapability->height()};
-        m_alphaToCoverageProgram->setUniform("viewport", viewport);
+        
+        for (auto & program : m_alphaToCoveragePrograms)
+            program->setUniform("viewport", viewport);
         
         updateFramebuffer();
     }
@@ -101,14 +125,24 @@ void StochasticTransparency::onPaint()
     if (m_options->numSamplesChanged())
         updateNumSamples();
     
+    if (m_options->maskDistributionChanged())
+        setupMasksTexture();
+    
+    if (fusedAccumulation() != m_fusedAccumulation)
+        updateStochasticDepth();
+    
+    if (!m_options->temporalAccumulation())
+        m_historyValid = false;
+    
     clearBuffers();
     updateUniforms();
     
     if (m_options->optimization() == StochasticTransparencyOptimization::NoOptimization)
     {
         renderOpaqueGeometry();
+        cullDrawables();
         
-        if (m_options->backFaceCulling())
+        if (m_sceneOptions->backFaceCulling())
             glEnable(GL_CULL_FACE);
         
         glEnable(GL_SAMPLE_SHADING);
@@ -119,15 +153,22 @@ void StochasticTransparency::onPaint()
         glDisable(GL_SAMPLE_SHADING);
         glDisable(GL_CULL_FACE);
         
-        blit();
+        if (m_options->temporalAccumulation())
+            resolveCurrentFrame();
+        else
+            blit();
     }
     else
     {
         renderOpaqueGeometry();
+        cullDrawables();
         renderTransparentGeometry();
         composite();
     }
     
+    if (m_options->temporalAccumulation())
+        accumulateHistory();
+    
     Framebuffer::unbind(GL_FRAMEBUFFER);
 }
 
@@ -138,6 +179,11 @@ void StochasticTransparency::setupFramebuffer()
     m_totalAlphaAttachment = make_ref<Texture>(GL_TEXTURE_2D_MULTISAMPLE);
     m_depthAttachment = make_ref<Texture>(GL_TEXTURE_2D_MULTISAMPLE);
     
+    m_currentColorAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    
+    for (auto & attachment : m_historyAttachments)
+        attachment = Texture::createDefault(GL_TEXTURE_2D);
+    
     updateFramebuffer();
     
     m_fbo = make_ref<Framebuffer>();
@@ -148,6 +194,17 @@ void StochasticTransparency::setupFramebuffer()
     m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
 
     m_fbo->printStatus(true);
+    
+    m_currentFbo = make_ref<Framebuffer>();
+    m_currentFbo->attachTexture(GL_COLOR_ATTACHMENT0, m_currentColorAttachment);
+    m_currentFbo->setDrawBuffer(GL_COLOR_ATTACHMENT0);
+    
+    for (auto i = 0u; i < m_historyFbos.size(); ++i)
+    {
+        m_historyFbos[i] = make_ref<Framebuffer>();
+        m_historyFbos[i]->attachTexture(GL_COLOR_ATTACHMENT0, m_historyAttachments[i]);
+        m_historyFbos[i]->setDrawBuffer(GL_COLOR_ATTACHMENT0);
+    }
 }
 
 void StochasticTransparency::setupProjection()
@@ -163,46 +220,73 @@ void StochasticTransparency::setupProjection()
 
 void StochasticTransparency::setupDrawable()
 {
-    // Load scene
-    const auto scene = m_resourceManager.load<gloperate::Scene>("data/transparency/transparency_scene.obj");
-    if (!scene)
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
+}
+
+void StochasticTransparency::cullDrawables()
+{
+    if (!m_options->gpuCulling())
     {
-        std::cout << "Could not load file" << std::endl;
+        m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
         return;
     }
-
-    // Create a renderable for each mesh
-    for (const auto * geometry : scene->meshes()) {
-        m_drawables.push_back(gloperate::make_unique<gloperate::PolygonalDrawable>(*geometry));
+    
+    // The opaque geometry has been rendered, its depth occludes the transparent geometry
+    if (m_options->occlusionCulling())
+    {
+        if (!m_depthPyramid)
+            m_depthPyramid = make_unique<DepthPyramid>();
+        
+        const auto size = glm::ivec2{m_viewportCapability->width(), m_viewportCapability->height()};
+        m_depthPyramid->update(m_depthAttachment, size, m_options->numSamples());
     }
-
-    // Release scene
-    delete scene;
+    
+    m_scene->updateOnGpu(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions,
+        m_options->occlusionCulling() ? m_depthPyramid.get() : nullptr);
 }
 
 void StochasticTransparency::setupPrograms()
 {
     static const auto totalAlphaShaders = "total_alpha";
-    static const auto alphaToCoverageShaders = "alpha_to_coverage";
     static const auto transparentColorsShaders = "transparent_colors";
+    static const auto fusedAccumulationShaders = "fused_accumulation";
     static const auto compositingShaders = "compositing";
     
-    const auto initProgram = [] (globjects::ref_ptr<globjects::Program> & program, const char * shaders)
+    // Without multi draw support, the scene is drawn with legacy vertex shaders taking the draw data as uniforms
+    const auto sceneVertexSuffix = std::string{m_multiDraw ? ".vert" : "_legacy.vert"};
+    
+    const auto initProgram = [] (globjects::ref_ptr<globjects::Program> & program, const char * shaders, const std::string & vertexSuffix)
     {
         static const auto shaderPath = std::string{"data/transparency/"};
         
         program = make_ref<Program>();
         program->attach(
-            Shader::fromFile(GL_VERTEX_SHADER, shaderPath + shaders + ".vert"),
+            Shader::fromFile(GL_VERTEX_SHADER, shaderPath + shaders + vertexSuffix),
             Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + shaders + ".frag"));
     };
     
-    initProgram(m_totalAlphaProgram, totalAlphaShaders);
-    initProgram(m_alphaToCoverageProgram, alphaToCoverageShaders);
-    initProgram(m_colorAccumulationProgram, transparentColorsShaders);
-    initProgram(m_compositingProgram, compositingShaders);
+    initProgram(m_totalAlphaProgram, totalAlphaShaders, sceneVertexSuffix);
+    initProgram(m_colorAccumulationProgram, transparentColorsShaders, sceneVertexSuffix);
+    initProgram(m_fusedAccumulationProgram, fusedAccumulationShaders, sceneVertexSuffix);
+    initProgram(m_compositingProgram, compositingShaders, ".vert");
     
-    m_alphaToCoverageProgram->setUniform("masksTexture", 0);
+    // Fragment shaders in the order of MaskSource, the vertex shader is shared
+    static const auto alphaToCoverageFragmentShaders = std::array<const char *, 3u>{{
+        "data/transparency/alpha_to_coverage.frag",
+        "data/transparency/alpha_to_coverage_native.frag",
+        "data/transparency/alpha_to_coverage_hash.frag" }};
+    
+    for (auto i = 0u; i < m_alphaToCoveragePrograms.size(); ++i)
+    {
+        m_alphaToCoveragePrograms[i] = make_ref<Program>();
+        m_alphaToCoveragePrograms[i]->attach(
+            Shader::fromFile(GL_VERTEX_SHADER, "data/transparency/alpha_to_coverage" + sceneVertexSuffix),
+            Shader::fromFile(GL_FRAGMENT_SHADER, alphaToCoverageFragmentShaders[i]));
+    }
+    
+    m_alphaToCoveragePrograms[static_cast<std::size_t>(MaskSource::Table)]->setUniform("masksTexture", 0);
+    m_fusedAccumulationProgram->setUniform("stochasticDepthTexture", 0);
     
     updateNumSamplesUniforms();
     
@@ -215,15 +299,57 @@ void StochasticTransparency::setupPrograms()
     m_compositingProgram->setUniform(transparentColorLocation, 2);
     
     m_compositingQuad = make_ref<gloperate::ScreenAlignedQuad>(m_compositingProgram);
+    
+    m_temporalProgram = make_ref<Program>();
+    m_temporalProgram->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, "data/transparency/compositing.vert"),
+        Shader::fromFile(GL_FRAGMENT_SHADER, "data/transparency/temporal_accumulation.frag"));
+    
+    m_temporalProgram->setUniform("currentColorTexture", 0);
+    m_temporalProgram->setUniform("historyTexture", 1);
+    m_temporalProgram->setUniform("depthTexture", 2);
+    
+    m_temporalQuad = make_ref<gloperate::ScreenAlignedQuad>(m_temporalProgram);
 }
 
 void StochasticTransparency::setupMasksTexture()
 {
-    static const auto numSamples = m_options->numSamples();
-    const auto table = MasksTableGenerator::generateDistributions(numSamples);
+    // One layer per sample count, so that changing num_samples only selects another layer
+    const auto maxNumSamples = m_options->maxNumSamples();
+    const auto maskSize = MasksTableGeneratorBase::maskSize(maxNumSamples);
+    const auto distribution = m_options->maskDistribution();
+    
+    auto internalFormat = GL_R8UI;
+    auto type = GL_UNSIGNED_BYTE;
+    
+    if (maskSize == 2u)
+    {
+        internalFormat = GL_R16UI;
+        type = GL_UNSIGNED_SHORT;
+    }
+    else if (maskSize == 4u)
+    {
+        internalFormat = GL_R32UI;
+        type = GL_UNSIGNED_INT;
+    }
+    
+    static const auto width = static_cast<GLsizei>(MasksTableGeneratorBase::s_numMasks);
+    static const auto height = static_cast<GLsizei>(MasksTableGeneratorBase::s_alphaRes);
     
-    m_masksTexture = Texture::createDefault(GL_TEXTURE_2D);
-    m_masksTexture->image2D(0, GL_R8, table->at(0).size(), table->size(), 0, GL_RED, GL_UNSIGNED_BYTE, table->data());
+    m_masksTexture = Texture::createDefault(GL_TEXTURE_2D_ARRAY);
+    m_masksTexture->setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    m_masksTexture->setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    m_masksTexture->image3D(0, internalFormat, width, height, maxNumSamples, 0, GL_RED_INTEGER, type, nullptr);
+    
+    for (auto numSamples = 1u; numSamples <= maxNumSamples; ++numSamples)
+    {
+        const auto table = m_masksTableCache->table(numSamples, maskSize, distribution, MasksTableGeneratorBase::s_defaultSeed);
+        const auto layer = static_cast<GLint>(numSamples - 1u);
+        
+        m_masksTexture->subImage3D(0, 0, 0, layer, width, height, 1, GL_RED_INTEGER, type, table);
+    }
+    
+    m_alphaToCoveragePrograms[static_cast<std::size_t>(MaskSource::Table)]->setUniform("tiledMasks", distribution != MaskDistribution::Random);
 }
 
 void StochasticTransparency::updateFramebuffer()
@@ -235,18 +361,104 @@ void StochasticTransparency::updateFramebuffer()
     m_transparentColorAttachment->image2DMultisample(numSamples, GL_RGBA32F, size, GL_FALSE);
     m_totalAlphaAttachment->image2DMultisample(numSamples, GL_R32F, size, GL_FALSE);
     m_depthAttachment->image2DMultisample(numSamples, GL_DEPTH_COMPONENT, size, GL_FALSE);
+    
+    m_currentColorAttachment->image2D(0, GL_RGBA8, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    
+    // Half floats keep small history updates from getting lost in quantization
+    for (auto & attachment : m_historyAttachments)
+        attachment->image2D(0, GL_RGBA16F, size, 0, GL_RGBA, GL_FLOAT, nullptr);
+    
+    m_historyValid = false;
+    
+    updateStochasticDepth();
+}
+
+void StochasticTransparency::updateStochasticDepth()
+{
+    m_fusedAccumulation = fusedAccumulation();
+    
+    // Only the fused passes render into it, otherwise its storage is released
+    if (!m_fusedAccumulation)
+    {
+        m_stochasticDepthFbo = nullptr;
+        m_stochasticDepthAttachment = nullptr;
+        return;
+    }
+    
+    const auto numSamples = m_options->numSamples();
+    const auto size = glm::ivec2{m_viewportCapability->width(), m_viewportCapability->height()};
+    
+    m_stochasticDepthAttachment = make_ref<Texture>(GL_TEXTURE_2D_MULTISAMPLE);
+    m_stochasticDepthAttachment->image2DMultisample(numSamples, GL_DEPTH_COMPONENT, size, GL_FALSE);
+    
+    m_stochasticDepthFbo = make_ref<Framebuffer>();
+    m_stochasticDepthFbo->attachTexture(GL_DEPTH_ATTACHMENT, m_stochasticDepthAttachment);
+    m_stochasticDepthFbo->setDrawBuffer(GL_NONE);
+    
+    m_stochasticDepthFbo->printStatus(true);
+}
+
+bool StochasticTransparency::fusedAccumulation() const
+{
+    // Total alpha depends on all fragments in front of the opaque geometry, the coverage pass discards
+    // and occludes most of them. Thus, only the depth-based color accumulation can take it over.
+    return m_options->fusePasses() &&
+        m_options->optimization() == StochasticTransparencyOptimization::AlphaCorrectionAndDepthBased;
 }
 
 void StochasticTransparency::updateNumSamples()
 {
-    setupMasksTexture();
     updateFramebuffer();
     updateNumSamplesUniforms();
 }
 
 void StochasticTransparency::updateNumSamplesUniforms()
 {
-    m_compositingProgram->setUniform("numSamples", static_cast<int>(m_options->numSamples()));
+    const auto numSamples = static_cast<int>(m_options->numSamples());
+    
+    for (auto & program : m_alphaToCoveragePrograms)
+    {
+        program->setUniform("masksLayer", numSamples - 1);
+        program->setUniform("numSamples", numSamples);
+    }
+    
+    m_compositingProgram->setUniform("numSamples", numSamples);
+}
+
+void StochasticTransparency::updateBenchmark()
+{
+    if (m_options->benchmark() && !m_benchmark)
+    {
+        m_benchmark = make_unique<MaskSourceBenchmark>(m_options->maxNumSamples());
+        m_restoredMaskSource = m_options->maskSource();
+        m_restoredNumSamples = m_options->numSamples();
+    }
+    else if (m_benchmark)
+    {
+        m_benchmark->addFrame(m_options->coverageTime());
+    }
+    
+    if (!m_benchmark)
+        return;
+    
+    // Finished or cancelled through the property
+    if (m_benchmark->finished() || !m_options->benchmark())
+    {
+        if (m_benchmark->finished())
+            m_benchmark->print(std::cout);
+        
+        m_options->setMaskSource(m_restoredMaskSource);
+        m_options->setNumSamples(m_restoredNumSamples);
+        m_options->setBenchmark(false);
+        
+        m_benchmark.reset();
+        return;
+    }
+    
+    m_options->setMaskSource(m_benchmark->maskSource());
+    
+    if (m_options->numSamples() != m_benchmark->numSamples())
+        m_options->setNumSamples(m_benchmark->numSamples());
 }
 
 void StochasticTransparency::clearBuffers()
@@ -274,8 +486,20 @@ void StochasticTransparency::updateUniforms()
     };
     
     updateProgramUniforms(m_totalAlphaProgram);
-    updateProgramUniforms(m_alphaToCoverageProgram);
+    for (auto & program : m_alphaToCoveragePrograms)
+        updateProgramUniforms(program);
+    
     updateProgramUniforms(m_colorAccumulationProgram);
+    updateProgramUniforms(m_fusedAccumulationProgram);
+    
+    // Without temporal accumulation, masks stay the same in every frame
+    if (m_options->temporalAccumulation())
+        m_frame = (m_frame + 1u) % 1024u;
+    else
+        m_frame = 0u;
+    
+    for (auto & program : m_alphaToCoveragePrograms)
+        program->setUniform("frame", static_cast<int>(m_frame));
 }
 
 void StochasticTransparency::renderOpaqueGeometry()
@@ -291,15 +515,23 @@ void StochasticTransparency::renderOpaqueGeometry()
 
 void StochasticTransparency::renderTransparentGeometry()
 {
-    if (m_options->backFaceCulling())
+    if (m_sceneOptions->backFaceCulling())
         glEnable(GL_CULL_FACE);
     
-    renderTotalAlpha();
+    const auto fused = fusedAccumulation();
+    
+    if (!fused)
+        renderTotalAlpha();
     
     glEnable(GL_SAMPLE_SHADING);
     glMinSampleShading(1.0);
 
-    if (m_options->optimization() == StochasticTransparencyOptimization::AlphaCorrection)
+    if (fused)
+    {
+        renderStochasticDepth();
+        renderFusedAccumulation();
+    }
+    else if (m_options->optimization() == StochasticTransparencyOptimization::AlphaCorrection)
     {
         renderAlphaToCoverage(kTransparentColorAttachment);
     }
@@ -329,8 +561,7 @@ void StochasticTransparency::renderTotalAlpha()
     
     m_totalAlphaProgram->use();
     
-    for (auto & drawable : m_drawables)
-        drawable->draw();
+    m_scene->draw(m_totalAlphaProgram);
     
     m_totalAlphaProgram->release();
     
@@ -345,14 +576,42 @@ void StochasticTransparency::renderAlphaToCoverage(gl::GLenum colorAttachment)
     m_fbo->bind(GL_FRAMEBUFFER);
     m_fbo->setDrawBuffer(colorAttachment);
     
-    m_masksTexture->bindActive(GL_TEXTURE0);
-
-    m_alphaToCoverageProgram->use();
-
-    for (auto & drawable : m_drawables)
-        drawable->draw();
+    renderCoverage();
+}
 
-    m_alphaToCoverageProgram->release();
+void StochasticTransparency::renderCoverage()
+{
+    const auto source = m_options->maskSource();
+    const auto & program = m_alphaToCoveragePrograms[static_cast<std::size_t>(source)];
+    
+    // Table masks are looked up per sample, the other sources cover all samples in one invocation
+    if (source != MaskSource::Table)
+        glDisable(GL_SAMPLE_SHADING);
+    
+    // Covered samples are opaque with the other sources as well
+    if (source == MaskSource::NativeAlphaToCoverage)
+    {
+        glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+        glEnable(GL_SAMPLE_ALPHA_TO_ONE);
+    }
+    
+    m_masksTexture->bindActive(GL_TEXTURE0);
+    
+    m_timer->begin(0u);
+    
+    program->use();
+    
+    m_scene->draw(program);
+    
+    program->release();
+    
+    m_timer->end();
+    
+    glDisable(GL_SAMPLE_ALPHA_TO_ONE);
+    glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+    
+    if (source != MaskSource::Table)
+        glEnable(GL_SAMPLE_SHADING);
 }
 
 void StochasticTransparency::renderColorAccumulation()
@@ -370,8 +629,7 @@ void StochasticTransparency::renderColorAccumulation()
     
     m_colorAccumulationProgram->use();
     
-    for (auto & drawable : m_drawables)
-        drawable->draw();
+    m_scene->draw(m_colorAccumulationProgram);
     
     m_colorAccumulationProgram->release();
 
@@ -379,6 +637,50 @@ void StochasticTransparency::renderColorAccumulation()
     glDepthFunc(GL_LESS);
 }
 
+void StochasticTransparency::renderStochasticDepth()
+{
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+    
+    // Starts from the opaque depth, which stays unchanged for the depth test of the fused pass
+    m_fbo->blit(kOpaqueColorAttachment, rect, m_stochasticDepthFbo, GL_NONE, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    
+    m_stochasticDepthFbo->bind(GL_FRAMEBUFFER);
+    
+    renderCoverage();
+}
+
+void StochasticTransparency::renderFusedAccumulation()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    
+    // Additive color and multiplicative total alpha, set per attachment
+    glEnable(GL_BLEND);
+    glBlendFunci(0, GL_ONE, GL_ONE);
+    glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+    
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->setDrawBuffers({ kTransparentColorAttachment, kTotalAlphaAttachment });
+    
+    m_stochasticDepthAttachment->bindActive(GL_TEXTURE0);
+    
+    m_fusedAccumulationProgram->use();
+    
+    m_scene->draw(m_fusedAccumulationProgram);
+    
+    m_fusedAccumulationProgram->release();
+    
+    glDisable(GL_BLEND);
+}
+
 void StochasticTransparency::blit()
 {
     auto targetfbo = m_targetFramebufferCapability->framebuffer();
@@ -406,6 +708,29 @@ void StochasticTransparency::composite()
     glDisable(GL_DEPTH_TEST);
     glDepthMask(GL_TRUE);
     
+    m_opaqueColorAttachment->bindActive(GL_TEXTURE0);
+    m_totalAlphaAttachment->bindActive(GL_TEXTURE1);
+    m_transparentColorAttachment->bindActive(GL_TEXTURE2);
+    
+    if (m_options->computeCompositing())
+    {
+        dispatchCompositing();
+        
+        // Presented by accumulateHistory() instead
+        if (!m_options->temporalAccumulation())
+            present(m_currentFbo);
+        
+        return;
+    }
+    
+    // Presented by accumulateHistory() instead
+    if (m_options->temporalAccumulation())
+    {
+        m_currentFbo->bind(GL_FRAMEBUFFER);
+        m_compositingQuad->draw();
+        return;
+    }
+    
     auto targetfbo = m_targetFramebufferCapability->framebuffer();
     
     if (!targetfbo)
@@ -413,10 +738,6 @@ void StochasticTransparency::composite()
     
     targetfbo->bind(GL_FRAMEBUFFER);
     
-    m_opaqueColorAttachment->bindActive(GL_TEXTURE0);
-    m_totalAlphaAttachment->bindActive(GL_TEXTURE1);
-    m_transparentColorAttachment->bindActive(GL_TEXTURE2);
-    
     m_compositingQuad->draw();
     
     const auto rect = std::array<GLint, 4>{{
@@ -428,3 +749,96 @@ void StochasticTransparency::composite()
 
     m_fbo->blit(GL_COLOR_ATTACHMENT0, rect, targetfbo, GL_BACK_LEFT, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 }
+
+void StochasticTransparency::dispatchCompositing()
+{
+    static const auto localSize = 8;
+    
+    if (!m_compositingComputeProgram)
+    {
+        m_compositingComputeProgram = make_ref<Program>();
+        m_compositingComputeProgram->attach(Shader::fromFile(GL_COMPUTE_SHADER, "data/transparency/compositing.comp"));
+        
+        m_compositingComputeProgram->setUniform("opaqueColorTexture", 0);
+        m_compositingComputeProgram->setUniform("totalAlphaTexture", 1);
+        m_compositingComputeProgram->setUniform("transparentColorTexture", 2);
+    }
+    
+    const auto size = glm::ivec2{m_viewportCapability->width(), m_viewportCapability->height()};
+    
+    m_compositingComputeProgram->setUniform("numSamples", static_cast<int>(m_options->numSamples()));
+    m_compositingComputeProgram->setUniform("size", size);
+    
+    m_currentColorAttachment->bindImageTexture(0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    
+    m_compositingComputeProgram->use();
+    m_compositingComputeProgram->dispatchCompute(
+        static_cast<GLuint>((size.x + localSize - 1) / localSize),
+        static_cast<GLuint>((size.y + localSize - 1) / localSize),
+        1u);
+    m_compositingComputeProgram->release();
+    
+    // The current frame is either blitted or sampled by the temporal accumulation
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void StochasticTransparency::resolveCurrentFrame()
+{
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+    
+    m_fbo->blit(kOpaqueColorAttachment, rect, m_currentFbo, GL_COLOR_ATTACHMENT0, rect, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+}
+
+void StochasticTransparency::accumulateHistory()
+{
+    const auto viewProjection = m_projectionCapability->projection() * m_cameraCapability->view();
+    const auto previous = m_historyIndex;
+    const auto next = 1u - m_historyIndex;
+    
+    glDisable(GL_DEPTH_TEST);
+    
+    m_historyFbos[next]->bind(GL_FRAMEBUFFER);
+    
+    m_currentColorAttachment->bindActive(GL_TEXTURE0);
+    m_historyAttachments[previous]->bindActive(GL_TEXTURE1);
+    m_depthAttachment->bindActive(GL_TEXTURE2);
+    
+    // Maps clip space of this frame to clip space of the previous one, assuming a static scene
+    m_temporalProgram->setUniform("reprojection", m_previousViewProjection * glm::inverse(viewProjection));
+    m_temporalProgram->setUniform("historyWeight", m_historyValid ? m_options->historyWeight() : 0.0f);
+    
+    m_temporalQuad->draw();
+    
+    m_previousViewProjection = viewProjection;
+    m_historyIndex = next;
+    m_historyValid = true;
+    
+    present(m_historyFbos[next]);
+}
+
+void StochasticTransparency::present(globjects::Framebuffer * fbo)
+{
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+    
+    fbo->blit(GL_COLOR_ATTACHMENT0, rect, targetfbo, drawBuffer, rect, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    m_fbo->blit(kOpaqueColorAttachment, rect, targetfbo, drawBuffer, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 #include <glbinding/gl/types.h>
 #include <glbinding/gl/enum.h>
 
@@ -27,11 +30,18 @@ namespace gloperate
     class AbstractPerspectiveProjectionCapability;
     class AbstractCameraCapability;
     class ScreenAlignedQuad;
-    class PolygonalDrawable;
 }
 
+class DepthPyramid;
+class MaskSourceBenchmark;
+class MasksTableCache;
+class PassTimer;
+class SceneDrawable;
+class SceneOptions;
 class StochasticTransparencyOptions;
 
+enum class MaskSource;
+
 class StochasticTransparency : public gloperate::Painter
 {
 public:
@@ -48,9 +58,13 @@ protected:
     void setupPrograms();
     void setupMasksTexture();
     void setupDrawable();
+    void cullDrawables();
     void updateFramebuffer();
+    void updateStochasticDepth();
     void updateNumSamples();
     void updateNumSamplesUniforms();
+    void updateBenchmark();
+    bool fusedAccumulation() const;
     
 protected:
     void clearBuffers();
@@ -59,9 +73,16 @@ protected:
     void renderTransparentGeometry();
     void renderTotalAlpha();
     void renderAlphaToCoverage(gl::GLenum colorAttachment);
+    void renderCoverage();
     void renderColorAccumulation();
+    void renderStochasticDepth();
+    void renderFusedAccumulation();
     void blit();
     void composite();
+    void dispatchCompositing();
+    void resolveCurrentFrame();
+    void accumulateHistory();
+    void present(globjects::Framebuffer * fbo);
 
 private:
     /** \name Capabilities */
@@ -72,6 +93,8 @@ private:
     gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
     gloperate::AbstractCameraCapability * m_cameraCapability;
     
+    bool m_multiDraw; ///< see SceneDrawable::multiDrawSupported(), selects the vertex shaders
+    
     /** \} */
 
     /** \name Framebuffers and Textures */
@@ -87,6 +110,17 @@ private:
     globjects::ref_ptr<globjects::Texture> m_totalAlphaAttachment;
     globjects::ref_ptr<globjects::Texture> m_depthAttachment;
     
+    /** Stochastic depth of the fused passes, m_depthAttachment keeps the opaque depth. Only allocated while fusedAccumulation() holds. */
+    globjects::ref_ptr<globjects::Framebuffer> m_stochasticDepthFbo;
+    globjects::ref_ptr<globjects::Texture> m_stochasticDepthAttachment;
+    bool m_fusedAccumulation;
+    
+    /** Resolved current frame and ping-ponged history of the temporal accumulation */
+    globjects::ref_ptr<globjects::Framebuffer> m_currentFbo;
+    globjects::ref_ptr<globjects::Texture> m_currentColorAttachment;
+    std::array<globjects::ref_ptr<globjects::Framebuffer>, 2u> m_historyFbos;
+    std::array<globjects::ref_ptr<globjects::Texture>, 2u> m_historyAttachments;
+    
     /** \} */
     
     /** \name Programs */
@@ -94,21 +128,31 @@ private:
     
     globjects::ref_ptr<globjects::Program> m_totalAlphaProgram;
     
-    globjects::ref_ptr<globjects::Program> m_alphaToCoverageProgram;
+    /** One program per MaskSource */
+    std::array<globjects::ref_ptr<globjects::Program>, 3u> m_alphaToCoveragePrograms;
     globjects::ref_ptr<globjects::Texture> m_masksTexture;
     
     globjects::ref_ptr<globjects::Program> m_colorAccumulationProgram;
     
+    globjects::ref_ptr<globjects::Program> m_fusedAccumulationProgram;
+    
     globjects::ref_ptr<globjects::Program> m_compositingProgram;
     
+    /** Created on first use, requires compute shader support */
+    globjects::ref_ptr<globjects::Program> m_compositingComputeProgram;
+    
+    globjects::ref_ptr<globjects::Program> m_temporalProgram;
+    
     /** \} */
     
     /** \name Geometry */
     /** \{ */
     
     globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
-    std::vector<std::unique_ptr<gloperate::PolygonalDrawable>> m_drawables;
+    std::unique_ptr<SceneDrawable> m_scene;
+    std::unique_ptr<DepthPyramid> m_depthPyramid;
     globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_compositingQuad;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_temporalQuad;
     
     /** \} */
 
@@ -116,6 +160,34 @@ private:
     /** \{ */
     
     std::unique_ptr<StochasticTransparencyOptions> m_options;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
+    
+    /** \} */
+    
+    /** \name Masks Table */
+    /** \{ */
+    
+    std::unique_ptr<MasksTableCache> m_masksTableCache;
+    
+    /** \} */
+    
+    /** \name Benchmark */
+    /** \{ */
+    
+    std::unique_ptr<PassTimer> m_timer;
+    std::unique_ptr<MaskSourceBenchmark> m_benchmark;
+    MaskSource m_restoredMaskSource;
+    uint16_t m_restoredNumSamples;
+    
+    /** \} */
+    
+    /** \name Temporal Accumulation */
+    /** \{ */
+    
+    unsigned int m_frame;
+    unsigned int m_historyIndex;
+    bool m_historyValid;
+    glm::mat4 m_previousViewProjection;
     
     /** \} */
 };
@@ -3,9 +3,12 @@
 #include <glm/common.hpp>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
 
 #include <globjects/globjects.h>
 
+#include "../SceneDrawable.h"
+#include "MasksTableGenerator.h"
 #include "StochasticTransparency.h"
 
 
@@ -13,9 +16,22 @@ StochasticTransparencyOptions::StochasticTransparencyOptions(StochasticTranspare
 :   m_painter(painter)
 ,   m_transparency(160u)
 ,   m_optimization(StochasticTransparencyOptimization::AlphaCorrection)
-,   m_backFaceCulling(false)
+,   m_fusePasses(false)
 ,   m_numSamples(8u)
+,   m_maxNumSamples(8u)
 ,   m_numSamplesChanged(true)
+,   m_maskDistribution(MaskDistribution::Random)
+,   m_maskDistributionChanged(false)
+,   m_maskSource(MaskSource::Table)
+,   m_computeCompositing(true)
+,   m_computeCompositingSupported(false)
+,   m_temporalAccumulation(false)
+,   m_historyWeight(0.9f)
+,   m_gpuCulling(false)
+,   m_occlusionCulling(false)
+,   m_gpuCullingSupported(false)
+,   m_coverageTime(0.0f)
+,   m_benchmark(false)
 {   
     painter.addProperty<unsigned char>("transparency", this,
         &StochasticTransparencyOptions::transparency, 
@@ -31,23 +47,82 @@ StochasticTransparencyOptions::StochasticTransparencyOptions(StochasticTranspare
         { StochasticTransparencyOptimization::AlphaCorrection, "AlphaCorrection" },
         { StochasticTransparencyOptimization::AlphaCorrectionAndDepthBased, "AlphaCorrectionAndDepthBased" }});
     
-    painter.addProperty<bool>("back_face_culling", this,
-        &StochasticTransparencyOptions::backFaceCulling, 
-        &StochasticTransparencyOptions::setBackFaceCulling);
+    painter.addProperty<bool>("fuse_passes", this,
+        &StochasticTransparencyOptions::fusePasses,
+        &StochasticTransparencyOptions::setFusePasses);
     
     painter.addProperty<uint16_t>("num_samples", this,
         &StochasticTransparencyOptions::numSamples,
         &StochasticTransparencyOptions::setNumSamples)->setOptions({
         { "minimum", 1u }});
+    
+    painter.addProperty<MaskDistribution>("mask_distribution", this,
+        &StochasticTransparencyOptions::maskDistribution,
+        &StochasticTransparencyOptions::setMaskDistribution)->setStrings({
+        { MaskDistribution::Random, "Random" },
+        { MaskDistribution::Stratified, "Stratified" },
+        { MaskDistribution::LowDiscrepancy, "LowDiscrepancy" },
+        { MaskDistribution::BlueNoise, "BlueNoise" }});
+    
+    painter.addProperty<MaskSource>("mask_source", this,
+        &StochasticTransparencyOptions::maskSource,
+        &StochasticTransparencyOptions::setMaskSource)->setStrings({
+        { MaskSource::Table, "Table" },
+        { MaskSource::NativeAlphaToCoverage, "NativeAlphaToCoverage" },
+        { MaskSource::IntegerHash, "IntegerHash" }});
+    
+    painter.addProperty<bool>("compute_compositing", this,
+        &StochasticTransparencyOptions::computeCompositing,
+        &StochasticTransparencyOptions::setComputeCompositing);
+    
+    painter.addProperty<bool>("temporal_accumulation", this,
+        &StochasticTransparencyOptions::temporalAccumulation,
+        &StochasticTransparencyOptions::setTemporalAccumulation);
+    
+    painter.addProperty<float>("history_weight", this,
+        &StochasticTransparencyOptions::historyWeight,
+        &StochasticTransparencyOptions::setHistoryWeight)->setOptions({
+        { "minimum", 0.0f },
+        { "maximum", 0.98f },
+        { "step", 0.01f },
+        { "precision", 2u }});
+    
+    painter.addProperty<bool>("gpu_culling", this,
+        &StochasticTransparencyOptions::gpuCulling,
+        &StochasticTransparencyOptions::setGpuCulling);
+    
+    painter.addProperty<bool>("occlusion_culling", this,
+        &StochasticTransparencyOptions::occlusionCulling,
+        &StochasticTransparencyOptions::setOcclusionCulling);
+    
+    // Read-only, the setter is meant for the painter only
+    painter.addProperty<float>("coverage_ms", this,
+        &StochasticTransparencyOptions::coverageTime);
+    
+    painter.addProperty<bool>("benchmark", this,
+        &StochasticTransparencyOptions::benchmark,
+        &StochasticTransparencyOptions::setBenchmark);
 }
 
 StochasticTransparencyOptions::~StochasticTransparencyOptions() = default;
 
 void StochasticTransparencyOptions::initGL()
 {
-    const auto maxNumSamples = globjects::getInteger(gl::GL_MAX_COLOR_TEXTURE_SAMPLES);
+    const auto maxColorSamples = globjects::getInteger(gl::GL_MAX_COLOR_TEXTURE_SAMPLES);
+    const auto maxDepthSamples = globjects::getInteger(gl::GL_MAX_DEPTH_TEXTURE_SAMPLES);
+    const auto maxMaskSamples = static_cast<int>(MasksTableGeneratorBase::s_maxNumSamples);
+    
+    m_maxNumSamples = static_cast<uint16_t>(glm::min(glm::min(maxColorSamples, maxDepthSamples), maxMaskSamples));
+    m_numSamples = glm::min(m_numSamples, m_maxNumSamples);
     
-    m_painter.property("num_samples")->setOption("maximum", static_cast<uint16_t>(glm::min(8, maxNumSamples)));
+    m_painter.property("num_samples")->setOption("maximum", m_maxNumSamples);
+    
+    m_computeCompositingSupported = globjects::hasExtension(gl::GLextension::GL_ARB_compute_shader);
+    
+    // The number of draws is read from the buffer written by the culling shader, which only the multi draw path can do
+    m_gpuCullingSupported = m_computeCompositingSupported
+        && globjects::hasExtension(gl::GLextension::GL_ARB_indirect_parameters)
+        && SceneDrawable::multiDrawSupported();
 }
 
 unsigned char StochasticTransparencyOptions::transparency() const
@@ -70,14 +145,14 @@ void StochasticTransparencyOptions::setOptimization(StochasticTransparencyOptimi
     m_optimization = optimization;
 }
 
-bool StochasticTransparencyOptions::backFaceCulling() const
+bool StochasticTransparencyOptions::fusePasses() const
 {
-    return m_backFaceCulling;
+    return m_fusePasses;
 }
 
-void StochasticTransparencyOptions::setBackFaceCulling(bool b)
+void StochasticTransparencyOptions::setFusePasses(bool b)
 {
-    m_backFaceCulling = b;
+    m_fusePasses = b;
 }
 
 uint16_t StochasticTransparencyOptions::numSamples() const
@@ -91,9 +166,122 @@ void StochasticTransparencyOptions::setNumSamples(uint16_t numSamples)
     m_numSamplesChanged = true;
 }
 
+uint16_t StochasticTransparencyOptions::maxNumSamples() const
+{
+    return m_maxNumSamples;
+}
+
 bool StochasticTransparencyOptions::numSamplesChanged() const
 {
     const auto changed = m_numSamplesChanged;
     m_numSamplesChanged = false;
     return changed;
 }
+
+MaskDistribution StochasticTransparencyOptions::maskDistribution() const
+{
+    return m_maskDistribution;
+}
+
+void StochasticTransparencyOptions::setMaskDistribution(MaskDistribution distribution)
+{
+    m_maskDistribution = distribution;
+    m_maskDistributionChanged = true;
+}
+
+bool StochasticTransparencyOptions::maskDistributionChanged() const
+{
+    const auto changed = m_maskDistributionChanged;
+    m_maskDistributionChanged = false;
+    return changed;
+}
+
+MaskSource StochasticTransparencyOptions::maskSource() const
+{
+    return m_maskSource;
+}
+
+void StochasticTransparencyOptions::setMaskSource(MaskSource source)
+{
+    m_maskSource = source;
+}
+
+bool StochasticTransparencyOptions::computeCompositing() const
+{
+    return m_computeCompositing && m_computeCompositingSupported;
+}
+
+void StochasticTransparencyOptions::setComputeCompositing(bool b)
+{
+    m_computeCompositing = b;
+}
+
+bool StochasticTransparencyOptions::computeCompositingSupported() const
+{
+    return m_computeCompositingSupported;
+}
+
+bool StochasticTransparencyOptions::temporalAccumulation() const
+{
+    return m_temporalAccumulation;
+}
+
+void StochasticTransparencyOptions::setTemporalAccumulation(bool b)
+{
+    m_temporalAccumulation = b;
+}
+
+float StochasticTransparencyOptions::historyWeight() const
+{
+    return m_historyWeight;
+}
+
+void StochasticTransparencyOptions::setHistoryWeight(float weight)
+{
+    m_historyWeight = weight;
+}
+
+bool StochasticTransparencyOptions::gpuCulling() const
+{
+    return (m_gpuCulling || m_occlusionCulling) && m_gpuCullingSupported;
+}
+
+void StochasticTransparencyOptions::setGpuCulling(bool b)
+{
+    m_gpuCulling = b;
+}
+
+bool StochasticTransparencyOptions::occlusionCulling() const
+{
+    return m_occlusionCulling && m_gpuCullingSupported;
+}
+
+void StochasticTransparencyOptions::setOcclusionCulling(bool b)
+{
+    m_occlusionCulling = b;
+}
+
+bool StochasticTransparencyOptions::gpuCullingSupported() const
+{
+    return m_gpuCullingSupported;
+}
+
+float StochasticTransparencyOptions::coverageTime() const
+{
+    return m_coverageTime;
+}
+
+void StochasticTransparencyOptions::setCoverageTime(float milliseconds)
+{
+    m_coverageTime = milliseconds;
+}
+
+bool StochasticTransparencyOptions::benchmark() const
+{
+    return m_benchmark;
+}
+
+void StochasticTransparencyOptions::setBenchmark(bool b)
+{
+    m_benchmark = b;
+}
@@ -7,8 +7,13 @@
 
 class StochasticTransparency;
 
+enum class MaskDistribution;
+
 enum class StochasticTransparencyOptimization { NoOptimization, AlphaCorrection, AlphaCorrectionAndDepthBased };
 
+/** Table: pre-generated masks texture, NativeAlphaToCoverage: GL_SAMPLE_ALPHA_TO_COVERAGE, IntegerHash: built in the shader */
+enum class MaskSource { Table, NativeAlphaToCoverage, IntegerHash };
+
 class StochasticTransparencyOptions
 {
 public:
@@ -23,20 +28,78 @@ public:
     StochasticTransparencyOptimization optimization() const;
     void setOptimization(StochasticTransparencyOptimization optimization);
     
-    bool backFaceCulling() const;
-    void setBackFaceCulling(bool b);
+    /** Accumulates color and total alpha in a single pass, only affects AlphaCorrectionAndDepthBased */
+    bool fusePasses() const;
+    void setFusePasses(bool b);
     
     uint16_t numSamples() const;
     void setNumSamples(uint16_t numSamples);
     
+    /** Upper bound of num_samples, valid after initGL() */
+    uint16_t maxNumSamples() const;
+    
     bool numSamplesChanged() const;
+    
+    MaskDistribution maskDistribution() const;
+    void setMaskDistribution(MaskDistribution distribution);
+    
+    bool maskDistributionChanged() const;
+    
+    MaskSource maskSource() const;
+    void setMaskSource(MaskSource source);
+    
+    /** Composites with a compute shader instead of a full-screen quad, ignored without compute shader support */
+    bool computeCompositing() const;
+    void setComputeCompositing(bool b);
+    
+    /** Valid after initGL() */
+    bool computeCompositingSupported() const;
+    
+    /** Varies the masks per frame and blends the result with the reprojected previous frames */
+    bool temporalAccumulation() const;
+    void setTemporalAccumulation(bool b);
+    
+    /** Weight of the reprojected history, higher values converge further but react slower */
+    float historyWeight() const;
+    void setHistoryWeight(float weight);
+    
+    /** Culls with a compute shader, implied by occlusion culling, ignored without GPU culling support */
+    bool gpuCulling() const;
+    void setGpuCulling(bool b);
+    
+    bool occlusionCulling() const;
+    void setOcclusionCulling(bool b);
+    
+    /** Valid after initGL() */
+    bool gpuCullingSupported() const;
+    
+    /** GPU time of the coverage pass in milliseconds, set by the painter */
+    float coverageTime() const;
+    void setCoverageTime(float milliseconds);
+    
+    /** Times the coverage pass of all mask sources at all sample counts, resets itself when done */
+    bool benchmark() const;
+    void setBenchmark(bool b);
 
 private:
     StochasticTransparency & m_painter;
 
     unsigned char m_transparency;
     StochasticTransparencyOptimization m_optimization;
-    bool m_backFaceCulling;
+    bool m_fusePasses;
     uint16_t m_numSamples;
+    uint16_t m_maxNumSamples;
     mutable bool m_numSamplesChanged;
+    MaskDistribution m_maskDistribution;
+    mutable bool m_maskDistributionChanged;
+    MaskSource m_maskSource;
+    bool m_computeCompositing;
+    bool m_computeCompositingSupported;
+    bool m_temporalAccumulation;
+    float m_historyWeight;
+    bool m_gpuCulling;
+    bool m_occlusionCulling;
+    bool m_gpuCullingSupported;
+    float m_coverageTime;
+    bool m_benchmark;
 };
@@ -0,0 +1,295 @@
+#include "WeightedBlended.h"
+
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <glbinding/Version.h>
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/DebugMessage.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/base/RenderTargetType.h>
+#include <gloperate/resources/ResourceManager.h>
+#include <gloperate/painter/TargetFramebufferCapability.h>
+#include <gloperate/painter/ViewportCapability.h>
+#include <gloperate/painter/PerspectiveProjectionCapability.h>
+#include <gloperate/painter/CameraCapability.h>
+#include <gloperate/primitives/AdaptiveGrid.h>
+#include <gloperate/primitives/ScreenAlignedQuad.h>
+
+#include <reflectionzeug/PropertyGroup.h>
+
+#include <widgetzeug/make_unique.hpp>
+
+#include "../MeshCache.h"
+#include "../SceneDrawable.h"
+#include "../SceneOptions.h"
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+using widgetzeug::make_unique;
+
+WeightedBlended::WeightedBlended(gloperate::ResourceManager & resourceManager)
+:   Painter(resourceManager)
+,   m_targetFramebufferCapability(addCapability(new gloperate::TargetFramebufferCapability()))
+,   m_viewportCapability(addCapability(new gloperate::ViewportCapability()))
+,   m_projectionCapability(addCapability(new gloperate::PerspectiveProjectionCapability(m_viewportCapability)))
+,   m_cameraCapability(addCapability(new gloperate::CameraCapability()))
+,   m_multiDraw(false)
+,   m_drawBuffersBlend(false)
+,   m_drawBuffersBlendCore(false)
+,   m_transparency(160u)
+{
+    setupPropertyGroup();
+}
+
+WeightedBlended::~WeightedBlended() = default;
+
+void WeightedBlended::setupPropertyGroup()
+{
+    addProperty<unsigned char>("transparency", this,
+        &WeightedBlended::transparency, &WeightedBlended::setTransparency)->setOptions({
+        { "minimum", 0 },
+        { "maximum", 255 },
+        { "step", 1 }});
+    
+    m_sceneOptions = make_unique<SceneOptions>(*this);
+}
+
+unsigned char WeightedBlended::transparency() const
+{
+    return m_transparency;
+}
+
+void WeightedBlended::setTransparency(unsigned char transparency)
+{
+    m_transparency = transparency;
+}
+
+void WeightedBlended::onInitialize()
+{
+    globjects::init();
+    globjects::DebugMessage::enable();
+
+#ifdef __APPLE__
+    Shader::clearGlobalReplacements();
+    Shader::globalReplace("#version 140", "#version 150");
+
+    debug() << "Using global OS X shader replacement '#version 140' -> '#version 150'" << std::endl;
+#endif
+
+    m_multiDraw = SceneDrawable::multiDrawSupported();
+    m_drawBuffersBlendCore = globjects::version() >= glbinding::Version(4, 0);
+    m_drawBuffersBlend = m_drawBuffersBlendCore || globjects::hasExtension(GLextension::GL_ARB_draw_buffers_blend);
+
+    if (!m_drawBuffersBlend)
+    {
+        std::cout << "WeightedBlended requires OpenGL 4.0 or GL_ARB_draw_buffers_blend" << std::endl;
+        return;
+    }
+
+    m_grid = make_ref<gloperate::AdaptiveGrid>();
+    m_grid->setColor({0.6f, 0.6f, 0.6f});
+
+    setupPrograms();
+    setupProjection();
+    setupFramebuffer();
+    setupDrawable();
+}
+
+void WeightedBlended::onPaint()
+{
+    if (!m_drawBuffersBlend)
+        return;
+    
+    if (m_viewportCapability->hasChanged())
+    {
+        glViewport(
+            m_viewportCapability->x(),
+            m_viewportCapability->y(),
+            m_viewportCapability->width(),
+            m_viewportCapability->height());
+
+        m_viewportCapability->setChanged(false);
+        
+        updateFramebuffer();
+    }
+
+    clearBuffers();
+    renderOpaqueGeometry();
+    
+    m_scene->update(*m_cameraCapability, *m_projectionCapability, *m_viewportCapability, *m_sceneOptions);
+    
+    renderTransparentGeometry();
+    resolve();
+    
+    Framebuffer::unbind(GL_FRAMEBUFFER);
+}
+
+void WeightedBlended::setupFramebuffer()
+{
+    m_opaqueColorAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_accumulationAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_revealageAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    m_depthAttachment = Texture::createDefault(GL_TEXTURE_2D);
+    
+    updateFramebuffer();
+    
+    m_fbo = make_ref<Framebuffer>();
+    
+    m_fbo->attachTexture(kOpaqueColorAttachment, m_opaqueColorAttachment);
+    m_fbo->attachTexture(kAccumulationAttachment, m_accumulationAttachment);
+    m_fbo->attachTexture(kRevealageAttachment, m_revealageAttachment);
+    m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depthAttachment);
+    
+    m_fbo->printStatus(true);
+}
+
+void WeightedBlended::setupProjection()
+{
+    static const auto zNear = 0.3f, zFar = 30.f, fovy = 50.f;
+
+    m_projectionCapability->setZNear(zNear);
+    m_projectionCapability->setZFar(zFar);
+    m_projectionCapability->setFovy(radians(fovy));
+
+    m_grid->setNearFar(zNear, zFar);
+}
+
+void WeightedBlended::setupPrograms()
+{
+    static const auto shaderPath = std::string{"data/transparency/"};
+    
+    m_accumulationProgram = make_ref<Program>();
+    m_accumulationProgram->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, shaderPath + (m_multiDraw ? "weighted_blended.vert" : "weighted_blended_legacy.vert")),
+        Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + "weighted_blended.frag"));
+    
+    m_resolveProgram = make_ref<Program>();
+    m_resolveProgram->attach(
+        Shader::fromFile(GL_VERTEX_SHADER, shaderPath + "compositing.vert"),
+        Shader::fromFile(GL_FRAGMENT_SHADER, shaderPath + "weighted_blended_resolve.frag"));
+    
+    m_resolveProgram->setUniform("opaqueColorTexture", 0);
+    m_resolveProgram->setUniform("accumulationTexture", 1);
+    m_resolveProgram->setUniform("revealageTexture", 2);
+    
+    m_resolveQuad = make_ref<gloperate::ScreenAlignedQuad>(m_resolveProgram);
+}
+
+void WeightedBlended::setupDrawable()
+{
+    m_scene = make_unique<SceneDrawable>(PositionFormat::Quantized);
+    m_scene->load("data/transparency/transparency_scene.obj", MeshCache{"data/transparency/cache", true});
+}
+
+void WeightedBlended::updateFramebuffer()
+{
+    const auto width = m_viewportCapability->width(), height = m_viewportCapability->height();
+    
+    m_opaqueColorAttachment->image2D(0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_accumulationAttachment->image2D(0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    m_revealageAttachment->image2D(0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    m_depthAttachment->image2D(0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr);
+}
+
+void WeightedBlended::clearBuffers()
+{
+    m_fbo->setDrawBuffers({ kOpaqueColorAttachment, kAccumulationAttachment, kRevealageAttachment });
+    
+    m_fbo->clearBuffer(GL_COLOR, 0, glm::vec4(0.85f, 0.87f, 0.91f, 1.0f));
+    m_fbo->clearBuffer(GL_COLOR, 1, glm::vec4(0.0f));
+    m_fbo->clearBuffer(GL_COLOR, 2, glm::vec4(1.0f));
+    m_fbo->clearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0.0f);
+}
+
+void WeightedBlended::renderOpaqueGeometry()
+{
+    const auto transform = m_projectionCapability->projection() * m_cameraCapability->view();
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->setDrawBuffer(kOpaqueColorAttachment);
+
+    m_grid->update(m_cameraCapability->eye(), transform);
+    m_grid->draw();
+}
+
+void WeightedBlended::renderTransparentGeometry()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    
+    if (m_sceneOptions->backFaceCulling())
+        glEnable(GL_CULL_FACE);
+    
+    // Weighted colors are summed up, revealage is the product of (1 - alpha) over all fragments
+    // Older contexts only provide the entry point of the extension
+    const auto blendFunci = m_drawBuffersBlendCore ? &glBlendFunci : &glBlendFunciARB;
+    
+    glEnable(GL_BLEND);
+    blendFunci(0, GL_ONE, GL_ONE);
+    blendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+    
+    m_fbo->bind(GL_FRAMEBUFFER);
+    m_fbo->setDrawBuffers({ kAccumulationAttachment, kRevealageAttachment });
+    
+    m_accumulationProgram->use();
+    m_accumulationProgram->setUniform("transform", m_projectionCapability->projection() * m_cameraCapability->view());
+    m_accumulationProgram->setUniform("transparency", static_cast<unsigned int>(m_transparency));
+    
+    m_scene->draw(m_accumulationProgram);
+    
+    m_accumulationProgram->release();
+    
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+}
+
+void WeightedBlended::resolve()
+{
+    glDisable(GL_DEPTH_TEST);
+    
+    auto targetfbo = m_targetFramebufferCapability->framebuffer();
+    auto drawBuffer = GL_COLOR_ATTACHMENT0;
+    
+    if (!targetfbo)
+    {
+        targetfbo = Framebuffer::defaultFBO();
+        drawBuffer = GL_BACK_LEFT;
+    }
+    
+    targetfbo->bind(GL_FRAMEBUFFER);
+    
+    m_opaqueColorAttachment->bindActive(GL_TEXTURE0);
+    m_accumulationAttachment->bindActive(GL_TEXTURE1);
+    m_revealageAttachment->bindActive(GL_TEXTURE2);
+    
+    m_resolveQuad->draw();
+    
+    const auto rect = std::array<GLint, 4>{{
+        m_viewportCapability->x(),
+        m_viewportCapability->y(),
+        m_viewportCapability->width(),
+        m_viewportCapability->height()
+    }};
+
+    m_fbo->blit(kOpaqueColorAttachment, rect, targetfbo, drawBuffer, rect, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
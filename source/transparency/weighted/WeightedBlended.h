@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+
+#include <glbinding/gl/types.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <gloperate/painter/Painter.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+    class Program;
+    class Texture;
+}
+
+namespace gloperate
+{
+    class AdaptiveGrid;
+    class ResourceManager;
+    class AbstractTargetFramebufferCapability;
+    class AbstractViewportCapability;
+    class AbstractPerspectiveProjectionCapability;
+    class AbstractCameraCapability;
+    class ScreenAlignedQuad;
+}
+
+class SceneDrawable;
+class SceneOptions;
+
+/**
+ *  @brief
+ *    Weighted blended order-independent transparency (McGuire and Bavoil, 2013)
+ *
+ *  @remarks
+ *    Transparent geometry is rendered once into an accumulation and a revealage target, which are
+ *    resolved over the opaque color in a single full-screen pass. Depth weights approximate the
+ *    visibility of each fragment, so results are not exact for overlapping surfaces of high opacity.
+ *    Requires separate blend functions per draw buffer, i.e., OpenGL 4.0 or GL_ARB_draw_buffers_blend.
+ */
+class WeightedBlended : public gloperate::Painter
+{
+public:
+    WeightedBlended(gloperate::ResourceManager & resourceManager);
+    virtual ~WeightedBlended();
+    
+public:
+    void setupPropertyGroup();
+    
+    unsigned char transparency() const;
+    void setTransparency(unsigned char transparency);
+    
+protected:
+    virtual void onInitialize() override;
+    virtual void onPaint() override;
+
+protected:
+    void setupFramebuffer();
+    void setupProjection();
+    void setupPrograms();
+    void setupDrawable();
+    void updateFramebuffer();
+    
+protected:
+    void clearBuffers();
+    void renderOpaqueGeometry();
+    void renderTransparentGeometry();
+    void resolve();
+
+protected:
+    /* capabilities */
+    gloperate::AbstractTargetFramebufferCapability * m_targetFramebufferCapability;
+    gloperate::AbstractViewportCapability * m_viewportCapability;
+    gloperate::AbstractPerspectiveProjectionCapability * m_projectionCapability;
+    gloperate::AbstractCameraCapability * m_cameraCapability;
+    bool m_multiDraw; ///< see SceneDrawable::multiDrawSupported(), selects the vertex shader
+    bool m_drawBuffersBlend; ///< blend functions per draw buffer, core since 4.0 or GL_ARB_draw_buffers_blend
+    bool m_drawBuffersBlendCore;
+
+    /* framebuffers and textures */
+    static const auto kOpaqueColorAttachment = gl::GL_COLOR_ATTACHMENT0;
+    static const auto kAccumulationAttachment = gl::GL_COLOR_ATTACHMENT1;
+    static const auto kRevealageAttachment = gl::GL_COLOR_ATTACHMENT2;
+    
+    globjects::ref_ptr<globjects::Framebuffer> m_fbo;
+    globjects::ref_ptr<globjects::Texture> m_opaqueColorAttachment;
+    globjects::ref_ptr<globjects::Texture> m_accumulationAttachment;
+    globjects::ref_ptr<globjects::Texture> m_revealageAttachment;
+    globjects::ref_ptr<globjects::Texture> m_depthAttachment;
+    
+    /* programs and geometry */
+    globjects::ref_ptr<globjects::Program> m_accumulationProgram;
+    globjects::ref_ptr<globjects::Program> m_resolveProgram;
+    
+    globjects::ref_ptr<gloperate::AdaptiveGrid> m_grid;
+    globjects::ref_ptr<gloperate::ScreenAlignedQuad> m_resolveQuad;
+    std::unique_ptr<SceneDrawable> m_scene;
+
+    /* properties */
+    unsigned char m_transparency;
+    std::unique_ptr<SceneOptions> m_sceneOptions;
+};